@@ -96,8 +96,15 @@ size_t packer_uwApplication::packMyHdr(Packet* p, unsigned char* buffer, size_t
         offset += put(buffer, offset, &(applh->rftt_valid_), n_bits[RFFTVALID_FIELD]);
         offset += put(buffer, offset, &(applh->priority_), n_bits[PRIORITY_FIELD]);
         offset += put(buffer, offset, &(applh->payload_size_), n_bits[PAYLOAD_SIZE_FIELD]);
-        int payload_size_bits = applh->payload_size()*8;
-        offset += put(buffer, offset, &(applh->payload_msg), payload_size_bits);
+        // the payload is in the data area the packet had above UW-AL
+        char* payload = hdr_DATA_APPLICATION::payload(hdr_uwal::upperData(p));
+        if (payload != NULL) {
+            int payload_size_bits = applh->payload_size()*8;
+            offset += put(buffer, offset, payload, payload_size_bits);
+        } else {
+            // no payload to send: the receiver gets zeros
+            offset += applh->payload_size()*8;
+        }
 
         if (debug_) {
             std::cout << "\033[1;37;45m (TX) UWAPPLICATION::DATA packer hdr \033[0m" << std::endl;
@@ -123,12 +130,16 @@ size_t packer_uwApplication::unpackMyHdr(unsigned char* buffer, size_t offset, P
         offset += get(buffer, offset, &(applh->rftt_valid_), n_bits[RFFTVALID_FIELD]);
         memset(&(applh->priority_), 0, sizeof (applh->priority_));
         offset += get(buffer, offset, &(applh->priority_), n_bits[PRIORITY_FIELD]);
-        memset(&(applh->payload_msg), 0, sizeof (applh->payload_size_));
+        memset(&(applh->payload_size_), 0, sizeof (applh->payload_size_));
         offset += get(buffer, offset, &(applh->payload_size_), n_bits[PAYLOAD_SIZE_FIELD]);
-        memset(&(applh->payload_msg), 0, sizeof (applh->payload_msg));
-        int payload_size_bit = applh->payload_size()*8;
-        //offset += get(buffer, offset, &(applh->payload_msg), n_bits[PAYLOADMSG_FIELD]);
-        offset += get(buffer, offset, &(applh->payload_msg), payload_size_bit);
+        // the payload goes in the data area given back to the packet above UW-AL
+        PacketData* payload = new PacketData(applh->payload_size());
+        hdr_uwal::setUpperData(p, payload);
+        if (applh->payload_size() > 0) {
+            memset(payload->data(), 0, applh->payload_size());
+            int payload_size_bit = applh->payload_size()*8;
+            offset += get(buffer, offset, payload->data(), payload_size_bit);
+        }
                 
         if (debug_) {
             std::cout << "\033[1;32;40m (RX) UWAPPLICATION::DATA packer hdr \033[0m" << std::endl;
@@ -163,10 +174,9 @@ void packer_uwApplication::printMyHdrFields(Packet* p) {
         std::cout << "\033[1;37;45m 4th field \033[0m, PRIORITY_FIELD: " << (int)applh->priority_ << std::endl;
         std::cout << "\033[1;37;45m 5th field \033[0m, PAYLOADMSG_SIZE_FIELD: " << applh->payload_size_ << std::endl;
         std::cout << "\033[1;37;45m 5th field \033[0m, PAYLOADMSG_FIELD: ";
-        for(int i=0;i<applh->payload_size();i++)
-        {
-            cout << applh->payload_msg[i];
-        }
+        char* payload = hdr_DATA_APPLICATION::payload(hdr_uwal::upperData(p));
+        if (payload != NULL)
+            std::cout.write(payload, applh->payload_size());
         std::cout << endl;
     }
 } //end printMyHdrFields() method
\ No newline at end of file
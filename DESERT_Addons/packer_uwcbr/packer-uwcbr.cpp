@@ -35,6 +35,19 @@
 
 #include "packer-uwcbr.h"
 
+/**
+ * Fields of the UWCBR header, in the order of n_bits.
+ */
+typedef PackerSchema<
+        PACKER_FIELD(hdr_uwcbr, sn_, 8 * sizeof (u_int32_t)),
+        PACKER_FIELD(hdr_uwcbr, rftt_, 0),
+        PACKER_FIELD(hdr_uwcbr, rftt_valid_, 0),
+        PACKER_FIELD(hdr_uwcbr, traffic_type_, 0)> UwcbrSchema;
+
+static const char* const uwcbr_field_names[UwcbrSchema::size()] = {
+    "sn", "rftt", "rftt_valid", "traffic_type"
+};
+
 /**
  * Class to create the Otcl shadow object for an object of the class packer.
  */
@@ -50,10 +63,10 @@ public:
 } class_module_packerUWCBR;
 
 packerUWCBR::packerUWCBR() : packer(false) {
-    SN_Bits = 8 * sizeof (u_int32_t);
-    RFTT_Bits = 0;
-    RFTT_VALID_Bits = 0;
-    TRAFFIC_TYPE_Bits = 0;
+    SN_Bits = UwcbrSchema::bits<0>();
+    RFTT_Bits = UwcbrSchema::bits<1>();
+    RFTT_VALID_Bits = UwcbrSchema::bits<2>();
+    TRAFFIC_TYPE_Bits = UwcbrSchema::bits<3>();
 
     bind("SN_Bits", (int*) &SN_Bits);
     bind("RFTT_Bits", (int*) &RFTT_Bits);
@@ -96,15 +109,7 @@ size_t packerUWCBR::packMyHdr(Packet* p, unsigned char* buf, size_t offset) {
     hdr_uwcbr* uch = HDR_UWCBR(p);
 
     if ( ch->ptype() == PT_UWCBR ) {
-        int field_idx = 0;
-
-        offset += put(buf, offset, &(uch->sn_), n_bits[field_idx++]);
-
-        offset += put(buf, offset, &(uch->rftt_), n_bits[field_idx++]);
-
-        offset += put(buf, offset, &(uch->rftt_valid_), n_bits[field_idx++]);
-
-        offset += put(buf, offset, &(uch->traffic_type_), n_bits[field_idx++]);
+        offset = UwcbrSchema::pack(*this, uch, buf, offset, &n_bits[0]);
 
         if (debug_) {
             printf("\033[0;46;30m TX CBR packer hdr \033[0m \n");
@@ -122,19 +127,7 @@ size_t packerUWCBR::unpackMyHdr(unsigned char* buf, size_t offset, Packet* p) {
     hdr_uwcbr* uch = HDR_UWCBR(p);
 
     if ( ch->ptype() == PT_UWCBR ) {
-        int field_idx = 0;
-
-        memset(&(uch->sn_), 0, sizeof (uch->sn_));
-        offset += get(buf, offset, &(uch->sn_), n_bits[field_idx++]);
-
-        memset(&(uch->rftt_), 0, sizeof (uch->rftt_));
-        offset += get(buf, offset, &(uch->rftt_), n_bits[field_idx++]);
-
-        memset(&(uch->rftt_valid_), 0, sizeof (uch->rftt_valid_));
-        offset += get(buf, offset, &(uch->rftt_valid_), n_bits[field_idx++]);
-
-        memset(&(uch->traffic_type_), 0, sizeof (uch->traffic_type_));
-        offset += get(buf, offset, &(uch->traffic_type_), n_bits[field_idx++]);
+        offset = UwcbrSchema::unpack(*this, buf, offset, uch, &n_bits[0]);
 
         if (debug_) {
             printf("\033[0;46;30m RX CBR packer hdr \033[0m \n");
@@ -147,18 +140,12 @@ size_t packerUWCBR::unpackMyHdr(unsigned char* buf, size_t offset, Packet* p) {
 
 void packerUWCBR::printMyHdrMap() {
     std::cout << "\033[0;46;30m Packer Name \033[0m: UWCBR \n";
-    std::cout << "\033[0;46;30m sn: \033[0m" << SN_Bits << " bits \n";
-    std::cout << "\033[0;46;30m rftt: \033[0m" << RFTT_Bits << " bits \n";
-    std::cout << "\033[0;46;30m rftt valid: \033[0m" << RFTT_VALID_Bits << " bits" << std::endl;
-    std::cout << "\033[0;46;30m traffic type: \033[0m" << TRAFFIC_TYPE_Bits << " bits" << std::endl;
+    UwcbrSchema::printMap(std::cout, uwcbr_field_names, &n_bits[0], "\033[0;46;30m");
 }
 
 
 void packerUWCBR::printMyHdrFields(Packet* p) {
     hdr_uwcbr* uch = HDR_UWCBR(p);
-    
-    if (n_bits[0] != 0) std::cout << "\033[0;46;30m sn: \033[0m" << uch->sn() << std::endl;
-    if (n_bits[1] != 0) std::cout << "\033[0;46;30m rftt: \033[0m" << uch->rftt() << std::endl;
-    if (n_bits[2] != 0) std::cout << "\033[0;46;30m rftt_valid: \033[0m" << uch->rftt_valid() << std::endl;
-    if (n_bits[3] != 0) std::cout << "\033[0;46;30m traffic_type: \033[0m" << uch->traffic_type() << std::endl;
+
+    UwcbrSchema::printFields(std::cout, uch, uwcbr_field_names, &n_bits[0], "\033[0;46;30m");
 }
@@ -39,6 +39,7 @@
 // #include "../../packer.h"
 
 #include "packer.h"
+#include "packer-schema.h"
 #include "uwcbr-module.h"
 
 /**
@@ -35,6 +35,16 @@
 
 #include "packer-uwflooding.h"
 
+/**
+ * Fields of the UWFLOODING header, in the order of n_bits.
+ */
+typedef PackerSchema<
+        PACKER_FIELD(hdr_uwflooding, ttl_, 8 * sizeof (uint8_t))> UwfloodingSchema;
+
+static const char* const uwflooding_field_names[UwfloodingSchema::size()] = {
+    "ttl"
+};
+
 /**
  * Class to create the Otcl shadow object for an object of the class packer.
  */
@@ -50,7 +60,7 @@ public:
 } class_module_PackerUwflooding;
 
 PackerUwFlooding::PackerUwFlooding() : packer(false) {
-    ttl_Bits = 8 * sizeof (uint8_t);
+    ttl_Bits = UwfloodingSchema::bits<0>();
 
     bind("ttl_Bits", (int*) &ttl_Bits);
 
@@ -81,9 +91,7 @@ size_t PackerUwFlooding::packMyHdr(Packet* p, unsigned char* buf, size_t offset)
     // Pointer to the UWFLOODING packet header
     hdr_uwflooding* hflooding = HDR_UWFLOODING(p);
 
-    int field_idx = 0;
-
-    offset += put(buf, offset, &(hflooding->ttl()), n_bits[field_idx++]);
+    offset = UwfloodingSchema::pack(*this, hflooding, buf, offset, &n_bits[0]);
 
     if (debug_) {
         printf("\033[1;37;46m TX UWFLOODING packer hdr \033[0m \n");
@@ -97,10 +105,7 @@ size_t PackerUwFlooding::unpackMyHdr(unsigned char* buf, size_t offset, Packet*
 
     hdr_uwflooding* hflooding = HDR_UWFLOODING(p);
 
-    int field_idx = 0;
-
-    memset(&(hflooding->ttl()), 0, sizeof (hflooding->ttl()));
-    offset += get(buf, offset, &(hflooding->ttl()), n_bits[field_idx++]);
+    offset = UwfloodingSchema::unpack(*this, buf, offset, hflooding, &n_bits[0]);
 
     if (debug_) {
         printf("\033[1;37;46m RX UWFLOODING packer hdr \033[0m \n");
@@ -112,14 +117,12 @@ size_t PackerUwFlooding::unpackMyHdr(unsigned char* buf, size_t offset, Packet*
 
 void PackerUwFlooding::printMyHdrMap() {
     std::cout << "\033[1;37;46m" << " Packer Name " << "\033[0m" << " UWFLOODING" << std::endl;
-    std::cout << "\033[1;37;46m 1st field " << "\033[0m" << " ttl: " << ttl_Bits << " bits" << std::endl;
+    UwfloodingSchema::printMap(std::cout, uwflooding_field_names, &n_bits[0], "\033[1;37;46m");
     return;
 }
 
 void PackerUwFlooding::printMyHdrFields(Packet* p) {
     hdr_uwflooding* hflooding = HDR_UWFLOODING(p);
-    
-    if (n_bits[0] != 0) {
-        std::cout << "\033[1;37;46m ttl:\033[0m " << static_cast<uint32_t>(hflooding->ttl()) << " " << hex_bytes(hflooding->ttl(), n_bits[0]) << std::endl;
-    }
+
+    UwfloodingSchema::printFields(std::cout, hflooding, uwflooding_field_names, &n_bits[0], "\033[1;37;46m");
 }
@@ -35,6 +35,17 @@
 
 #include "packer-uwip.h"
 
+/**
+ * Fields of the UWIP header, in the order of n_bits.
+ */
+typedef PackerSchema<
+        PACKER_FIELD(hdr_uwip, saddr_, 8 * sizeof (uint8_t)),
+        PACKER_FIELD(hdr_uwip, daddr_, 8 * sizeof (uint8_t))> UwipSchema;
+
+static const char* const uwip_field_names[UwipSchema::size()] = {
+    "saddr", "daddr"
+};
+
 /**
  * Class to create the Otcl shadow object for an object of the class packer.
  */
@@ -51,8 +62,8 @@ public:
 
 //packerUWIP::packerUWIP() : packer(false), isRacunBroadcast(0) {
 packerUWIP::packerUWIP() : packer(false) {
-    SAddr_Bits = 8 * sizeof (uint8_t);
-    DAddr_Bits = 8 * sizeof (uint8_t);
+    SAddr_Bits = UwipSchema::bits<0>();
+    DAddr_Bits = UwipSchema::bits<1>();
 
     bind("SAddr_Bits", (int*) &SAddr_Bits);
     bind("DAddr_Bits", (int*) &DAddr_Bits);
@@ -83,14 +94,10 @@ void packerUWIP::init() {
 }
 
 size_t packerUWIP::packMyHdr(Packet* p, unsigned char* buf, size_t offset) {
-
     // Pointer to the UWIP packet header
     hdr_uwip* hip = HDR_UWIP(p);
 
-    int field_idx = 0;
-
-    offset += put(buf, offset, &(hip->saddr_), n_bits[field_idx++]);
-    offset += put(buf, offset, &(hip->daddr_), n_bits[field_idx++]);
+    offset = UwipSchema::pack(*this, hip, buf, offset, &n_bits[0]);
 
     if (debug_) {
         printf("\033[0;42;30m TX IP packer hdr \033[0m \n");
@@ -101,17 +108,10 @@ size_t packerUWIP::packMyHdr(Packet* p, unsigned char* buf, size_t offset) {
 }
 
 size_t packerUWIP::unpackMyHdr(unsigned char* buf, size_t offset, Packet* p) {
-
     // Pointer to the UWIP packet header
     hdr_uwip* hip = HDR_UWIP(p);
 
-    int field_idx = 0;
-
-    memset(&(hip->saddr()), 0, sizeof ( hip->saddr_));
-    offset += get(buf, offset, &(hip->saddr_), n_bits[field_idx++]);
-
-    memset(&(hip->daddr()), 0, sizeof ( hip->daddr_));
-    offset += get(buf, offset, &(hip->daddr_), n_bits[field_idx++]);
+    offset = UwipSchema::unpack(*this, buf, offset, hip, &n_bits[0]);
 
 //    if (isRacunBroadcast && (hip->daddr_ == RACUN_BROADCAST)){
 //        hip->daddr_ = UWIP_BROADCAST;
@@ -127,18 +127,12 @@ size_t packerUWIP::unpackMyHdr(unsigned char* buf, size_t offset, Packet* p) {
 
 void packerUWIP::printMyHdrMap() {
     std::cout << "\033[0;42;30m" << " Packer Name " << "\033[0m" << " UWIP" << std::endl;
-    std::cout << "\033[0;42;30m 1st field " << "\033[0m" << " saddr: " << SAddr_Bits << " bits" << std::endl;
-    std::cout << "\033[0;42;30m 2nd field " << "\033[0m" << " daddr: " << DAddr_Bits << " bits" << std::endl;
+    UwipSchema::printMap(std::cout, uwip_field_names, &n_bits[0], "\033[0;42;30m");
     return;
 }
 
 void packerUWIP::printMyHdrFields(Packet* p) {
     hdr_uwip* hip = HDR_UWIP(p);
-    
-    if (n_bits[0] != 0) {
-        std::cout << "\033[0;42;30m saddr:\033[0m " << static_cast<uint32_t> (hip->saddr()) << " " << hex_bytes(hip->saddr(), n_bits[0]) << std::endl;
-    }
-    if (n_bits[1] != 0) {
-        std::cout << "\033[0;42;30m daddr:\033[0m " << static_cast<uint32_t> (hip->daddr()) << " " << hex_bytes(hip->daddr(), n_bits[1]) << std::endl;
-    }
+
+    UwipSchema::printFields(std::cout, hip, uwip_field_names, &n_bits[0], "\033[0;42;30m");
 }
@@ -39,6 +39,7 @@
 // #include "../../packer.h"
 
 #include "packer.h"
+#include "packer-schema.h"
 #include "uwip-module.h"
 
 //static const int RACUN_BROADCAST = 63;
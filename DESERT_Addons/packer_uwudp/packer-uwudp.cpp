@@ -35,6 +35,17 @@
 
 #include "packer-uwudp.h"
 
+/**
+ * Fields of the UWUDP header, in the order of n_bits.
+ */
+typedef PackerSchema<
+        PACKER_FIELD(hdr_uwudp, sport_, 8 * sizeof (u_int16_t)),
+        PACKER_FIELD(hdr_uwudp, dport_, 8 * sizeof (u_int16_t))> UwudpSchema;
+
+static const char* const uwudp_field_names[UwudpSchema::size()] = {
+    "sport", "dport"
+};
+
 /**
  * Class to create the Otcl shadow object for an object of the class packer.
  */
@@ -50,8 +61,8 @@ public:
 } class_module_packerUWUDP;
 
 packerUWUDP::packerUWUDP() : packer(false) {
-    SPort_Bits = 8 * sizeof (u_int16_t);
-    DPort_Bits = 8 * sizeof (u_int16_t);
+    SPort_Bits = UwudpSchema::bits<0>();
+    DPort_Bits = UwudpSchema::bits<1>();
 
     bind("SPort_Bits", (int*) &SPort_Bits);
     bind("DPort_Bits", (int*) &DPort_Bits);
@@ -85,10 +96,7 @@ size_t packerUWUDP::packMyHdr(Packet* p, unsigned char* buf, size_t offset) {
     // Pointer to the UWUDP packet header
     hdr_uwudp* hudp = HDR_UWUDP(p);
 
-    int field_idx = 0;
-
-    offset += put(buf, offset, &(hudp->sport_), n_bits[field_idx++]);
-    offset += put(buf, offset, &(hudp->dport_), n_bits[field_idx++]);
+    offset = UwudpSchema::pack(*this, hudp, buf, offset, &n_bits[0]);
 
     if (debug_) {
         printf("\033[1;37;44m TX UDP packer hdr \033[0m \n");
@@ -103,13 +111,7 @@ size_t packerUWUDP::unpackMyHdr(unsigned char* buf, size_t offset, Packet* p) {
     // Pointer to the UWUDP packet header
     hdr_uwudp* hudp = HDR_UWUDP(p);
 
-    int field_idx = 0;
-
-    memset(&(hudp->sport()), 0, sizeof ( hudp->sport_));
-    offset += get(buf, offset, &(hudp->sport_), n_bits[field_idx++]);
-
-    memset(&(hudp->dport()), 0, sizeof ( hudp->dport_));
-    offset += get(buf, offset, &(hudp->dport_), n_bits[field_idx++]);
+    offset = UwudpSchema::unpack(*this, buf, offset, hudp, &n_bits[0]);
 
     if (debug_) {
         printf("\033[1;37;44m RX UDP packer hdr \033[0m \n");
@@ -121,18 +123,11 @@ size_t packerUWUDP::unpackMyHdr(unsigned char* buf, size_t offset, Packet* p) {
 
 void packerUWUDP::printMyHdrMap() {
     std::cout << "\033[1;37;44m" << " Packer Name " << "\033[0m" << " UWUDP" << std::endl;
-    std::cout << "\033[1;37;44m 1st field " << "\033[0m" << " sport: " << SPort_Bits << " bits" << std::endl;
-    std::cout << "\033[1;37;44m 2nd field " << "\033[0m" << " dport: " << DPort_Bits << " bits" << std::endl;
+    UwudpSchema::printMap(std::cout, uwudp_field_names, &n_bits[0], "\033[1;37;44m");
 }
 
 void packerUWUDP::printMyHdrFields(Packet* p) {
     hdr_uwudp* hudp = HDR_UWUDP(p);
-    
-    if (n_bits[0] != 0) {
-        std::cout << "\033[1;37;44m sport:\033[0m " << static_cast<uint32_t> (hudp->sport()) << " " << hex_bytes(hudp->sport(), n_bits[0]) << std::endl;
-    }
-    if (n_bits[1] != 0) {
-        std::cout << "\033[1;37;44m dport:\033[0m " << static_cast<uint32_t> (hudp->dport()) << " " << hex_bytes(hudp->dport(), n_bits[1]) << std::endl;
-    }
-}
 
+    UwudpSchema::printFields(std::cout, hudp, uwudp_field_names, &n_bits[0], "\033[1;37;44m");
+}
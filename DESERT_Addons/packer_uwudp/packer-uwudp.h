@@ -37,6 +37,7 @@
 #define PACKER_UWUDP_H
 
 #include "packer.h"
+#include "packer-schema.h"
 
 #include <uwudp-module.h>
 
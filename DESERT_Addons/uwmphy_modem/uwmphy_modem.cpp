@@ -145,7 +145,8 @@ UWMPhy_modem::recv(Packet *p)
 		hdr_mac *mach = HDR_MAC(modemTxBuff[0]);
 		hdr_uwal *uwalh = HDR_UWAL(modemTxBuff[0]);
 		std::string payload_string;
-		payload_string.assign(uwalh->binPkt(), uwalh->binPktLength());
+		payload_string.assign(
+				hdr_uwal::binPkt(modemTxBuff[0]), uwalh->binPktLength());
 		pmDriver->updateTx(mach->macDA(), payload_string);
 		startTx(modemTxBuff[0]);
 		if (pmDriver->getStatus() != MODEM_TX) {
@@ -234,8 +235,7 @@ UWMPhy_modem::endRx(Packet *p)
 	Packet *p_rx = Packet::alloc();
 	hdr_uwal *uwalh = HDR_UWAL(p_rx);
 	uwalh->binPktLength() = str.length();
-	memset(uwalh->binPkt(), 0, sizeof(uwalh->binPkt()));
-	memcpy(uwalh->binPkt(), buf, uwalh->binPktLength());
+	memcpy(hdr_uwal::writableBinPkt(p_rx), buf, uwalh->binPktLength());
 	this->updatePktRx(p_rx);
 	pmDriver->printOnLog(
 			LOG_LEVEL_DEBUG, "UWMPHY_MODEM", "CHECK_MODEM::END_RX");
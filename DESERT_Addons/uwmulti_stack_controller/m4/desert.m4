@@ -48,7 +48,8 @@ AC_DEFUN([AC_ARG_WITH_DESERT],[
                 fi
 
                 for dir in         \
-                    data_link/uwaloha
+                    data_link/uwaloha \
+                    physical/uwphy_clmsgs
                 do
                     echo "considering dir \"$dir\""
                     DESERT_CPPFLAGS="$DESERT_CPPFLAGS -I${DESERT_PATH}/${dir}"
@@ -56,7 +57,8 @@ AC_DEFUN([AC_ARG_WITH_DESERT],[
                 done
 
                 for lib in \
-		    uwaloha
+		    uwaloha \
+		    uwphy_clmsgs
                 do
                     DESERT_LIBADD="$DESERT_LIBADD -l${lib}"
                 done
@@ -92,7 +94,8 @@ AC_DEFUN([AC_ARG_WITH_DESERT_BUILD],[
                     fi
 
                     for dir in         \
-                  	data_link/uwaloha
+                  	data_link/uwaloha \
+                  	physical/uwphy_clmsgs
                     do
                         echo "considering dir \"$dir\""
                         DESERT_LDFLAGS_BUILD="$DESERT_LDFLAGS_BUILD -L${DESERT_PATH_BUILD}/${dir}"
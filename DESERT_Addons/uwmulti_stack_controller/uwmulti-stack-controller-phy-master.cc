@@ -175,10 +175,7 @@ void  UwMultiStackControllerPhyMaster::resetCheckAndSignal() //due to timer expi
 
 int UwMultiStackControllerPhyMaster::checkBestLayer()
 {
-  int mac_addr = -1;
-  ClMsgPhy2MacAddr msg;
-  sendSyncClMsg(&msg);
-  mac_addr = msg.getAddr();
+  int mac_addr = getMacAddr();
 
   int id_short_range = getShorterRangeLayer(last_layer_used_);
   int id_long_range = getLongerRangeLayer(last_layer_used_);
@@ -212,10 +209,7 @@ void UwMultiStackControllerPhyMaster::signalsBestPhy()
 {
   assert(signaling_active_);
   //Retreive my mac to set macSA
-  int my_mac_addr = -1;
-  ClMsgPhy2MacAddr msg;
-  sendSyncClMsg(&msg);
-  my_mac_addr = msg.getAddr(); 
+  int my_mac_addr = getMacAddr();
 
   Packet *p = Packet::alloc();
   hdr_cmn* ch = hdr_cmn::access(p);
@@ -253,10 +247,7 @@ int UwMultiStackControllerPhyMaster::recvSyncClMsg(ClMessage* m) {
 
 void UwMultiStackControllerPhyMaster::updateMasterStatistics(Packet *p, int idSrc)
 {
-  int mac_addr = -1;
-  ClMsgPhy2MacAddr msg;
-  sendSyncClMsg(&msg);
-  mac_addr = msg.getAddr();
+  int mac_addr = getMacAddr();
 
   hdr_mac* mach = HDR_MAC(p);
   hdr_MPhy* ph = HDR_MPHY(p);
@@ -106,10 +106,7 @@ void UwMultiStackControllerPhySlave::recv(Packet *p, int idSrc)
     //Filippo: signaling con risposta
     if (signaling_active_) {
       hdr_mac* mach = HDR_MAC(p);
-      int my_mac_addr = -1;
-      ClMsgPhy2MacAddr msg;
-      sendSyncClMsg(&msg);
-      my_mac_addr = msg.getAddr(); 
+      int my_mac_addr = getMacAddr();
       if (mach->macDA() == my_mac_addr || mach->macDA() == MAC_BROADCAST) {
         mach->macDA() = mach->macSA();
         mach->macSA() = my_mac_addr;
@@ -147,10 +144,7 @@ int UwMultiStackControllerPhySlave::recvSyncClMsg(ClMessage* m) {
 int UwMultiStackControllerPhySlave::getBestLayer(Packet *p) { 
   assert(switch_mode_ == UW_AUTOMATIC_SWITCH);
 
-  int mac_addr = -1;
-  ClMsgPhy2MacAddr msg;
-  sendSyncClMsg(&msg);
-  mac_addr = msg.getAddr();
+  int mac_addr = getMacAddr();
 
   if (debug_)
   {
@@ -163,17 +157,14 @@ int UwMultiStackControllerPhySlave::getBestLayer(Packet *p) {
 
 void UwMultiStackControllerPhySlave::updateSlave(Packet *p, int idSrc)
 {
-  int mac_addr = -1;
+  int mac_addr = getMacAddr();
   hdr_mac* mach = HDR_MAC(p);
-  ClMsgPhy2MacAddr msg;
-  sendSyncClMsg(&msg);
-  mac_addr = msg.getAddr();
   if (mach->macDA() == mac_addr || mach->macDA() == MAC_BROADCAST)
   {
     if (debug_)
     {
       std::cout << NOW << " ControllerPhySlave("<< mac_addr <<")::updateSlave " 
-                << msg.getAddr() << ": " << slave_lower_layer_ << " --> " << idSrc << std::endl;
+                << mac_addr << ": " << slave_lower_layer_ << " --> " << idSrc << std::endl;
     }
     slave_lower_layer_ = idSrc;
   }
@@ -61,7 +61,9 @@ UwMultiStackControllerPhy::UwMultiStackControllerPhy()
 : 
 UwMultiStackController(),
 receiving_id(0),
-current_state(UWPHY_CONTROLLER_STATE_IDLE)
+current_state(UWPHY_CONTROLLER_STATE_IDLE),
+mac_addr_(-1),
+mac_addr_valid_(false)
 {
   initInfo(); 
 }
@@ -82,6 +84,11 @@ int UwMultiStackControllerPhy::command(int argc, const char*const* argv)
     {
       tcl.resultf("%d", (int)(current_state));
       return TCL_OK;
+    }
+    else if(strcasecmp(argv[1], "refreshMacAddr") == 0)
+    {
+      mac_addr_valid_ = false;
+      return TCL_OK;
     }
 	}
 	
@@ -90,10 +97,13 @@ int UwMultiStackControllerPhy::command(int argc, const char*const* argv)
 
 int UwMultiStackControllerPhy::recvSyncClMsg(ClMessage* m) 
 {
-  int mac_addr = -1;
-  ClMsgPhy2MacAddr msg;
-  sendSyncClMsg(&msg);
-  mac_addr = msg.getAddr();
+  if (m->type() == CLMSG_UWPHY_MAC_ADDR)
+  {
+    mac_addr_ = ((ClMsgUwPhyMacAddr *) m)->getAddr();
+    mac_addr_valid_ = (mac_addr_ >= 0);
+    return 0;
+  }
+  int mac_addr = getMacAddr();
   if (debug_)
   {
     std::cout << NOW << " ControllerPhy("<< mac_addr <<")::recvSyncClMsg(ClMessage* m), state_info: " 
@@ -149,10 +159,7 @@ int UwMultiStackControllerPhy::recvSyncClMsg(ClMessage* m)
 
 void UwMultiStackControllerPhy::stateIdle() 
 {
-  int mac_addr = -1;
-  ClMsgPhy2MacAddr msg;
-  sendSyncClMsg(&msg);
-  mac_addr = msg.getAddr();
+  int mac_addr = getMacAddr();
   if (debug_)
   {
     std::cout << NOW << " ControllerPhy("<< mac_addr <<")::stateIdle(), state_info: " << state_info[current_state] 
@@ -164,10 +171,7 @@ void UwMultiStackControllerPhy::stateIdle()
 
 void UwMultiStackControllerPhy::stateBusy2Rx(int id) 
 {
-  int mac_addr = -1;
-  ClMsgPhy2MacAddr msg;
-  sendSyncClMsg(&msg);
-  mac_addr = msg.getAddr();
+  int mac_addr = getMacAddr();
   if (debug_)
   {
     std::cout << NOW << " ControllerPhy("<< mac_addr <<")::stateBusy2Rx(id), state_info: " 
@@ -179,10 +183,7 @@ void UwMultiStackControllerPhy::stateBusy2Rx(int id)
 
 void UwMultiStackControllerPhy::stateBusy2Tx(Packet *p) 
 {
-  int mac_addr = -1;
-  ClMsgPhy2MacAddr msg;
-  sendSyncClMsg(&msg);
-  mac_addr = msg.getAddr();
+  int mac_addr = getMacAddr();
   if (debug_)
   {
     std::cout << NOW << " ControllerPhy("<< mac_addr <<")::stateBusy2Tx(), state_info: " 
@@ -195,10 +196,7 @@ void UwMultiStackControllerPhy::stateBusy2Tx(Packet *p)
 
 void UwMultiStackControllerPhy::recv(Packet *p, int idSrc) 
 {
-  int mac_addr = -1;
-  ClMsgPhy2MacAddr msg;
-  sendSyncClMsg(&msg);
-  mac_addr = msg.getAddr();
+  int mac_addr = getMacAddr();
   hdr_cmn *ch = HDR_CMN(p);
   if (ch->direction() == hdr_cmn::DOWN && current_state == UWPHY_CONTROLLER_STATE_IDLE) 
   {
@@ -40,6 +40,7 @@
 
 #include "uwmulti-stack-controller.h"
 #include "phymac-clmsg.h"
+#include "uwphy-clmsg.h"
 
 #include <map>
 #include <string>
@@ -106,6 +107,9 @@ protected:
   };
   
   UWPHY_CONTROLLER_STATE current_state;
+
+  int mac_addr_; /**< Cached MAC address of the node. */
+  bool mac_addr_valid_; /**< True if mac_addr_ holds the MAC address. */
   
   static map< UWPHY_CONTROLLER_STATE , string > state_info;
 
@@ -114,6 +118,25 @@ protected:
   */
   virtual void initInfo();
 
+  /**
+   * Returns the MAC address of the node. It is asked to the MAC layer with a 
+   * ClMsgPhy2MacAddr until a valid one is returned, then the cached value is 
+   * returned until a ClMsgUwPhyMacAddr notifies a new address or the 
+   * <i>refreshMacAddr</i> command invalidates it.
+   *
+   * @return the MAC address of the node
+   */
+  inline int getMacAddr()
+  {
+    if (!mac_addr_valid_) {
+      ClMsgPhy2MacAddr msg;
+      sendSyncClMsg(&msg);
+      mac_addr_ = msg.getAddr();
+      mac_addr_valid_ = (mac_addr_ >= 0);
+    }
+    return mac_addr_;
+  }
+
   /**
   * Node is in Idle state. It changes its state only when it has to manage 
   * a packet reception.
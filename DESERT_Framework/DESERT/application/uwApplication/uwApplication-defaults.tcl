@@ -42,6 +42,8 @@ Module/UW/APPLICATION set PoissonTraffic_ 		1
 Module/UW/APPLICATION set Payload_size_			10
 Module/UW/APPLICATION set drop_out_of_order_ 	1
 Module/UW/APPLICATION set Socket_Port_ 			4000	
+Module/UW/APPLICATION set TCP_framing_ 			0
+Module/UW/APPLICATION set UDP_batch_size_ 		0
 Module/UW/APPLICATION set node_ID_ 				1
 Module/UW/APPLICATION set EXP_ID_ 				1
 
@@ -37,14 +37,29 @@
  *
  */
 
+#include <algorithm>
 #include <sstream>
 #include <time.h>
 #include "uwApplication_cmn_header.h"
 #include "uwApplication_module.h"
 #include <error.h>
 #include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 
-pthread_mutex_t mutex_tcp = PTHREAD_MUTEX_INITIALIZER;
+/**
+ * Set the events polled for the socket of a TCP client: its data, and its
+ * room for the data queued for it when writable is true.
+ */
+static void
+pollTCPclient(int epoll_fd, int fd, bool writable)
+{
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN | EPOLLRDHUP | (writable ? EPOLLOUT : 0);
+	ev.data.fd = fd;
+	epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev);
+}
 
 int
 uwApplicationModule::openConnectionTCP()
@@ -99,7 +114,7 @@ uwApplicationModule::openConnectionTCP()
 	}
 
 	// Listen for incoming connections
-	if (listen(servSockDescr, 1)) {
+	if (listen(servSockDescr, SOMAXCONN)) {
 		if (debug_ >= 0)
 			std::cout << getEpoch() << "::" << NOW
 					  << "::UWAPPLICATION::OPEN_CONNECTION_TCP::LISTEN_FAILED"
@@ -115,9 +130,35 @@ uwApplicationModule::openConnectionTCP()
 				  << "::UWAPPLICATION::OPEN_CONNECTION_TCP::SERVER_READY"
 				  << endl;
 
+	// Poll the server socket and the stop eventfd, the clients are added
+	// once accepted
+	fcntl(servSockDescr, F_SETFL, fcntl(servSockDescr, F_GETFL) | O_NONBLOCK);
+	wakeDescr = eventfd(0, EFD_CLOEXEC);
+	epollDescr = epoll_create1(EPOLL_CLOEXEC);
+	bool epoll_ok = (wakeDescr >= 0 && epollDescr >= 0);
+	int polled[] = {servSockDescr, wakeDescr};
+	for (int i = 0; epoll_ok && i < 2; i++) {
+		struct epoll_event ev;
+		memset(&ev, 0, sizeof(ev));
+		ev.events = EPOLLIN;
+		ev.data.fd = polled[i];
+		epoll_ok = (epoll_ctl(epollDescr, EPOLL_CTL_ADD, polled[i], &ev) == 0);
+	}
+	if (!epoll_ok) {
+		if (debug_ >= 0)
+			std::cout << getEpoch() << "::" << NOW
+					  << "::UWAPPLICATION::OPEN_CONNECTION_TCP::EPOLL_FAILED_"
+					  << strerror(errno) << endl;
+		if (logging)
+			out_log << left << getEpoch() << "::" << NOW
+					<< "::UWAPPLICATION::OPEN_CONNECTION_TCP::EPOLL_FAILED_"
+					<< strerror(errno) << endl;
+		exit(1);
+	}
+
 	chkTimerPeriod.resched(getPeriod());
-	pthread_t pth;
-	if (pthread_create(&pth, NULL, read_process_TCP, (void *) this) != 0) {
+	if (pthread_create(&tcp_thread, NULL, read_process_TCP, (void *) this) !=
+			0) {
 		if (debug_ >= 0)
 			std::cout << getEpoch() << "::" << NOW
 					  << "::UWAPPLICATION::OPEN_CONNECTION_TCP::CANNOT_CREATE_"
@@ -131,6 +172,7 @@ uwApplicationModule::openConnectionTCP()
 					<< endl;
 		exit(1);
 	}
+	tcp_thread_active = true;
 
 	return servSockDescr;
 } // end openConnectionTCP() method
@@ -139,103 +181,270 @@ void *
 read_process_TCP(void *arg)
 {
 	uwApplicationModule *obj = (uwApplicationModule *) arg;
-	int debug_ = 1;
-	// struct sockaddr_in clnAddr;
-
-	socklen_t clnLen = sizeof(sockaddr_in);
-	// int clnSockDescr;
+	obj->serveTCPclients();
+	return NULL;
+} // end read_process_TCP() method
 
-	clnLen = sizeof(obj->clnAddr);
+void
+uwApplicationModule::serveTCPclients()
+{
+	struct epoll_event events[TCP_MAX_EVENTS];
+	std::vector<char> batch;
 
 	while (true) {
-		if ((obj->clnSockDescr = accept(obj->servSockDescr,
-					 (struct sockaddr *) &(obj->clnAddr),
-					 (socklen_t *) &clnLen)) < 0) {
+		int n_ev = epoll_wait(epollDescr, events, TCP_MAX_EVENTS, -1);
+		if (n_ev < 0) {
+			if (errno == EINTR)
+				continue;
 			if (debug_ >= 0)
-			    std::cout << obj->getEpoch() << "::" << NOW
-						  << "::UWAPPLICATION::READ_PROCESS_TCP::CONNECTION_"
-							 "NOT_ACCEPTED"
-						  << endl;
+				std::cout << getEpoch() << "::" << NOW
+						  << "::UWAPPLICATION::READ_PROCESS_TCP::EPOLL_WAIT_"
+							 "FAILED_"
+						  << strerror(errno) << endl;
+			return;
 		}
-		if (debug_ >= 1)
-			std::cout << obj->getEpoch() << "::" << NOW
-					  << "::UWAPPLICATION::READ_PROCESS_TCP::NEW_CLIENT_IP_"
-					  << inet_ntoa(obj->clnAddr.sin_addr) << std::endl;
-		if (obj->logging)
-			obj->out_log << left << obj->getEpoch() << "::" << NOW
-						 << "::UWAPPLICATION::READ_PROCESS_TCP::NEW_CLIENT_IP_"
-						 << inet_ntoa(obj->clnAddr.sin_addr) << std::endl;
-		obj->handleTCPclient(obj->clnSockDescr);
+
+		for (int i = 0; i < n_ev; i++) {
+			int fd = events[i].data.fd;
+			if (fd == wakeDescr) {
+				return;
+			} else if (fd == servSockDescr) {
+				acceptTCPclient();
+			} else {
+				if (events[i].events & EPOLLOUT)
+					flushTCPclient(fd);
+				if (events[i].events & ~EPOLLOUT)
+					readTCPclient(fd, batch);
+			}
+		}
+
+		// Hand all the messages of this round to the simulator at once
+		publishMessages(batch);
 	}
+} // end serveTCPclients() method
 
-} // end read_process_TCP() method
+void
+uwApplicationModule::acceptTCPclient()
+{
+	TcpClient cln;
+	socklen_t clnLen = sizeof(cln.addr);
+	int fd = accept4(servSockDescr,
+			(struct sockaddr *) &(cln.addr),
+			&clnLen,
+			SOCK_CLOEXEC | SOCK_NONBLOCK);
+	if (fd < 0) {
+		if (errno != EAGAIN && errno != EWOULDBLOCK && debug_ >= 0)
+			std::cout << getEpoch() << "::" << NOW
+					  << "::UWAPPLICATION::READ_PROCESS_TCP::CONNECTION_"
+						 "NOT_ACCEPTED"
+					  << endl;
+		return;
+	}
+
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN | EPOLLRDHUP;
+	ev.data.fd = fd;
+	if (epoll_ctl(epollDescr, EPOLL_CTL_ADD, fd, &ev) < 0) {
+		if (debug_ >= 0)
+			std::cout << getEpoch() << "::" << NOW
+					  << "::UWAPPLICATION::READ_PROCESS_TCP::EPOLL_ADD_"
+						 "FAILED_"
+					  << strerror(errno) << endl;
+		close(fd);
+		return;
+	}
+
+	cln.rx_buf.resize(
+			std::max<size_t>(MAX_READ_LEN, TCP_PREFIX_LEN + MAX_LENGTH_PAYLOAD));
+	cln.rx_len = 0;
+	cln.tx_failed = false;
+	if (debug_ >= 1)
+		std::cout << getEpoch() << "::" << NOW
+				  << "::UWAPPLICATION::READ_PROCESS_TCP::NEW_CLIENT_IP_"
+				  << inet_ntoa(cln.addr.sin_addr) << std::endl;
+	if (logging)
+		out_log << left << getEpoch() << "::" << NOW
+				<< "::UWAPPLICATION::READ_PROCESS_TCP::NEW_CLIENT_IP_"
+				<< inet_ntoa(cln.addr.sin_addr) << std::endl;
+
+	std::lock_guard<std::mutex> lock(tcp_clients_m);
+	tcp_clients[fd] = std::move(cln);
+} // end acceptTCPclient() method
 
 void
-uwApplicationModule::handleTCPclient(int clnSock)
+uwApplicationModule::readTCPclient(int fd, std::vector<char> &batch)
 {
-	while (true) {
-		int recvMsgSize = 0;
-		char buffer_msg[MAX_LENGTH_PAYLOAD];
-		Packet *p = Packet::alloc();
-		hdr_DATA_APPLICATION *hdr_Appl = HDR_DATA_APPLICATION(p);
-		for (int i = 0; i < MAX_LENGTH_PAYLOAD; i++) {
-			buffer_msg[i] = 0;
+	std::map<int, TcpClient>::iterator it = tcp_clients.find(fd);
+	if (it == tcp_clients.end())
+		return;
+	TcpClient &cln = it->second;
+
+	// Without framing, each read is a message, as long as MAX_READ_LEN
+	size_t max_len = tcp_framing
+			? cln.rx_buf.size() - cln.rx_len
+			: std::min<size_t>(MAX_READ_LEN, MAX_LENGTH_PAYLOAD);
+	ssize_t recvMsgSize = ::recv(fd, &cln.rx_buf[cln.rx_len], max_len, 0);
+	if (recvMsgSize < 0 &&
+			(errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+		return;
+	if (recvMsgSize <= 0) { // client disconnected
+		if (debug_ >= 1)
+			std::cout << getEpoch() << "::" << NOW
+					  << "::UWAPPLICATION::READ_PROCESS_TCP::CLIENT_"
+						 "DISCONNECTED_IP_"
+					  << inet_ntoa(cln.addr.sin_addr) << std::endl;
+		closeTCPclient(fd);
+		return;
+	}
+
+	if (!tcp_framing) {
+		appendMessage(batch, &cln.rx_buf[0], recvMsgSize);
+		return;
+	}
+
+	// Split the complete messages, the last one may be still incomplete
+	cln.rx_len += recvMsgSize;
+	size_t off = 0;
+	while (cln.rx_len - off >= TCP_PREFIX_LEN) {
+		uint16_t len;
+		memcpy(&len, &cln.rx_buf[off], TCP_PREFIX_LEN);
+		len = ntohs(len);
+		if (len == 0 || len > MAX_LENGTH_PAYLOAD) {
+			if (debug_ >= 0)
+				std::cout << getEpoch() << "::" << NOW
+						  << "::UWAPPLICATION::READ_PROCESS_TCP::INVALID_"
+							 "MESSAGE_LENGTH_"
+						  << len << std::endl;
+			closeTCPclient(fd);
+			return;
 		}
-		if ((recvMsgSize = read(clnSock, buffer_msg, MAX_READ_LEN)) < 0) {
+		if (cln.rx_len - off < TCP_PREFIX_LEN + len)
+			break;
+		appendMessage(batch, &cln.rx_buf[off + TCP_PREFIX_LEN], len);
+		off += TCP_PREFIX_LEN + len;
+	}
+	if (off > 0) {
+		memmove(&cln.rx_buf[0], &cln.rx_buf[off], cln.rx_len - off);
+		cln.rx_len -= off;
+	}
+} // end readTCPclient() method
+
+void
+uwApplicationModule::closeTCPclient(int fd)
+{
+	if (epollDescr >= 0)
+		epoll_ctl(epollDescr, EPOLL_CTL_DEL, fd, NULL);
+	std::lock_guard<std::mutex> lock(tcp_clients_m);
+	tcp_clients.erase(fd);
+	shutdown(fd, SHUT_RDWR);
+	close(fd);
+} // end closeTCPclient() method
+
+void
+uwApplicationModule::flushTCPclient(int fd)
+{
+	std::lock_guard<std::mutex> lock(tcp_clients_m);
+	std::map<int, TcpClient>::iterator it = tcp_clients.find(fd);
+	if (it == tcp_clients.end())
+		return;
+	TcpClient &cln = it->second;
+
+	size_t sent = 0;
+	while (sent < cln.tx_buf.size()) {
+		ssize_t w = ::send(
+				fd, &cln.tx_buf[sent], cln.tx_buf.size() - sent, MSG_NOSIGNAL);
+		if (w < 0 && errno == EINTR)
+			continue;
+		if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		if (w <= 0) {
 			if (debug_ >= 0)
 				std::cout << getEpoch() << "::" << NOW
-						  << "::UWAPPLICATION::READ_PROCESS_TCP::HANDLE_TCP_"
-							 "CLIENT::"
-							 "CONNECTION_NOT_ACCEPTED"
-						  << endl;
+						  << "::UWAPPLICATION::FLUSH_TCP_CLIENT::SEND_FAILED_"
+						  << strerror(errno) << endl;
+			// The read of the hung up socket closes the client
+			shutdown(fd, SHUT_RDWR);
+			cln.tx_failed = true;
+			sent = cln.tx_buf.size();
 			break;
 		}
-		if (recvMsgSize == 0) { // client disconnected
-			shutdown(clnSock, 2);
-			break;
-		} else {
-			int status = pthread_mutex_lock(&mutex_tcp);
-			if (status != 0) {
+		sent += w;
+	}
+	cln.tx_buf.erase(cln.tx_buf.begin(), cln.tx_buf.begin() + sent);
+	if (cln.tx_buf.empty())
+		pollTCPclient(epollDescr, fd, false);
+} // end flushTCPclient() method
+
+void
+uwApplicationModule::sendTCPclients(const char *msg, size_t len)
+{
+	std::vector<char> frame;
+	if (tcp_framing) {
+		uint16_t prefix = htons(len);
+		frame.insert(frame.end(),
+				(char *) &prefix,
+				(char *) &prefix + TCP_PREFIX_LEN);
+	}
+	frame.insert(frame.end(), msg, msg + len);
+
+	std::lock_guard<std::mutex> lock(tcp_clients_m);
+	for (std::map<int, TcpClient>::iterator it = tcp_clients.begin();
+			it != tcp_clients.end();
+			++it) {
+		TcpClient &cln = it->second;
+		if (cln.tx_failed)
+			continue;
+
+		// Write now only behind the data already queued, if any
+		size_t sent = 0;
+		while (cln.tx_buf.empty() && sent < frame.size()) {
+			ssize_t w = ::send(it->first,
+					&frame[sent],
+					frame.size() - sent,
+					MSG_NOSIGNAL);
+			if (w < 0 && errno == EINTR)
+				continue;
+			if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+				break;
+			if (w <= 0) {
 				if (debug_ >= 0)
 					std::cout << getEpoch() << "::" << NOW
-							  << "::UWAPPLICATION::PTHREAD_MUTEX_LOCK_FAILED "
-							  << endl;
-			}
-			if (debug_ >= 0) {
-				std::cout << getEpoch() << "::" << NOW
-						  << "::UWAPPLICATION::READ_PROCESS_TCP::PAYLOAD_"
-							 "MESSAGE--> ";
-				for (int i = 0; i < recvMsgSize; i++) {
-					cout << buffer_msg[i];
-				}
+							  << "::UWAPPLICATION::SEND_TCP_CLIENTS::SEND_"
+								 "FAILED_"
+							  << strerror(errno) << endl;
+				cln.tx_failed = true;
+				break;
 			}
-			if (logging)
-				out_log << left << getEpoch() << "::" << NOW
-						<< "::UWAPPLICATION::READ_PROCESS_UDP::NEW_PACKET_"
-						   "CREATED"
-						<< endl;
-			for (int i = 0; i < recvMsgSize; i++) {
-				hdr_Appl->payload_msg[i] = buffer_msg[i];
-			}
-			hdr_cmn *ch = HDR_CMN(p);
-			ch->size() = recvMsgSize;
-			hdr_Appl->payload_size() = recvMsgSize;
-			queuePckReadTCP.push(p);
-			incrPktsPushQueue();
-			status = pthread_mutex_unlock(&mutex_tcp);
-			if (status != 0) {
+			sent += w;
+		}
+		if (!cln.tx_failed && sent < frame.size()) {
+			if (cln.tx_buf.size() + frame.size() - sent > TCP_MAX_TX_BUF) {
 				if (debug_ >= 0)
 					std::cout << getEpoch() << "::" << NOW
-							  << "::UWAPPLICATION::PTHREAD_MUTEX_UNLOCK_FAILED "
-							  << endl;
+							  << "::UWAPPLICATION::SEND_TCP_CLIENTS::TX_"
+								 "BUFFER_FULL_IP_"
+							  << inet_ntoa(cln.addr.sin_addr) << endl;
+				cln.tx_failed = true;
+			} else {
+				if (cln.tx_buf.empty())
+					pollTCPclient(epollDescr, it->first, true);
+				cln.tx_buf.insert(
+						cln.tx_buf.end(), frame.begin() + sent, frame.end());
 			}
 		}
+		if (cln.tx_failed) {
+			// tcp_thread closes the client once it reads the hung up socket
+			shutdown(it->first, SHUT_RDWR);
+			cln.tx_buf.clear();
+		}
 	}
-}
+} // end sendTCPclients() method
 
 void
 uwApplicationModule::init_Packet_TCP()
 {
+	collectMessages(queuePckReadTCP);
 	if (queuePckReadTCP.empty()) {
 	} else {
 		Packet *ptmp = queuePckReadTCP.front();
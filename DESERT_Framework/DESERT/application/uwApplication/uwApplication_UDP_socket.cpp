@@ -43,8 +43,7 @@
 #include "uwApplication_module.h"
 #include <error.h>
 #include <errno.h>
-
-pthread_mutex_t mutex_udp = PTHREAD_MUTEX_INITIALIZER;
+#include <sys/uio.h>
 
 int
 uwApplicationModule::openConnectionUDP()
@@ -110,96 +109,96 @@ uwApplicationModule::openConnectionUDP()
 void *
 read_process_UDP(void *arg)
 {
-	int debug_ = 1;
-	char buffer_msg[MAX_LENGTH_PAYLOAD]; // Buffer in which the DATA packets
-	// payload are stored
-	int recvMsgSize; // Size of the DATA payload received;
 	uwApplicationModule *obj = (uwApplicationModule *) arg;
+	obj->serveUDPclients();
+	return NULL;
+} // end read_process_UDP() method
 
-	socklen_t clnLen = sizeof(sockaddr_in);
+void
+uwApplicationModule::serveUDPclients()
+{
+	std::vector<char> batch;
+	size_t n_slots = udp_batch > 0 ? udp_batch : 1;
+
+	// Slab where the datagrams of a batch are received, one per slot
+	std::vector<char> slab(n_slots * MAX_LENGTH_PAYLOAD);
+	std::vector<struct mmsghdr> msgs(n_slots);
+	std::vector<struct iovec> iovs(n_slots);
+	std::vector<struct sockaddr_in> addrs(n_slots);
+	for (size_t i = 0; i < n_slots; i++) {
+		iovs[i].iov_base = &slab[i * MAX_LENGTH_PAYLOAD];
+		iovs[i].iov_len = MAX_LENGTH_PAYLOAD;
+		memset(&msgs[i], 0, sizeof(msgs[i]));
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+	}
 
 	while (true) {
-		clnLen = sizeof(obj->clnAddr);
-		// Put the message to 0
-		for (int i = 0; i < MAX_LENGTH_PAYLOAD; i++) {
-			buffer_msg[i] = 0;
+		int n_msgs;
+		if (udp_batch > 0) {
+			for (size_t i = 0; i < n_slots; i++) {
+				msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+			}
+			// Block until the first datagram, then take the ones already
+			// queued in the socket
+			n_msgs = recvmmsg(
+					servSockDescr, &msgs[0], n_slots, MSG_WAITFORONE, NULL);
+		} else {
+			socklen_t clnLen = sizeof(addrs[0]);
+			int recvMsgSize = recvfrom(servSockDescr,
+					&slab[0],
+					MAX_LENGTH_PAYLOAD,
+					0,
+					(struct sockaddr *) &addrs[0],
+					&clnLen);
+			msgs[0].msg_len = recvMsgSize;
+			n_msgs = recvMsgSize < 0 ? -1 : 1;
 		}
-		// Block until receive message from a client
-		if ((recvMsgSize = recvfrom(obj->servSockDescr,
-					 buffer_msg,
-					 MAX_LENGTH_PAYLOAD,
-					 0,
-					 (struct sockaddr *) &(obj->clnAddr),
-					 &clnLen)) < 0) {
+
+		if (n_msgs < 0) {
+			if (errno == EINTR)
+				continue;
 			if (debug_ >= 0)
-				std::cout << "[" << obj->getEpoch() << "]::" << NOW
+				std::cout << "[" << getEpoch() << "]::" << NOW
 						  << "::UWAPPLICATION::READ_PROCESS_UDP::CONNECTION_"
 							 "NOT_ACCEPTED"
 						  << endl;
-			if (obj->logging)
-				obj->out_log << left << "[" << obj->getEpoch() << "]::" << NOW
-							 << "::UWAPPLICATION::READ_PROCESS_UDP::CONNECTION_"
-								"NOT_ACCEPTED"
-							 << endl;
-		}
-		if (debug_ >= 1)
-			std::cout << "[" << obj->getEpoch() << "]::" << NOW
-					  << "::UWAPPLICATION::READ_PROCESS_TCP::NEW_CLIENT_IP_"
-					  << inet_ntoa(obj->clnAddr.sin_addr) << std::endl;
-		if (obj->logging)
-			obj->out_log << left << "[" << obj->getEpoch() << "]::" << NOW
-						 << "::UWAPPLICATION::READ_PROCESS_UDP::NEW_CLIENT_IP_"
-						 << inet_ntoa(obj->clnAddr.sin_addr) << std::endl;
-		int status = pthread_mutex_lock(&mutex_udp);
-		if (status != 0) {
-			if (debug_ >= 0)
-				std::cout << "[" << obj->getEpoch() << "]::" << NOW
-						  << "::UWAPPLICATION::PTHREAD_MUTEX_LOCK_FAILED "
-						  << endl;
+			if (logging)
+				out_log << left << "[" << getEpoch() << "]::" << NOW
+						<< "::UWAPPLICATION::READ_PROCESS_UDP::CONNECTION_"
+						   "NOT_ACCEPTED"
+						<< endl;
+			if (errno == EBADF)
+				return;
+			continue;
 		}
-		if (recvMsgSize > 0) {
-			Packet *p = Packet::alloc();
-			hdr_cmn *ch = HDR_CMN(p);
-			hdr_DATA_APPLICATION *hdr_Appl = HDR_DATA_APPLICATION(p);
-			hdr_Appl->payload_size() = recvMsgSize;
-			ch->size() = recvMsgSize;
-			if (debug_ >= 0) {
-				std::cout << "[" << obj->getEpoch() << "]::" << NOW
-						  << "::UWAPPLICATION::READ_PROCESS_UDP::NEW_PACKET_"
-							 "CREATED--> "
-						  << endl;
-				if (obj->logging)
-					obj->out_log << left << "[" << obj->getEpoch()
-								 << "]::" << NOW
-								 << "::UWAPPLICATION::READ_PROCESS_UDP::NEW_"
-									"PACKET_CREATED"
-								 << endl;
-				std::cout << "[" << obj->getEpoch() << "]::" << NOW
-						  << "::UWAPPLICATION::READ_PROCESS_UDP::PAYLOAD_"
-							 "MESSAGE--> ";
-				for (int i = 0; i < recvMsgSize; i++) {
-					hdr_Appl->payload_msg[i] = buffer_msg[i];
-					cout << buffer_msg[i];
-				}
-			}
-			obj->queuePckReadUDP.push(p);
-			obj->incrPktsPushQueue();
-		}
-		status = pthread_mutex_unlock(&mutex_udp);
-		if (status != 0) {
-			if (debug_ >= 0)
-				std::cout << "[" << obj->getEpoch() << "]::" << NOW
-						  << "::UWAPPLICATION::PTHREAD_MUTEX_UNLOCK_FAILED "
-						  << endl;
+
+		for (int i = 0; i < n_msgs; i++) {
+			if (msgs[i].msg_len > 0)
+				appendMessage(batch,
+						(const char *) iovs[i].iov_base,
+						msgs[i].msg_len);
 		}
-	}
+		clnAddr = addrs[n_msgs - 1];
+		if (debug_ >= 1)
+			std::cout << "[" << getEpoch() << "]::" << NOW
+					  << "::UWAPPLICATION::READ_PROCESS_UDP::NEW_CLIENT_IP_"
+					  << inet_ntoa(clnAddr.sin_addr) << "_DATAGRAMS_"
+					  << n_msgs << std::endl;
 
-} // end read_process_UDP() method
+		publishMessages(batch);
+	}
+} // end serveUDPclients() method
 
 void
 uwApplicationModule::init_Packet_UDP()
 {
-	if (!queuePckReadUDP.empty()) {
+	collectMessages(queuePckReadUDP);
+
+	// In batch mode, all the packets ready are sent down in this period
+	size_t n_send = udp_batch > 0 ? queuePckReadUDP.size() : 1;
+	for (size_t i = 0; i < n_send && !queuePckReadUDP.empty(); i++) {
 		Packet *ptmp = queuePckReadUDP.front();
 		queuePckReadUDP.pop();
 		hdr_cmn *ch = HDR_CMN(ptmp);
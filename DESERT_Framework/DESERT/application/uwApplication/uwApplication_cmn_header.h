@@ -43,7 +43,8 @@
 #include <packet.h>
 #include <pthread.h>
 
-#define MAX_LENGTH_PAYLOAD 4096
+#define MAX_LENGTH_PAYLOAD \
+	4096 /**< Longest message read from the sockets, in bytes */
 #define HDR_DATA_APPLICATION(p)    \
 	(hdr_DATA_APPLICATION::access( \
 			p)) /**< alias defined to access the TRIGGER HEADER */
@@ -61,8 +62,8 @@ typedef struct hdr_DATA_APPLICATION {
 	bool rftt_valid_; /**< Flag used to set the validity of the fft field. */
 	uint8_t priority_; /**< Priority flag: 1 means high priority, 0 normal
 						  priority. */
-	uint16_t payload_size_; /**< Size (bytes) of the payload */
-	char payload_msg[MAX_LENGTH_PAYLOAD]; /**< Message payload*/
+	uint16_t payload_size_; /**< Size (bytes) of the payload, that is kept
+							   in the data area of the packet */
 
 	static int offset_; /**< Required by the PacketHeaderManager. */
 
@@ -116,6 +117,41 @@ typedef struct hdr_DATA_APPLICATION {
 		return payload_size_;
 	}
 
+	/**
+	 * Returns the payload held by a data area, NULL if the data area is not
+	 * a PacketData.
+	 */
+	inline static char *
+	payload(AppData *d)
+	{
+		PacketData *pd = dynamic_cast<PacketData *>(d);
+		return pd ? (char *) pd->data() : NULL;
+	}
+
+	/**
+	 * Returns the payload of the packet, NULL if it has none.
+	 */
+	inline static char *
+	payload(Packet *p)
+	{
+		return payload(p->userdata());
+	}
+
+	/**
+	 * Gives the packet a payload of the given size, replacing its data area,
+	 * and sets payload_size_ accordingly.
+	 *
+	 * @return the payload, to be filled by the caller
+	 */
+	inline static char *
+	allocPayload(Packet *p, uint16_t size)
+	{
+		PacketData *pd = new PacketData(size);
+		p->setdata(pd);
+		access(p)->payload_size_ = size;
+		return (char *) pd->data();
+	}
+
 	/**
 	 * Reference to the offset variable
 	 */
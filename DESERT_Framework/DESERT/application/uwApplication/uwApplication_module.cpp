@@ -69,7 +69,6 @@ public:
 
 uwApplicationModule::uwApplicationModule()
 	: servSockDescr(0)
-	, clnSockDescr(0)
 	, servAddr()
 	, clnAddr()
 	, servPort(0)
@@ -110,6 +109,17 @@ uwApplicationModule::uwApplicationModule()
 	, sumbytes(0)
 	, sumdt(0)
 	, hrsn(0)
+	, tcp_framing(0)
+	, epollDescr(-1)
+	, wakeDescr(-1)
+	, tcp_thread()
+	, tcp_thread_active(false)
+	, tcp_clients()
+	, tcp_clients_m()
+	, udp_batch(0)
+	, rx_pending()
+	, rx_taken()
+	, rx_m()
 {
 	bind("debug_", (int *) &debug_);
 	bind("period_", (double *) &PERIOD);
@@ -122,6 +132,8 @@ uwApplicationModule::uwApplicationModule()
 	bind("Socket_Port_", (int *) &servPort);
 	bind("drop_out_of_order_", (int *) &drop_out_of_order);
 	bind("max_read_length", (uint *) &uwApplicationModule::MAX_READ_LEN);
+	bind("TCP_framing_", (int *) &tcp_framing);
+	bind("UDP_batch_size_", (int *) &udp_batch);
 
 	sn_check = new bool[USHRT_MAX];
 	for (int i = 0; i < USHRT_MAX; i++) {
@@ -366,12 +378,12 @@ uwApplicationModule::statistics(Packet *p)
 
 	lrtime = Scheduler::instance().clock(); // Update the time in which the last
 											// packet is received.
+	const char *payload = hdr_DATA_APPLICATION::payload(p);
+	int payload_len = payload ? uwApph->payload_size() : 0;
 	if (debug_ >= 0 && socket_active) {
 		std::cout << "[" << getEpoch() << "]::" << NOW
 				  << "::UWAPPLICATION::PAYLOAD_RECEIVED--> ";
-		for (int i = 0; i < uwApph->payload_size(); i++) {
-			cout << uwApph->payload_msg[i];
-		}
+		std::cout.write(payload, payload_len);
 	}
 	if (debug_ >= 0)
 		std::cout << "[" << getEpoch() << "]::" << NOW
@@ -381,10 +393,12 @@ uwApplicationModule::statistics(Packet *p)
 		std::cout << "[" << getEpoch() << "]::" << NOW
 				  << "::UWAPPLICATION::PAYLOAD_SIZE_RECEIVED_"
 				  << (int) uwApph->payload_size() << endl;
-	if (debug_ >= 1 && !withoutSocket())
+	if (debug_ >= 1 && !withoutSocket()) {
 		std::cout << "[" << getEpoch() << "]::" << NOW
-				  << "::UWAPPLICATION::PAYLOAD_RECEIVED_" << uwApph->payload_msg
-				  << endl;
+				  << "::UWAPPLICATION::PAYLOAD_RECEIVED_";
+		std::cout.write(payload, payload_len);
+		std::cout << endl;
+	}
 
 	if (logging)
 		out_log << left << "[" << getEpoch() << "]::" << NOW
@@ -397,13 +411,11 @@ uwApplicationModule::statistics(Packet *p)
 	if (logging && !withoutSocket()) {
 		out_log << left << "::" << NOW
 				<< "::UWAPPLICATION::PAYLOAD_RECEIVED--> ";
-		for (int i = 0; i < uwApph->payload_size(); i++) {
-			out_log << uwApph->payload_msg[i];
-		}
+		out_log.write(payload, payload_len);
 		out_log << std::endl;
 	}
-	if (clnSockDescr) {
-		write(clnSockDescr, uwApph->payload_msg, (size_t)uwApph->payload_size());
+	if (socket_active && useTCP()) {
+		sendTCPclients(payload, payload_len);
 	}
 	Packet::free(p);
 } // end statistics method
@@ -437,7 +449,6 @@ uwApplicationModule::init_Packet()
 	ch->ptype_ = PT_DATA_APPLICATION; // Assign the type of packet that is being
 									  // created
 	ch->size() = payloadsize; // Assign the size of data payload
-	uwApph->payload_size() = payloadsize;
 	ch->direction() = hdr_cmn::DOWN; // The packet must be forward at the level
 									 // above of him
 
@@ -460,17 +471,9 @@ uwApplicationModule::init_Packet()
 	uwApph->priority_ = 0; // Priority of the message
 
 	// Create the payload message
-	if (getpayloadsize() < MAX_LENGTH_PAYLOAD) {
-		for (int i = 0; i < getpayloadsize(); i++) {
-			(*uwApph).payload_msg[i] = RNG::defaultrng()->uniform(26) + 'a';
-		}
-		for (int i = getpayloadsize(); i < MAX_LENGTH_PAYLOAD; i++) {
-			(*uwApph).payload_msg[i] = '0';
-		}
-	} else {
-		for (int i = 0; i < MAX_LENGTH_PAYLOAD; i++) {
-			(*uwApph).payload_msg[i] = RNG::defaultrng()->uniform(26) + 'a';
-		}
+	char *payload = hdr_DATA_APPLICATION::allocPayload(p, payloadsize);
+	for (int i = 0; i < payloadsize; i++) {
+		payload[i] = RNG::defaultrng()->uniform(26) + 'a';
 	}
 
 	// Show the DATA payload generated
@@ -528,11 +531,91 @@ uwApplicationModule::stop()
 		// Close the connection
 		if (useTCP()) {
 			chkTimerPeriod.force_cancel();
+			if (tcp_thread_active) {
+				uint64_t one = 1;
+				if (write(wakeDescr, &one, sizeof(one)) < 0 && debug_ >= 0)
+					std::cout << "[" << getEpoch() << "]::" << NOW
+							  << "::UWAPPLICATION::STOP::WAKE_FAILED" << endl;
+				pthread_join(tcp_thread, NULL);
+				tcp_thread_active = false;
+			}
+			while (!tcp_clients.empty()) {
+				closeTCPclient(tcp_clients.begin()->first);
+			}
+			if (epollDescr >= 0) {
+				close(epollDescr);
+				epollDescr = -1;
+			}
+			if (wakeDescr >= 0) {
+				close(wakeDescr);
+				wakeDescr = -1;
+			}
 			close(servSockDescr);
 		}
 	}
 } // end stop() method
 
+void
+uwApplicationModule::appendMessage(
+		std::vector<char> &batch, const char *msg, uint16_t len)
+{
+	batch.insert(batch.end(), (char *) &len, (char *) &len + sizeof(len));
+	batch.insert(batch.end(), msg, msg + len);
+} // end appendMessage() method
+
+void
+uwApplicationModule::publishMessages(std::vector<char> &batch)
+{
+	if (batch.empty())
+		return;
+	std::lock_guard<std::mutex> lock(rx_m);
+	if (rx_pending.empty()) {
+		rx_pending.swap(batch);
+	} else {
+		rx_pending.insert(rx_pending.end(), batch.begin(), batch.end());
+		batch.clear();
+	}
+} // end publishMessages() method
+
+void
+uwApplicationModule::collectMessages(std::queue<Packet *> &queue)
+{
+	{
+		std::lock_guard<std::mutex> lock(rx_m);
+		rx_taken.swap(rx_pending);
+	}
+
+	size_t off = 0;
+	while (off + sizeof(uint16_t) <= rx_taken.size()) {
+		uint16_t len;
+		memcpy(&len, &rx_taken[off], sizeof(len));
+		off += sizeof(len);
+
+		Packet *p = Packet::alloc();
+		char *payload = hdr_DATA_APPLICATION::allocPayload(p, len);
+		memcpy(payload, &rx_taken[off], len);
+		off += len;
+		hdr_cmn *ch = HDR_CMN(p);
+		ch->size() = len;
+
+		if (debug_ >= 0) {
+			std::cout << "[" << getEpoch() << "]::" << NOW
+					  << "::UWAPPLICATION::COLLECT_MESSAGES::PAYLOAD_"
+						 "MESSAGE--> ";
+			std::cout.write(payload, len);
+			std::cout << endl;
+		}
+		if (logging)
+			out_log << left << "[" << getEpoch() << "]::" << NOW
+					<< "::UWAPPLICATION::COLLECT_MESSAGES::NEW_PACKET_"
+					   "CREATED"
+					<< endl;
+		queue.push(p);
+		incrPktsPushQueue();
+	}
+	rx_taken.clear();
+} // end collectMessages() method
+
 double
 uwApplicationModule::getTimeBeforeNextPkt()
 {
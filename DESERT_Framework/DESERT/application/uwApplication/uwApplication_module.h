@@ -76,6 +76,9 @@
 #include <fstream>
 #include <ostream>
 #include <chrono>
+#include <map>
+#include <mutex>
+#include <vector>
 
 #define UWAPPLICATION_DROP_REASON_UNKNOWN_TYPE \
 	"DPUT" /**< Drop the packet. Packet received is an unknown type*/
@@ -122,14 +125,20 @@ public:
 	virtual int crLayCommand(ClMessage *m);
 
 	/**
-	 * Handle the communication between server and client
-	 *
-	 * @param clnSock socket obtained after the accept function and use for the
-	 *                communication between server and client
+	 * Serve the TCP clients until stop() is called: accept the new clients,
+	 * read the data of the connected ones and hand the complete messages
+	 * to the simulator thread. Executed by the reading thread, it never
+	 * touches the ns-2 state.
 	 */
-	virtual void handleTCPclient(int clnSock);
+	virtual void serveTCPclients();
 
-	// virtual void handleUDPclient(int clnSock);
+	/**
+	 * Read the datagrams received by the UDP server and hand them to the
+	 * simulator thread, one by one or, if udp_batch is set, in batches of
+	 * up to udp_batch datagrams read with a single recvmmsg(). Executed by
+	 * the reading thread, it never touches the ns-2 state.
+	 */
+	virtual void serveUDPclients();
 
 	/**
  * Increase the number of DATA packets stored in the Server queue. This DATA
@@ -155,7 +164,6 @@ public:
 	}
 
 	int servSockDescr; /**< socket descriptor for server */
-	int clnSockDescr; /**< *socket descriptor for client */
 	struct sockaddr_in servAddr; /**< Server address */
 	struct sockaddr_in clnAddr; /**< Client address */
 	int servPort; /**< Server port*/
@@ -176,6 +184,13 @@ public:
 	/** Maximum size (bytes) of a single read of the socket */
 	static uint MAX_READ_LEN;
 
+	/** Size (bytes) of the length prefix of a TCP message */
+	static const size_t TCP_PREFIX_LEN = 2;
+	/** Maximum number of epoll events handled at once */
+	static const int TCP_MAX_EVENTS = 32;
+	/** Maximum size (bytes) of the data queued for a slow TCP client */
+	static const size_t TCP_MAX_TX_BUF = 65536;
+
 protected:
 	/**< uwSenderTimer class that manage the timer */
 	class uwSendTimerAppl : public TimerHandler
@@ -239,6 +254,41 @@ protected:
 	 */
 	// virtual void initialize_DATA_pck_wth_TCP();
 	virtual void init_Packet_TCP();
+	/**
+	 * Accept a new TCP client and add it to the clients served.
+	 */
+	virtual void acceptTCPclient();
+	/**
+	 * Read the data available from a TCP client, and append its complete
+	 * messages to a batch.
+	 *
+	 * @param fd socket descriptor of the client
+	 * @param batch messages read, each one preceded by its uint16_t length
+	 */
+	virtual void readTCPclient(int fd, std::vector<char> &batch);
+	/**
+	 * Stop serving a TCP client and close its socket.
+	 *
+	 * @param fd socket descriptor of the client
+	 */
+	virtual void closeTCPclient(int fd);
+	/**
+	 * Write to a TCP client the data queued for it, once its socket is
+	 * writable again.
+	 *
+	 * @param fd socket descriptor of the client
+	 */
+	virtual void flushTCPclient(int fd);
+	/**
+	 * Send a received payload to all the TCP clients, framed like the
+	 * messages they send. The sockets are never waited for: what a client
+	 * cannot take at once is queued and written by tcp_thread, and a
+	 * client whose queue exceeds TCP_MAX_TX_BUF is disconnected.
+	 *
+	 * @param msg payload to send
+	 * @param len size of the payload
+	 */
+	virtual void sendTCPclients(const char *msg, size_t len);
 	/**
 	 * When socket communication is used, this method establish a connection
 	 * between client and server. This is required because a UDP protocol is
@@ -253,6 +303,29 @@ protected:
 	 */
 	// virtual void initialize_DATA_pck_wth_UDP();
 	virtual void init_Packet_UDP();
+	/**
+	 * Append a message to a batch of messages, preceded by its length.
+	 *
+	 * @param batch batch of messages
+	 * @param msg message to append
+	 * @param len size of the message
+	 */
+	static void appendMessage(
+			std::vector<char> &batch, const char *msg, uint16_t len);
+	/**
+	 * Hand a batch of messages read by a socket thread to the simulator
+	 * thread, in a single step, and empty it.
+	 *
+	 * @param batch batch of messages, built with appendMessage()
+	 */
+	virtual void publishMessages(std::vector<char> &batch);
+	/**
+	 * Take the messages published by the socket thread and create a DATA
+	 * packet for each of them. Executed by the simulator thread.
+	 *
+	 * @param queue queue where the packets are stored
+	 */
+	virtual void collectMessages(std::queue<Packet *> &queue);
 	/**
 	 * Close the socket connection in the case the communication take place with
 	 * socket, otherwise stop the execution of the process, so force the
@@ -577,6 +650,44 @@ protected:
 	double sumdt; /**< Sum of the delays. */
 	int hrsn; /**< Highest received sequence number. */
 
+	// TCP SERVER VARIABLES
+	/**
+	 * Buffers of a TCP client: hold the bytes of the message being
+	 * received and the bytes not yet written to its socket.
+	 */
+	struct TcpClient {
+		std::vector<char> rx_buf; /**< Buffer of the data received */
+		size_t rx_len; /**< Bytes of rx_buf holding data */
+		std::vector<char> tx_buf; /**< Data waiting to be sent */
+		bool tx_failed; /**< Set once the client is being disconnected */
+		struct sockaddr_in addr; /**< Address of the client */
+	};
+	int tcp_framing; /**< <i>1</i> each TCP message is preceded by its
+						length, as a 16 bits integer in network byte order,
+						<i>0</i> (default, raw clients) each read of the
+						socket is a message */
+	int epollDescr; /**< epoll descriptor of the TCP server */
+	int wakeDescr; /**< eventfd used by stop() to stop the reading thread */
+	pthread_t tcp_thread; /**< Thread serving the TCP clients */
+	bool tcp_thread_active; /**< Flag set while tcp_thread is running */
+	std::map<int, TcpClient> tcp_clients; /**< Clients, by socket */
+	std::mutex tcp_clients_m; /**< Guards the insertion and removal of the
+								 clients, their tx_buf and the writes to
+								 their sockets */
+
+	// UDP SERVER VARIABLES
+	int udp_batch; /**< If greater than <i>0</i>, maximum number of
+					  datagrams read at once, all the packets ready being sent
+					  down at each period. <i>0</i> one datagram per read and
+					  one packet per period */
+
+	// SOCKET VARIABLES
+	std::vector<char> rx_pending; /**< Messages read and not yet taken by
+									 the simulator thread */
+	std::vector<char> rx_taken; /**< Messages taken by the simulator
+								   thread */
+	std::mutex rx_m; /**< Guards rx_pending */
+
 }; // end uwApplication_module class
 #endif /* UWAPPLICATION_MODULE_H */
 extern "C" {
@@ -32,3 +32,6 @@
 
 Module/UW/Optical/Channel set RefractiveIndex_ 1.33
 
+Module/UW/Optical/Channel set MaxRange_ 0
+Module/UW/Optical/Channel set MaxSpeed_ 0
+Module/UW/Optical/Channel set GridRefresh_ 1
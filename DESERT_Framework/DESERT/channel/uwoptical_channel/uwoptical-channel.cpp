@@ -38,6 +38,7 @@
 
 #include <iostream>
 #include <cassert>
+#include <algorithm>
 
 #include "uwoptical-channel.h"
 
@@ -66,8 +67,18 @@ UwOpticalChannel::UwOpticalChannel()
 	: ChannelModule()
 	, refractive_index(REFRACTIVE_INDEX_WATER)
 	, speed_of_light(SPEED_OF_LIGHT_VACUUM)
+	, max_range_(0)
+	, max_speed_(0)
+	, grid_refresh_(1)
+	, grid_time_(0)
+	, grid_nsaps_(-1)
+	, grid_()
+	, candidates_()
 {
 	bind("RefractiveIndex_", (double *) &refractive_index);
+	bind("MaxRange_", (double *) &max_range_);
+	bind("MaxSpeed_", (double *) &max_speed_);
+	bind("GridRefresh_", (double *) &grid_refresh_);
 
 	if (refractive_index < REFRACTIVE_INDEX_MIN) {
 		refractive_index = REFRACTIVE_INDEX_MIN;
@@ -80,6 +91,12 @@ int
 UwOpticalChannel::command(int argc, const char *const *argv)
 {
 	// Tcl& tcl = Tcl::instance();
+	if (argc == 2) {
+		if (strcasecmp(argv[1], "refreshGrid") == 0) {
+			grid_nsaps_ = -1;
+			return TCL_OK;
+		}
+	}
 	return ChannelModule::command(argc, argv);
 }
 
@@ -97,19 +114,97 @@ UwOpticalChannel::sendUpPhy(Packet *p, ChSAP *chsap)
 	if (debug_)
 		cout << "UwOpticalChannel::sendUpPhy() sending packet" << endl;
 
-	for (int i = 0; i < getChSAPnum(); i++) {
-		dest = (ChSAP *) getChSAP(i);
+	if (max_range_ <= 0) {
+		for (int i = 0; i < getChSAPnum(); i++) {
+			dest = (ChSAP *) getChSAP(i);
+
+			if (chsap == dest) // it's the source node -> skip it
+				continue;
+
+			s.schedule(dest,
+					p->copy(),
+					getPropDelay(sourcePos, dest->getPosition()));
+		}
+
+		Packet::free(p);
+		return;
+	}
+
+	if (grid_nsaps_ != getChSAPnum() || NOW - grid_time_ > grid_refresh_ ||
+			max_speed_ * (NOW - grid_time_) > max_range_)
+		refreshGrid();
+
+	getCandidates(sourcePos);
+
+	for (size_t i = 0; i < candidates_.size(); i++) {
+		dest = (ChSAP *) getChSAP(candidates_[i]);
 
 		if (chsap == dest) // it's the source node -> skip it
 			continue;
 
+		// the grid may be stale: check the current distance
+		if (sourcePos->getDist(dest->getPosition()) > max_range_)
+			continue;
+
 		s.schedule(
 				dest, p->copy(), getPropDelay(sourcePos, dest->getPosition()));
 	}
 
+	if (debug_)
+		cout << "UwOpticalChannel::sendUpPhy() " << candidates_.size()
+			 << " candidate receivers out of " << getChSAPnum() << endl;
+
 	Packet::free(p);
 }
 
+void
+UwOpticalChannel::refreshGrid()
+{
+	grid_nsaps_ = getChSAPnum();
+	grid_time_ = NOW;
+
+	// keep the cells allocated, unless the nodes moved over many of them
+	if (grid_.size() > 4 * (size_t) grid_nsaps_)
+		grid_.clear();
+	else
+		for (auto &cell : grid_)
+			cell.second.clear();
+
+	for (int i = 0; i < grid_nsaps_; i++) {
+		Position *pos = ((ChSAP *) getChSAP(i))->getPosition();
+		int64_t key = getCellKey(getCellIndex(pos->getX()),
+				getCellIndex(pos->getY()),
+				getCellIndex(pos->getZ()));
+		grid_[key].push_back(i);
+	}
+}
+
+void
+UwOpticalChannel::getCandidates(Position *src)
+{
+	candidates_.clear();
+
+	// a node may have moved by max_speed_ * age since the last refresh
+	double radius = max_range_ + max_speed_ * (NOW - grid_time_);
+	int64_t r = (int64_t) ceil(radius / max_range_);
+	int64_t ix = getCellIndex(src->getX());
+	int64_t iy = getCellIndex(src->getY());
+	int64_t iz = getCellIndex(src->getZ());
+
+	for (int64_t x = ix - r; x <= ix + r; x++)
+		for (int64_t y = iy - r; y <= iy + r; y++)
+			for (int64_t z = iz - r; z <= iz + r; z++) {
+				auto cell = grid_.find(getCellKey(x, y, z));
+				if (cell != grid_.end())
+					candidates_.insert(candidates_.end(),
+							cell->second.begin(),
+							cell->second.end());
+			}
+
+	// deliver in ChSAP order, as without the grid
+	std::sort(candidates_.begin(), candidates_.end());
+}
+
 void
 UwOpticalChannel::recv(Packet *p, ChSAP *chsap)
 {
@@ -43,6 +43,11 @@
 #include <stdlib.h>
 #include <tclcl.h>
 
+#include <math.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
 /**
  * UwOpticalChannel extends Miracle channel class and implements the underwater
  * optical channel
@@ -101,8 +106,53 @@ protected:
 	*/
 	void sendUpPhy(Packet *p, ChSAP *chsap);
 
+	/**
+	* Rebuilds the spatial grid with the current position of every ChSAP.
+	*/
+	void refreshGrid();
+
+	/**
+	* Fills candidates_ with the index of every ChSAP that may be within
+	* max_range_ of the given position, sorted in ascending order.
+	*
+	* @param Position* src position of the transmitter
+	*/
+	void getCandidates(Position *src);
+
+	/**
+	* Returns the index of the grid cell containing the given coordinate.
+	*/
+	inline int64_t
+	getCellIndex(double v) const
+	{
+		return (int64_t) floor(v / max_range_);
+	}
+
+	/**
+	* Returns the key of the grid cell with the given indexes.
+	*/
+	static inline int64_t
+	getCellKey(int64_t ix, int64_t iy, int64_t iz)
+	{
+		const int64_t mask = (1 << 21) - 1;
+		return ((ix & mask) << 42) | ((iy & mask) << 21) | (iz & mask);
+	}
+
 	double refractive_index; /**< refractive index of the underwater medium. */
 	double speed_of_light; /**< Speed of light in the underwater medium. */
+
+	double max_range_; /**< Packets are delivered only to the ChSAPs within
+						  this range [m], 0 to deliver to every ChSAP. */
+	double max_speed_; /**< Maximum speed of the nodes [m/s], used to widen
+						  the grid lookup between two refreshes. */
+	double grid_refresh_; /**< Maximum age of the spatial grid [s]. */
+	double grid_time_; /**< Time of the last refresh of the grid. */
+	int grid_nsaps_; /**< Number of ChSAPs at the last refresh, -1 if the
+						grid has to be rebuilt. */
+	std::unordered_map<int64_t, std::vector<int> >
+			grid_; /**< ChSAP indexes in each cell of max_range_ side. */
+	std::vector<int> candidates_; /**< ChSAPs that may receive the packet
+									 being delivered. */
 };
 
 #endif /* UW_OPTICAL_CHANNEL_H */
@@ -230,7 +230,7 @@ CsmaAloha::command(int argc, const char *const *argv)
 		}
 	} else if (argc == 3) {
 		if (strcasecmp(argv[1], "setMacAddr") == 0) {
-			addr = atoi(argv[2]);
+			setMacAddr(atoi(argv[2]));
 			if (debug_)
 				cout << "Csma_Aloha MAC address of current node is " << addr
 					 << endl;
@@ -39,7 +39,7 @@
 #ifndef CSMA_H
 #define CSMA_H
 
-#include <mmac.h>
+#include <uw-mmac.h>
 #include <iostream>
 #include <string>
 #include <map>
@@ -65,7 +65,7 @@ extern packet_t PT_MMAC_ACK;
 /**
  * Class that describes a CsmaAloha module
  */
-class CsmaAloha : public MMac
+class CsmaAloha : public UwMMac
 {
 public:
 	/**
@@ -119,7 +119,7 @@ CsmaCa::command(int argc, const char *const *argv)
 			break;
 		case 3:
 			if (!strcasecmp(argv[1], "setMacAddr")) {
-				addr = atoi(argv[2]);
+				setMacAddr(atoi(argv[2]));
 				return TCL_OK;
 			}
 			break;
@@ -39,7 +39,7 @@
 #ifndef CSMA_CA_H
 #define CSMA_CA_H
 
-#include <mmac.h>
+#include <uw-mmac.h>
 #include <queue>
 #include <sstream>
 #include <fstream>
@@ -93,7 +93,7 @@ string log_level_string[] = {"ERROR", "WARNING", "INFO", "DEBUG"};
 /**
  * Class that describes a CsmaAloha module
  */
-class CsmaCa : public MMac
+class CsmaCa : public UwMMac
 {
 public:
 	class CsmaCaTimer : public TimerHandler
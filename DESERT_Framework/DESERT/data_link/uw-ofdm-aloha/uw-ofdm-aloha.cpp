@@ -231,7 +231,7 @@ int UWOFDMAloha::command(int argc, const char *const *argv)
     {
         if (strcasecmp(argv[1], "setMacAddr") == 0)
         {
-            addr = atoi(argv[2]);
+            setMacAddr(atoi(argv[2]));
             if (debug_)
                 cout << "OFDM Aloha MAC address of current node is " << addr << endl;
             return TCL_OK;
@@ -314,7 +314,7 @@ void UWOFDMAloha::init_macofdm_node(int subCarNum, double subCarSize, int ctrl_s
     for (int i = 0; i < mac_ncarriers; i++)
     {
         mac_carVec.push_back(1);
-        mac_carMod.push_back("BPSK");
+        mac_carMod.push_back(UW_MOD_BPSK);
     }
     for (int i = 0; i < nouse_carriers.size(); i++)
     {
@@ -463,8 +463,8 @@ void UWOFDMAloha::initPkt(Packet *p, UWOFDMALOHA_PKT_TYPE type, int dest_addr)
 
     for (std::size_t i = 0; i < mac_carVec.size(); ++i)
     {
-        ofdmph->carriers[i] = mac_carVec[i];
-        ofdmph->carMod[i] = mac_carMod[i];
+        ofdmph->setCarrier(i, mac_carVec[i]);
+        ofdmph->setCarMod(i, mac_carMod[i]);
     }
     if(uwofdmaloha_debug)
     displayCarriers(p);
@@ -887,7 +887,7 @@ void UWOFDMAloha::stateTxData()
     if (uwofdmaloha_debug)
         for (int i = 0; i < mac_ncarriers; i++)
         {
-            std::cout << "carrier[" << i << "] = " << ofdmph->carMod[i] << std::endl;
+            std::cout << "carrier[" << i << "] = " << uwber::getModulationName(ofdmph->getCarMod(i)) << std::endl;
         }
 
     map<pktSeqNum, AckTimer>::iterator it_a;
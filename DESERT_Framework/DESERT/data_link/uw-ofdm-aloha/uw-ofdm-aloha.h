@@ -32,7 +32,7 @@
  * @version 1.0.0
  *
  * @brief
- * This is the base class of UWOFDMAloha Protocol, derived of MMac.
+ * This is the base class of UWOFDMAloha Protocol, derived of UwMMac.
  * Your can find the brief description of this protocol in the paper, named
  * "Development and Testing of an OFDM Physical Layer for the DESERT Simulator"
  * IEEE/OCEANS, San Diego-Porto, 2021.
@@ -41,7 +41,7 @@
 #ifndef UWOFDMALOHA_H_
 #define UWOFDMALOHA_H_
 
-#include <mmac.h>
+#include <uw-mmac.h>
 #include <iostream>
 #include <string>
 #include <map>
@@ -63,7 +63,7 @@ extern packet_t PT_MMAC_ACK;
 typedef int pktSeqNum;
 
 
-class UWOFDMAloha : public MMac
+class UWOFDMAloha : public UwMMac
 {
 
 public:
@@ -758,7 +758,7 @@ protected:
 	std::cout << NOW << "UwOFDMAloha ("<< addr <<")::displayCarriers";
 
 	for (int i=0; i< mac_ncarriers; i++)
-		 std::cout << " car["<< i << "] = " << ofdmph->carriers[i]; 
+		 std::cout << " car["<< i << "] = " << ofdmph->isCarrierUsed(i); 
 
 	std::cout <<" "<< std::endl;
 	return;
@@ -788,7 +788,7 @@ protected:
 	/////////////////////////////
 
 	/** ----- OFDM PARAMS */
-	std::vector<string> mac_carMod; // Vector with carriers modulations
+	std::vector<UwModulation> mac_carMod; // Vector with carriers modulations
 	std::vector<int> mac_carVec; 	// Vector with carriers used/not used 
 	int mac_ncarriers; 				// number of subcarriers
 	double mac_carrierSize;			// size of each subcarrier
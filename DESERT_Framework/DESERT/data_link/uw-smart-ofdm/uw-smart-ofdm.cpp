@@ -334,7 +334,7 @@ int UWSmartOFDM::command(int argc, const char *const *argv)
 	{
 		if (strcasecmp(argv[1], "setMacAddr") == 0)
 		{
-			addr = atoi(argv[2]);
+			setMacAddr(atoi(argv[2]));
 			if (debug_)
 				cout << "OFDM Aloha MAC address of current node is " << addr << endl;
 			return TCL_OK;
@@ -475,7 +475,7 @@ void UWSmartOFDM::init_macofdm_node(int subCarNum, double carSize, int ctrl_subC
 	// mac_carMod initialization (since it's a vector!)
 	for (int i = 0; i < mac_ncarriers; i++)
 	{
-		mac_carMod.push_back("BPSK");
+		mac_carMod.push_back(UW_MOD_BPSK);
 	}
 	return;
 }
@@ -636,7 +636,7 @@ void UWSmartOFDM::initPkt(Packet *p, UWSMARTOFDM_PKT_TYPE type, int dest_addr)
 		std::cout << NOW << "  UWSmartOFDM (" << addr << ")::initPkt() for a " << pkt_type_info[type] << " packet " << p << " seq_num " << ch->uid() << " size " << ch->size() << std::endl;
 	}
 	for (int i = 0; i < mac_carMod.size(); i++)
-		ofdmph->carMod[i] = mac_carMod[i];
+		ofdmph->setCarMod(i, mac_carMod[i]);
 	ofdmph->carrierNum = mac_ncarriers;
 	ofdmph->carrierSize = mac_carrierSize;
 	ofdmph->nativeOFDM = true;
@@ -696,19 +696,19 @@ void UWSmartOFDM::initPkt(Packet *p, UWSMARTOFDM_PKT_TYPE type, int dest_addr)
 		if (fullBand == false)
 		{
 			for (std::size_t i = 0; i < ctrl_car; ++i)
-				ofdmph->carriers[i] = 1;
+				ofdmph->setCarrier(i, true);
 
 			for (std::size_t i = ctrl_car; i < mac_ncarriers; ++i)
-				ofdmph->carriers[i] = 0;
+				ofdmph->setCarrier(i, false);
 		}
 		else
 		{
 			for (std::size_t i = 0; i < mac_ncarriers; ++i)
-				ofdmph->carriers[i] = 1;
+				ofdmph->setCarrier(i, true);
 		}
 
 		for (std::size_t i = 0; i < mac_ncarriers; ++i)
-			ofdmph->carMod[i] = "BPSK";
+			ofdmph->setCarMod(i, UW_MOD_BPSK);
 	}
 }
 
@@ -1508,12 +1508,12 @@ void UWSmartOFDM::stateTxData()
 		if (fullBand == false)
 		{
 			for (std::size_t i = 0; i < mac_carVec.size(); ++i)
-				ofdmph->carriers[ctrl_car + i] = mac_carVec[i];
+				ofdmph->setCarrier(ctrl_car + i, mac_carVec[i]);
 		}
 		else
 		{
 			for (std::size_t i = 0; i < mac_ncarriers; ++i)
-				ofdmph->carriers[i] = 1;
+				ofdmph->setCarrier(i, true);
 		}
 		txData();
 	}
@@ -1536,12 +1536,12 @@ void UWSmartOFDM::stateTxData()
 				if (fullBand == false)
 				{
 					for (std::size_t i = 0; i < mac_carVec.size(); ++i)
-						ofdmph->carriers[ctrl_car + i] = mac_carVec[i];
+						ofdmph->setCarrier(ctrl_car + i, mac_carVec[i]);
 				}
 				else
 				{
 					for (std::size_t i = 0; i < mac_ncarriers; ++i)
-						ofdmph->carriers[i] = 1;
+						ofdmph->setCarrier(i, true);
 				}
 				txData();
 			}
@@ -1750,7 +1750,7 @@ void UWSmartOFDM::updateInterfTable(Packet *p)
 		}
 		for (int i = 0; i < mac_ncarriers; i++)
 		{
-			if (HDR_OFDM(p)->carriers[i] == 1)
+			if (HDR_OFDM(p)->isCarrierUsed(i))
 				interf_table[i].push_back(NOW);
 		}
 		for (int i = 0; i < mac_ncarriers; i++)
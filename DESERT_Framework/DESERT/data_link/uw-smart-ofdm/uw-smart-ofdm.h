@@ -42,7 +42,7 @@
 #ifndef UWSMARTOFDM_H_
 #define UWSMARTOFDM_H_
 
-#include <mmac.h>
+#include <uw-mmac.h>
 #include <iostream>
 #include <string>
 #include <map>
@@ -94,7 +94,7 @@ enum criticalLevel {LOW = 0, HIGH=1};
 *MMac.
 */
 
-class UWSmartOFDM : public MMac
+class UWSmartOFDM : public UwMMac
 {
 
 public:
@@ -1132,7 +1132,7 @@ protected:
 	/////////////////////////////
 
 	///////////// OFDM PARAMS /////
-	std::vector<string> mac_carMod; // Vector with carriers modulations
+	std::vector<UwModulation> mac_carMod; // Vector with carriers modulations
 	std::vector<int> mac_carVec; // Vector with carriers used/not used 
 	std::vector<char> mac_prioVec; // Vector with node's priorities H/L 
 	int mac_ncarriers; 				// number of subcarriers
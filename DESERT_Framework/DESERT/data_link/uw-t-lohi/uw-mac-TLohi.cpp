@@ -324,7 +324,7 @@ MMacTLOHI::command(int argc, const char *const *argv)
 			tcl_modulation = argv[2];
 			return TCL_OK;
 		} else if (strcasecmp(argv[1], "setMacAddr") == 0) {
-			addr = atoi(argv[2]);
+			setMacAddr(atoi(argv[2]));
 			if (debug_)
 				cout << "T-LOHI MAC address of current node is " << addr
 					 << endl;
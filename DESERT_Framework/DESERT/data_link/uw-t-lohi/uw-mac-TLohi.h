@@ -40,7 +40,7 @@
 #define MMAC_UW_TLOHI_H
 
 //#include<module.h>
-#include <mmac.h>
+#include <uw-mmac.h>
 #include <vector>
 #include <string>
 #include <map>
@@ -236,7 +236,7 @@ protected:
 /**
  * Class that represents the T-LOHI MAC protocol for a node
  */
-class MMacTLOHI : public MMac
+class MMacTLOHI : public UwMMac
 {
 	/**
 	 * Timer class
@@ -286,7 +286,7 @@ uwUFetch_AUV::command(int argc, const char *const *argv)
 		}
 	} else if (argc == 3) {
 		if (strcasecmp(argv[1], "setMacAddr") == 0) {
-			addr = atoi(argv[2]);
+			setMacAddr(atoi(argv[2]));
 			if (debug_)
 				std::cout << "UWFETCH_AUV MAC address is:" << addr << std::endl;
 
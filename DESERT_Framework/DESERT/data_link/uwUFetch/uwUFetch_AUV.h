@@ -37,7 +37,7 @@
 #ifndef UWUFETCH_AUV_H_
 #define UWUFETCH_AUV_H_
 
-#include <mmac.h>
+#include <uw-mmac.h>
 #include <iostream>
 #include <clmessage.h>
 #include <mphy.h>
@@ -81,7 +81,7 @@ extern packet_t
 /**
  * Class that represent the UFetch mac layer for AUV node
  */
-class uwUFetch_AUV : public MMac
+class uwUFetch_AUV : public UwMMac
 {
 public:
 	/**
@@ -38,7 +38,7 @@
 #ifndef UWUFETCH_NODE_H_
 #define UWUFETCH_NODE_H_
 
-#include <mmac.h>
+#include <uw-mmac.h>
 #include <stdio.h>
 #include <time.h>
 #include <iostream>
@@ -132,7 +132,7 @@ typedef struct probbed_node {
 
 /**< uwuFetch_NODE class */
 
-class uwUFetch_NODE : public MMac
+class uwUFetch_NODE : public UwMMac
 {
 public:
 	/**
@@ -401,7 +401,7 @@ uwUFetch_NODE::command(int argc, const char *const *argv)
 		}
 	} else if (argc == 3) {
 		if (strcasecmp(argv[1], "setMacAddr") == 0) {
-			addr = atoi(argv[2]);
+			setMacAddr(atoi(argv[2]));
 			if (debug_)
 				std::cout << "UWFETCH_NODE MAC address is:" << addr
 						  << std::endl;
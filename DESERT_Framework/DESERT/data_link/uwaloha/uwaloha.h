@@ -40,7 +40,7 @@
 #ifndef UWALOHA_H_
 #define UWALOHA_H_
 
-#include <mmac.h>
+#include <uw-mmac.h>
 #include <iostream>
 #include <string>
 #include <map>
@@ -65,7 +65,7 @@ typedef int pktSeqNum;
 *MMac.
 */
 
-class UWAloha : public MMac
+class UWAloha : public UwMMac
 {
 
 public:
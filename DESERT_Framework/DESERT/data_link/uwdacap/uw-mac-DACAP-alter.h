@@ -39,7 +39,7 @@
 #ifndef MMAC_UW_DACAP_H
 #define MMAC_UW_DACAP_H
 
-#include <mmac.h>
+#include <uw-mmac.h>
 #include <queue>
 #include <string>
 #include <map>
@@ -152,7 +152,7 @@ protected:
 /**
  * Class that represents a DACAP node
  */
-class MMacDACAP : public MMac
+class MMacDACAP : public UwMMac
 {
 	friend class DACAPTimer; /**< DACAP ACK timer */
 	friend class DACAPBTimer; /**< DACAP Backoff timer */
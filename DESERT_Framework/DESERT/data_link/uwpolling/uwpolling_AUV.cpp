@@ -220,7 +220,7 @@ Uwpolling_AUV::command(int argc, const char *const *argv)
 		}
 	} else if (argc == 3) {
 		if (strcasecmp(argv[1], "setMacAddr") == 0) {
-			addr = atoi(argv[2]);
+			setMacAddr(atoi(argv[2]));
 			if (debug_)
 				std::cout << "UWPOLLING MAC address of the AUV is " << addr
 						  << std::endl;
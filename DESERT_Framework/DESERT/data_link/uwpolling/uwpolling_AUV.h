@@ -40,7 +40,7 @@
 
 #include "uwpolling_cmn_hdr.h"
 
-#include <mmac.h>
+#include <uw-mmac.h>
 #include <mphy.h>
 #include <clmessage.h>
 #include <iostream>
@@ -178,7 +178,7 @@ typedef struct probbed_node {
 /**
  * Class used to represent the UWPOLLING MAC layer of the AUV
  */
-class Uwpolling_AUV : public MMac
+class Uwpolling_AUV : public UwMMac
 {
 public:
 	/**
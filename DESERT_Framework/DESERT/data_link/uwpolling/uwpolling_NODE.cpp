@@ -233,7 +233,7 @@ Uwpolling_NODE::command(int argc, const char *const *argv)
 
 	} else if (argc == 3) {
 		if (strcasecmp(argv[1], "setMacAddr") == 0) {
-			addr = atoi(argv[2]);
+			setMacAddr(atoi(argv[2]));
 			return TCL_OK;
 		}
 	}
@@ -41,7 +41,7 @@
 #define Uwpolling_HDR_NODE_H
 
 #include "uwpolling_cmn_hdr.h"
-#include "mmac.h"
+#include "uw-mmac.h"
 
 #include <iostream>
 #include <string>
@@ -71,7 +71,7 @@
 /**
  * Class used to represents the UWPOLLING MAC layer of a node.
  */
-class Uwpolling_NODE : public MMac
+class Uwpolling_NODE : public UwMMac
 {
 public:
 	/**
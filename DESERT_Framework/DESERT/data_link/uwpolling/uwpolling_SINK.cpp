@@ -79,7 +79,7 @@ public:
 } class_module_uwpolling_sink;
 
 Uwpolling_SINK::Uwpolling_SINK()
-	: MMac()
+	: UwMMac()
 	, T_data(0)
 	, T_data_gurad(0)
 	, backoff_tuner(0)
@@ -174,7 +174,7 @@ Uwpolling_SINK::command(int argc, const char *const *argv)
 		}
 	} else if (argc == 3) {
 		if (strcasecmp(argv[1], "setMacAddr") == 0) {
-			addr = atoi(argv[2]);
+			setMacAddr(atoi(argv[2]));
 			return TCL_OK;
 		}
 	}
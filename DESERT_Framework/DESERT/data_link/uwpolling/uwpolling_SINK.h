@@ -41,7 +41,7 @@
 #define Uwpolling_HDR_SINK_H
 
 #include "uwpolling_cmn_hdr.h"
-#include "mmac.h"
+#include "uw-mmac.h"
 
 #include <iostream>
 #include <string>
@@ -72,7 +72,7 @@
 	/**
  * Class used to represents the UWPOLLING MAC layer of a node.
  */
-class Uwpolling_SINK : public MMac
+class Uwpolling_SINK : public UwMMac
 {
 public:
 	/**
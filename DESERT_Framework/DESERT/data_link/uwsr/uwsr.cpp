@@ -269,7 +269,7 @@ MMacUWSR::command(int argc, const char *const *argv)
 		}
 	} else if (argc == 3) {
 		if (strcasecmp(argv[1], "setMacAddr") == 0) {
-			addr = atoi(argv[2]);
+			setMacAddr(atoi(argv[2]));
 			if (debug_)
 				cout << "UwSR MAC address of current node is " << addr << endl;
 			return TCL_OK;
@@ -50,7 +50,7 @@
 #define UWSR_H
 
 #include <mac.h>
-#include <mmac.h>
+#include <uw-mmac.h>
 #include <iostream>
 #include <string>
 #include <map>
@@ -78,10 +78,10 @@ typedef pair<int, int> txStatusPair;
 
 /**
 *@brief This is the base class of MMacUWSR protocol, which is a derived class of
-*MMac.
+*UwMMac.
 */
 
-class MMacUWSR : public MMac
+class MMacUWSR : public UwMMac
 {
 
 public:
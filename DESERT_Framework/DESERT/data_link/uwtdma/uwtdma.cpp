@@ -77,7 +77,7 @@ UwTDMATimer::expire(Event *e)
 }
 
 UwTDMA::UwTDMA()
-	: MMac()
+	: UwMMac()
 	, tdma_timer(this)
 	, slot_status(UW_TDMA_STATUS_NOT_MY_SLOT)
 	, slot_duration(0)
@@ -487,7 +487,7 @@ UwTDMA::command(int argc, const char *const *argv)
 			slot_number = atoi(argv[2]);
 			return TCL_OK;
 		} else if (strcasecmp(argv[1], "setMacAddr") == 0) {
-			addr = atoi(argv[2]);
+			setMacAddr(atoi(argv[2]));
 			if (debug_)
 				cout << "TDMA MAC address of current node is " << addr
 					 << std::endl;
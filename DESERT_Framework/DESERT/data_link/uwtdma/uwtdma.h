@@ -40,7 +40,7 @@
 #ifndef UWTDMA_H
 #define UWTDMA_H
 
-#include <mmac.h>
+#include <uw-mmac.h>
 #include <queue>
 #include <deque>
 #include <iostream>
@@ -88,7 +88,7 @@ protected:
 /**
  * Class that represents a TDMA Node
  */
-class UwTDMA : public MMac
+class UwTDMA : public UwMMac
 {
 
 	friend class UwTDMATimer;
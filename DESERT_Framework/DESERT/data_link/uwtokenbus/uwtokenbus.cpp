@@ -91,7 +91,7 @@ int UwTokenBus::count_bus_idle_exp = -1;	//start from -1 because initRing will d
 
 //default constructor
 UwTokenBus::UwTokenBus()
-	: MMac(), 
+	: UwMMac(), 
 	node_id(count_nodes++),
 	n_nodes(0),
 	last_token_id_heard(0),
@@ -521,7 +521,7 @@ int UwTokenBus::command(int argc, const char *const *argv)
 		}
 		else if (strcasecmp(argv[1], "setMacAddr") == 0)
 		{
-			addr = atoi(argv[2]);
+			setMacAddr(atoi(argv[2]));
 			DEBUG(4, " MAC address: " << addr)
 			return TCL_OK;
 		}
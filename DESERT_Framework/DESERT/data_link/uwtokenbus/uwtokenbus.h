@@ -40,7 +40,7 @@
 #define UWTOKENBUS_H
 
 #include "uwtokenbus_hdr.h"
-#include <mmac.h>
+#include <uw-mmac.h>
 #include <deque>
 
 extern packet_t PT_UWTOKENBUS;
@@ -48,7 +48,7 @@ extern packet_t PT_UWTOKENBUS;
 /**
  * Class that represents a TokenBus Node
  */
-class UwTokenBus : public MMac
+class UwTokenBus : public UwMMac
 {
 
 public:
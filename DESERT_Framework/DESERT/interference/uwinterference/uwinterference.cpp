@@ -41,6 +41,9 @@
 #include <mphy.h>
 #include <mac.h>
 #include <iostream>
+#include <algorithm>
+#include <deque>
+#include <random>
 
 #define POWER_PRECISION_THRESHOLD (1e-14)
 #define EPSILON_TIME 0.000000000001
@@ -69,6 +72,107 @@ EndInterfTimer::handle(Event *e)
 	delete ee;
 }
 
+PowerRing::PowerRing()
+	: buffer_(16)
+	, head_(0)
+	, size_(0)
+	, pops_(0)
+{
+}
+
+void
+PowerRing::push_back(double t, double sum_pw, int ctrl, int data)
+{
+	if (size_ == buffer_.size())
+		grow();
+
+	PowerNode &node = buffer_[(head_ + size_) & (buffer_.size() - 1)];
+	if (size_ == 0) {
+		node.energy = 0;
+		node.overlap = 0;
+		node.ctrl_arrivals = 0;
+		node.data_arrivals = 0;
+	} else {
+		const PowerNode &last = back();
+		// Keep the timeline sorted: a sample can only be a few EPSILON_TIME
+		// older than the previous one
+		if (t < last.time)
+			t = last.time;
+		double dt = t - last.time;
+		node.energy = last.energy + last.sum_power * dt;
+		node.overlap = last.overlap +
+				((last.ctrl_cnt > 1 || last.data_cnt > 1) ? dt : 0);
+		node.ctrl_arrivals = last.ctrl_arrivals +
+				(ctrl > last.ctrl_cnt ? ctrl - last.ctrl_cnt : 0);
+		node.data_arrivals = last.data_arrivals +
+				(data > last.data_cnt ? data - last.data_cnt : 0);
+	}
+	node.time = t;
+	node.sum_power = sum_pw;
+	node.ctrl_cnt = ctrl;
+	node.data_cnt = data;
+	size_++;
+}
+
+void
+PowerRing::pop_front()
+{
+	assert(size_ > 0);
+	head_ = (head_ + 1) & (buffer_.size() - 1);
+	size_--;
+	if (++pops_ >= buffer_.size())
+		rebase();
+}
+
+void
+PowerRing::clear()
+{
+	head_ = 0;
+	size_ = 0;
+	pops_ = 0;
+}
+
+size_t
+PowerRing::upper_bound(double t) const
+{
+	size_t low = 0;
+	size_t high = size_;
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		if ((*this)[mid].time <= t)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+void
+PowerRing::grow()
+{
+	std::vector<PowerNode> bigger(buffer_.size() * 2);
+	for (size_t i = 0; i < size_; i++)
+		bigger[i] = (*this)[i];
+	buffer_.swap(bigger);
+	head_ = 0;
+}
+
+void
+PowerRing::rebase()
+{
+	pops_ = 0;
+	if (size_ == 0)
+		return;
+	const PowerNode first = front();
+	for (size_t i = 0; i < size_; i++) {
+		PowerNode &node = (*this)[i];
+		node.energy -= first.energy;
+		node.overlap -= first.overlap;
+		node.ctrl_arrivals -= first.ctrl_arrivals;
+		node.data_arrivals -= first.data_arrivals;
+	}
+}
+
 uwinterference::uwinterference()
 	: power_list()
 	, end_timer(this)
@@ -84,6 +188,20 @@ uwinterference::~uwinterference()
 {
 }
 
+int
+uwinterference::command(int argc, const char *const *argv)
+{
+	if (argc == 3 || argc == 4) {
+		if (strcmp(argv[1], "checkIntegrals") == 0) {
+			unsigned int seed = (argc == 4) ? atoi(argv[3]) : 1;
+			if (!checkIntegrals(atoi(argv[2]), seed))
+				return TCL_ERROR;
+			return TCL_OK;
+		}
+	}
+	return MInterferenceMIV::command(argc, argv);
+}
+
 void
 uwinterference::addToInterference(Packet *p)
 {
@@ -107,34 +225,24 @@ uwinterference::addToInterference(Packet *p)
 void
 uwinterference::addToInterference(double pw, PKT_TYPE tp)
 {
-	if (use_maxinterval_) {
-		std::list<ListNode>::iterator it;
-		for (it = power_list.begin(); it != power_list.end();) {
-			if (it->time < NOW - maxinterval_) {
-				it = power_list.erase(it); // Side effect: it++
-			} else
-				break;
-		}
-	}
+	purgeOldSamples();
 
 	if (power_list.empty()) {
 		if (tp == CTRL) {
-			ListNode pn(NOW, pw, 1, 0);
-			power_list.push_back(pn);
+			power_list.push_back(NOW, pw, 1, 0);
 		} else {
-			ListNode pn(NOW, pw, 0, 1);
-			power_list.push_back(pn);
+			power_list.push_back(NOW, pw, 0, 1);
 		}
 	} else {
 		double power_temp = power_list.back().sum_power;
 		int ctrl_temp = power_list.back().ctrl_cnt;
 		int data_temp = power_list.back().data_cnt;
 		if (tp == CTRL) {
-			ListNode pn(NOW, pw + power_temp, ctrl_temp + 1, data_temp);
-			power_list.push_back(pn);
+			power_list.push_back(
+					NOW, pw + power_temp, ctrl_temp + 1, data_temp);
 		} else {
-			ListNode pn(NOW, pw + power_temp, ctrl_temp, data_temp + 1);
-			power_list.push_back(pn);
+			power_list.push_back(
+					NOW, pw + power_temp, ctrl_temp, data_temp + 1);
 		}
 	}
 
@@ -150,16 +258,7 @@ uwinterference::addToInterference(double pw, PKT_TYPE tp)
 void
 uwinterference::removeFromInterference(double pw, PKT_TYPE tp)
 {
-	if (use_maxinterval_) {
-		std::list<ListNode>::iterator it;
-
-		for (it = power_list.begin(); it != power_list.end();) {
-			if (it->time < NOW - maxinterval_) {
-				it = power_list.erase(it); // Side effect: it++
-			} else
-				break;
-		}
-	}
+	purgeOldSamples();
 
 	if (power_list.empty()) {
 		std::cerr << "uwinterference::removeFromInterference, "
@@ -173,19 +272,17 @@ uwinterference::removeFromInterference(double pw, PKT_TYPE tp)
 		if (tp == CTRL) {
 			// NOW+EPSILON_TIME to compensate the early scheduling in
 			// addToInterference(Packet* p)
-			ListNode pn(NOW + EPSILON_TIME,
+			power_list.push_back(NOW + EPSILON_TIME,
 					power_temp - pw,
 					ctrl_temp - 1,
 					data_temp);
-			power_list.push_back(pn);
 		} else {
 			// NOW+EPSILON_TIME to compensate the early scheduling in
 			// addToInterference(Packet* p)
-			ListNode pn(NOW + EPSILON_TIME,
+			power_list.push_back(NOW + EPSILON_TIME,
 					power_temp - pw,
 					ctrl_temp,
 					data_temp - 1);
-			power_list.push_back(pn);
 		}
 	}
 	if (debug_) {
@@ -208,42 +305,135 @@ uwinterference::removeFromInterference(double pw, PKT_TYPE tp)
 	}
 }
 
-double
-uwinterference::getInterferencePower(Packet *p)
+void
+uwinterference::purgeOldSamples()
 {
-
-	hdr_MPhy *ph = HDR_MPHY(p);
-	double a = getTimeOverlap(p);
-	if (debug_) {
-		std::cout << NOW << " uwinterference::getInterferencePower, "
-				  << "percentage of overlap: " << a << std::endl;
+	if (use_maxinterval_) {
+		while (!power_list.empty() &&
+				power_list.front().time < NOW - maxinterval_) {
+			power_list.pop_front();
+		}
 	}
-	return (getInterferencePower(ph->Pr, ph->rxtime, ph->duration));
 }
 
-double
-uwinterference::getInterferencePower(
-		double power, double starttime, double duration)
+void
+uwinterference::integrate(double starttime, double &energy, double &overlap,
+		counter &cnt) const
 {
-	std::list<ListNode>::reverse_iterator rit;
+	energy = 0;
+	overlap = 0;
+	cnt = counter(0, 0);
+	if (power_list.empty())
+		return;
 
-	double integral = 0;
-	double lasttime = NOW;
-	assert(starttime <= NOW);
-	assert(duration > 0);
+	// Integrals from the first sample to NOW
+	size_t n = power_list.size();
+	const PowerNode &last = power_list[n - 1];
+	energy = last.energy + last.sum_power * (NOW - last.time);
+	overlap = last.overlap +
+			((last.ctrl_cnt > 1 || last.data_cnt > 1) ? (NOW - last.time)
+													  : 0);
+
+	// Last sample not after starttime, if any
+	long j = (long) power_list.upper_bound(starttime) - 1;
+	if (j >= 0) {
+		const PowerNode &node = power_list[j];
+		energy -= node.energy + node.sum_power * (starttime - node.time);
+		overlap -= node.overlap +
+				((node.ctrl_cnt > 1 || node.data_cnt > 1)
+								? (starttime - node.time)
+								: 0);
+	} else {
+		// no power before the first sample, whose prefix integrals are
+		// not zero until the ring is rebased
+		energy -= power_list[0].energy;
+		overlap -= power_list[0].overlap;
+	}
 
-	for (rit = power_list.rbegin(); rit != power_list.rend(); ++rit) {
-		if (starttime < rit->time) {
-			integral += rit->sum_power * (lasttime - rit->time);
-			lasttime = rit->time;
+	// Packets active at the sample before starttime plus the ones arrived
+	// later. The last sample is the end of the current reception.
+	long jc = std::min(j, (long) n - 2);
+	const PowerNode &next = power_list[jc + 1];
+	cnt.first = last.ctrl_arrivals - next.ctrl_arrivals;
+	cnt.second = last.data_arrivals - next.data_arrivals;
+	if (jc >= 0) {
+		cnt.first += power_list[jc].ctrl_cnt;
+		cnt.second += power_list[jc].data_cnt;
+	}
+}
 
+bool
+uwinterference::checkIntegrals(unsigned int iterations, unsigned int seed)
+{
+	PowerRing saved = power_list;
+	power_list.clear();
+	std::deque<ListNode> ref;
+
+	// a generator of its own, not to alter the random stream of the
+	// simulation
+	std::mt19937 gen(seed);
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	std::uniform_int_distribution<int> pkts(0, 2);
+
+	// the samples span the last second, so that none is after NOW
+	double step = 1.0 / (iterations + 1);
+	double t = NOW - 1.0;
+	bool passed = true;
+
+	for (unsigned int it = 0; it < iterations && passed; it++) {
+		if (!ref.empty() && unit(gen) < 0.4) {
+			// purge, rebasing the ring every few pops
+			power_list.pop_front();
+			ref.pop_front();
 		} else {
-			integral += rit->sum_power * (lasttime - starttime);
+			t += step * unit(gen);
+			ListNode node(t, unit(gen), pkts(gen), pkts(gen));
+			power_list.push_back(
+					node.time, node.sum_power, node.ctrl_cnt, node.data_cnt);
+			ref.push_back(node);
+		}
+		if (ref.empty())
+			continue;
+
+		// window starting up to one step before the first sample
+		double first = ref.front().time - step;
+		double starttime = first + (NOW - first) * unit(gen);
+		double energy, overlap;
+		counter cnt;
+		integrate(starttime, energy, overlap, cnt);
+
+		double ref_energy = 0;
+		double ref_overlap = 0;
+		for (size_t i = 0; i < ref.size(); i++) {
+			double from = std::max(starttime, ref[i].time);
+			double to = (i + 1 < ref.size()) ? ref[i + 1].time : NOW;
+			if (to <= from)
+				continue;
+			ref_energy += ref[i].sum_power * (to - from);
+			if (ref[i].ctrl_cnt > 1 || ref[i].data_cnt > 1)
+				ref_overlap += to - from;
+		}
 
-			break;
+		if (fabs(energy - ref_energy) > 1e-9 ||
+				fabs(overlap - ref_overlap) > 1e-9) {
+			std::cerr << "uwinterference::checkIntegrals() mismatch, "
+					  << "samples " << ref.size() << ", starttime "
+					  << starttime << ", energy " << energy << " ("
+					  << ref_energy << "), overlap " << overlap << " ("
+					  << ref_overlap << ")" << std::endl;
+			passed = false;
 		}
 	}
-	double interference = (integral / duration) - power;
+
+	power_list = saved;
+	return passed;
+}
+
+double
+uwinterference::toInterferencePower(
+		double energy, double power, double starttime, double duration) const
+{
+	double interference = (energy / duration) - power;
 
 	if (abs(interference) < POWER_PRECISION_THRESHOLD) {
 		if (debug_)
@@ -272,6 +462,33 @@ uwinterference::getInterferencePower(
 	return interference;
 }
 
+double
+uwinterference::getInterferencePower(Packet *p)
+{
+
+	hdr_MPhy *ph = HDR_MPHY(p);
+	if (debug_) {
+		double a = getTimeOverlap(p);
+		std::cout << NOW << " uwinterference::getInterferencePower, "
+				  << "percentage of overlap: " << a << std::endl;
+	}
+	return (getInterferencePower(ph->Pr, ph->rxtime, ph->duration));
+}
+
+double
+uwinterference::getInterferencePower(
+		double power, double starttime, double duration)
+{
+	double energy;
+	double overlap;
+	counter cnt;
+	assert(starttime <= NOW);
+	assert(duration > 0);
+
+	integrate(starttime, energy, overlap, cnt);
+	return toInterferencePower(energy, power, starttime, duration);
+}
+
 double
 uwinterference::getCurrentTotalPower()
 {
@@ -292,29 +509,13 @@ uwinterference::getTimeOverlap(Packet *p)
 double
 uwinterference::getTimeOverlap(double starttime, double duration)
 {
-	std::list<ListNode>::reverse_iterator rit;
-
-	double overlap = 0;
-	double lasttime = NOW;
+	double energy;
+	double overlap;
+	counter cnt;
 	assert(starttime <= NOW);
 	assert(duration > 0);
 
-	for (rit = power_list.rbegin(); rit != power_list.rend(); ++rit) {
-		if (starttime < rit->time) {
-
-			if (rit->ctrl_cnt > 1 || rit->data_cnt > 1) {
-				overlap += (lasttime - rit->time);
-			}
-			lasttime = rit->time;
-
-		} else {
-			if (rit->ctrl_cnt > 1 || rit->data_cnt > 1) {
-				overlap += (lasttime - starttime);
-			}
-			break;
-		}
-	}
-
+	integrate(starttime, energy, overlap, cnt);
 	return overlap / duration;
 }
 
@@ -335,46 +536,57 @@ uwinterference::getCounters(Packet *p)
 counter
 uwinterference::getCounters(double starttime, double duration, PKT_TYPE tp)
 {
-	std::list<ListNode>::reverse_iterator rit;
-
-	int ctrl_pkts = 0;
-	int data_pkts = 0;
-
+	double energy;
+	double overlap;
+	counter cnt;
 	assert(starttime <= NOW);
 	assert(duration > 0);
 
-	rit = power_list.rbegin();
-	int last_ctrl_cnt = rit->ctrl_cnt;
-	int last_data_cnt = rit->data_cnt;
-	rit++;
-	for (; rit != power_list.rend(); ++rit) {
-		if (starttime < rit->time) {
-			if (last_ctrl_cnt - rit->ctrl_cnt >= 0) {
-				ctrl_pkts += last_ctrl_cnt - rit->ctrl_cnt;
-			}
-			if (last_data_cnt - rit->data_cnt >= 0) {
-				data_pkts += last_data_cnt - rit->data_cnt;
-			}
-			last_ctrl_cnt = rit->ctrl_cnt;
-			last_data_cnt = rit->data_cnt;
-		} else {
-			ctrl_pkts += rit->ctrl_cnt;
-			data_pkts += rit->data_cnt;
-			break;
-		}
-	}
-
+	integrate(starttime, energy, overlap, cnt);
 	if (tp == CTRL) {
-		ctrl_pkts--;
+		cnt.first--;
 	} else {
-		data_pkts--;
+		cnt.second--;
 	}
 
 	if (debug_) {
 		std::cout << NOW << " uwinterference::getCounters(), collisions"
-				  << " with ctrl pkts: " << ctrl_pkts
-				  << ", collisions with data pkts: " << data_pkts << std::endl;
+				  << " with ctrl pkts: " << cnt.first
+				  << ", collisions with data pkts: " << cnt.second
+				  << std::endl;
 	}
 
-	return counter(ctrl_pkts, data_pkts);
+	return cnt;
+}
+
+InterferenceSummary
+uwinterference::getInterferenceSummary(Packet *p)
+{
+	hdr_MPhy *ph = HDR_MPHY(p);
+	hdr_mac *mach = HDR_MAC(p);
+	return getInterferenceSummary(ph->Pr,
+			ph->rxtime,
+			ph->duration,
+			mach->ftype() == MF_CONTROL ? CTRL : DATA);
+}
+
+InterferenceSummary
+uwinterference::getInterferenceSummary(
+		double power, double starttime, double duration, PKT_TYPE tp)
+{
+	InterferenceSummary summary;
+	double energy;
+	double overlap;
+	assert(starttime <= NOW);
+	assert(duration > 0);
+
+	integrate(starttime, energy, overlap, summary.counters);
+	summary.power = toInterferencePower(energy, power, starttime, duration);
+	summary.overlap = overlap / duration;
+	if (tp == CTRL) {
+		summary.counters.first--;
+	} else {
+		summary.counters.second--;
+	}
+	return summary;
 }
@@ -95,31 +95,145 @@ public:
 	}
 };
 
-class EndInterfEvent : public Event
+/**
+ * Sample of the interference timeline, together with the integrals of the
+ * timeline from the first sample held by the PowerRing to this one.
+ */
+class PowerNode
+{
+public:
+	double time; /** time of the sample */
+	double sum_power; /** sum of the rx power in the node at the given time*/
+	int ctrl_cnt; /** control packet counter */
+	int data_cnt; /** data packet counter */
+	double energy; /** integral of sum_power up to time */
+	double overlap; /** time with more than one packet of the same type
+					   up to time */
+	int ctrl_arrivals; /** control packets arrived up to time */
+	int data_arrivals; /** data packets arrived up to time */
+};
+
+/**
+ * Contiguous ring buffer of PowerNode, sorted by time. Each node keeps the
+ * prefix integrals of the timeline, so that any integral between two time
+ * instants is the difference of two nodes found with a binary search.
+ */
+class PowerRing
 {
 public:
 	/**
-	 * Constructor of the class EndInterfEvent
-	 * @param pw Received power of the current packet
-	 * @param type type of the packet (DATA or CTRL)
+	 * Constructor of the class PowerRing
 	 */
-	EndInterfEvent(double pw, PKT_TYPE tp)
+	PowerRing();
+
+	/**
+	 * Appends a sample to the timeline
+	 * @param t time of the sample, not smaller than the time of the last one
+	 * @param sum_pw sum of the rx power at the given time
+	 * @param ctrl control packet counter
+	 * @param data data packet counter
+	 */
+	void push_back(double t, double sum_pw, int ctrl, int data);
+
+	/**
+	 * Removes the oldest sample of the timeline
+	 */
+	void pop_front();
+
+	/**
+	 * Removes all the samples of the timeline
+	 */
+	void clear();
+
+	/**
+	 * Index of the first sample with time greater than t
+	 * @param t time instant
+	 * @return number of samples with time smaller or equal to t
+	 */
+	size_t upper_bound(double t) const;
+
+	inline size_t
+	size() const
 	{
-		power = pw;
-		type = tp;
+		return size_;
+	}
+
+	inline bool
+	empty() const
+	{
+		return size_ == 0;
+	}
+
+	inline PowerNode &
+	operator[](size_t i)
+	{
+		return buffer_[(head_ + i) & (buffer_.size() - 1)];
+	}
+
+	inline const PowerNode &
+	operator[](size_t i) const
+	{
+		return buffer_[(head_ + i) & (buffer_.size() - 1)];
+	}
+
+	inline PowerNode &
+	front()
+	{
+		return (*this)[0];
+	}
+
+	inline PowerNode &
+	back()
+	{
+		return (*this)[size_ - 1];
 	}
+
+	inline const PowerNode &
+	back() const
+	{
+		return (*this)[size_ - 1];
+	}
+
+protected:
+	/**
+	 * Doubles the capacity of the buffer, keeping the samples in order
+	 */
+	void grow();
+
 	/**
-	 * Constructor of the class EndInterfEvent for OFDM 
+	 * Subtracts the integrals of the first sample from every sample, to
+	 * keep the prefix integrals small and precise
+	 */
+	void rebase();
+
+	std::vector<PowerNode> buffer_; /**< Storage, size is a power of 2 */
+	size_t head_; /**< Index of the oldest sample in buffer_ */
+	size_t size_; /**< Number of samples */
+	size_t pops_; /**< Samples removed since the last rebase */
+};
+
+/**
+ * Result of a single interference query on a reception interval
+ */
+struct InterferenceSummary {
+	double power; /**< average interference power */
+	double overlap; /**< percentage of overlap */
+	counter counters; /**< collisions with (ctrl, data) packets */
+};
+
+class EndInterfEvent : public Event
+{
+public:
+	/**
+	 * Constructor of the class EndInterfEvent
 	 * @param pw Received power of the current packet
 	 * @param type type of the packet (DATA or CTRL)
 	 */
-
-	EndInterfEvent(double pw, PKT_TYPE tp, const std::vector<double>& carPwr): carrier_power(carPwr)
+	EndInterfEvent(double pw, PKT_TYPE tp)
 	{
 		power = pw;
 		type = tp;
 	}
-
 	/**
 	 * Destructor of the class EndInterfEvent
 	 */
@@ -128,7 +242,6 @@ public:
 	}
 	double power;
 	PKT_TYPE type;
-	std::vector<double> carrier_power;
 };
 
 class uwinterference;
@@ -157,6 +270,28 @@ public:
 	 * Destructor of the class uwinterference
 	 */
 	virtual ~uwinterference();
+	/**
+	 * TCL command interpreter. It implements the following OTcl methods:
+	 *
+	 * @param argc Number of arguments in <i>argv</i>.
+	 * @param argv Array of strings which are the command parameters (Note
+	 * that <i>argv[0]</i> is the name of the object).
+	 * @return TCL_OK or TCL_ERROR whether the command has been dispatched
+	 * successfully or not.
+	 */
+	virtual int command(int argc, const char *const *argv);
+	/**
+	 * Differential check of the integrals of the timeline against a sample
+	 * by sample integration, on random timelines whose oldest samples are
+	 * purged, with windows starting before and after the first sample.
+	 * The timeline of the module is restored at the end of the check.
+	 *
+	 * @param iterations number of random samples and windows to check.
+	 * @param seed seed of the generator of the timelines, which does not
+	 * use the random stream of the simulation.
+	 * @return true if every window matches the reference, false otherwise.
+	 */
+	bool checkIntegrals(unsigned int iterations, unsigned int seed = 1);
 	/**
 	 * Add a packet to the interference calculation
 	 * @param p Pointer to the interferer packet
@@ -219,6 +354,24 @@ public:
 	 * @return counter variable that represent the counters of the interference
 	 */
 	virtual counter getCounters(double starttime, double duration, PKT_TYPE tp);
+	/**
+	 * Returns interference power, overlap and counters of collisions with a
+	 * single lookup of the interference timeline
+	 * @param p Pointer of the packet for which the values are needed
+	 * @return power, overlap and counters of the interference
+	 */
+	virtual InterferenceSummary getInterferenceSummary(Packet *p);
+	/**
+	 * Returns interference power, overlap and counters of collisions with a
+	 * single lookup of the interference timeline
+	 * @param power Received power of the current packet
+	 * @param starttime timestamp of the start of reception phase
+	 * @param duration duration of the reception phase
+	 * @param type type of the packet (DATA or CTRL)
+	 * @return power, overlap and counters of the interference
+	 */
+	virtual InterferenceSummary getInterferenceSummary(
+			double power, double starttime, double duration, PKT_TYPE tp);
 	/**
 	 * Get the timestamp of the start of reception phase
 	 * @return timestamp of the start of reception phase
@@ -250,7 +403,31 @@ public:
 	}
 
 protected:
-	std::list<ListNode> power_list; /**<List with power and counters*/
+	/**
+	 * Removes the samples older than maxinterval_, if use_maxinterval_ is set
+	 */
+	void purgeOldSamples();
+	/**
+	 * Integrals of the interference timeline from starttime to NOW
+	 * @param starttime timestamp of the start of reception phase
+	 * @param energy integral of the total received power
+	 * @param overlap time with more than one packet of the same type
+	 * @param cnt packets received in the interval, including the current one
+	 */
+	void integrate(double starttime, double &energy, double &overlap,
+			counter &cnt) const;
+	/**
+	 * Converts the integral of the power into the average interference power
+	 * @param energy integral of the total received power
+	 * @param power Received power of the current packet
+	 * @param starttime timestamp of the start of reception phase
+	 * @param duration duration of the reception phase
+	 * @return average interference power
+	 */
+	double toInterferencePower(double energy, double power, double starttime,
+			double duration) const;
+
+	PowerRing power_list; /**<Timeline with power and counters*/
 	EndInterfTimer end_timer; /**< Timer for schedules end of interference
 									 for a transmission */
 	double use_maxinterval_; /**< set to 1 to use maxinterval_. */
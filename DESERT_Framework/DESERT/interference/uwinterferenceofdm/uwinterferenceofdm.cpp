@@ -41,6 +41,7 @@
 #include <mphy.h>
 #include <mac.h>
 #include <iostream>
+#include <algorithm>
 
 #define POWER_PRECISION_THRESHOLD (1e-14)
 #define EPSILON_TIME 0.000000000001
@@ -60,11 +61,67 @@ public:
 	}
 } class_interf_foverlap;
 
+CarrierPowerRing::CarrierPowerRing()
+	: nodes_(16)
+	, carrier_power_(16 * MAX_CARRIERS)
+	, head_(0)
+	, size_(0)
+{
+}
+
+double *
+CarrierPowerRing::push_back(double t, double sum_pw, int ctrl, int data)
+{
+	if (size_ == nodes_.size())
+		grow();
+
+	size_t slot = (head_ + size_) & (nodes_.size() - 1);
+	CarrierPowerNode &node = nodes_[slot];
+	node.time = t;
+	node.sum_power = sum_pw;
+	node.ctrl_cnt = ctrl;
+	node.data_cnt = data;
+
+	double *row = &carrier_power_[slot * MAX_CARRIERS];
+	if (size_ == 0) {
+		std::fill(row, row + MAX_CARRIERS, 0.0);
+	} else {
+		const double *last = carriers(size_ - 1);
+		std::copy(last, last + MAX_CARRIERS, row);
+	}
+	size_++;
+	return row;
+}
+
+void
+CarrierPowerRing::pop_front()
+{
+	assert(size_ > 0);
+	head_ = (head_ + 1) & (nodes_.size() - 1);
+	size_--;
+}
+
+void
+CarrierPowerRing::grow()
+{
+	std::vector<CarrierPowerNode> bigger(nodes_.size() * 2);
+	std::vector<double> bigger_power(bigger.size() * MAX_CARRIERS);
+	for (size_t i = 0; i < size_; i++) {
+		bigger[i] = (*this)[i];
+		std::copy(carriers(i), carriers(i) + MAX_CARRIERS,
+				&bigger_power[i * MAX_CARRIERS]);
+	}
+	nodes_.swap(bigger);
+	carrier_power_.swap(bigger_power);
+	head_ = 0;
+}
+
 void EndInterfTimerOFDM::handle(Event *e)
 {
 
-	EndInterfEvent *ee = (EndInterfEvent *)e;
-	interference->removeFromInterference(ee->power, ee->type, ee->carrier_power);
+	EndInterfEventOFDM *ee = (EndInterfEventOFDM *)e;
+	interference->removeFromInterference(
+			ee->power, ee->type, ee->carriers, ee->carrier_pw);
 	delete ee;
 }
 
@@ -98,7 +155,7 @@ int uwinterferenceofdm::command(int argc, const char *const *argv)
 			return TCL_OK;
 		}
 	}
-	return uwinterferenceofdm::command(argc, argv);
+	return uwinterference::command(argc, argv);
 }
 
 void uwinterferenceofdm::addToInterference(Packet *p)
@@ -106,20 +163,7 @@ void uwinterferenceofdm::addToInterference(Packet *p)
 	hdr_MPhy *ph = HDR_MPHY(p);
 	hdr_mac *mach = HDR_MAC(p);
 	hdr_OFDM *ofdmph = HDR_OFDM(p);
-	std::vector<double> car_power;
-	int used_carriers = 0;
-
-	// Check how many carriers are effectively used
-	for (int i = 0; i < ofdmph->carrierNum; i++)
-	{
-		used_carriers += ofdmph->carriers[i];
-	}
-
-	// For each used carrier fill with associated power
-	for (int i = 0; i < ofdmph->carrierNum; i++)
-	{
-		car_power.push_back(ph->Pr / used_carriers * ofdmph->carriers[i]);
-	}
+	double car_power = getCarrierPower(ph->Pr, ofdmph->carriers);
 	bool ctrl_pkt = (mach->ftype() == MF_CTS || mach->ftype() == MF_RTS || mach->ftype() == MF_ACK );  
 
 	if (ctrl_pkt) {
@@ -127,7 +171,8 @@ void uwinterferenceofdm::addToInterference(Packet *p)
 		if (debug_)
 			std::cout << NOW << " uwinterference::addToInterference() CTRL packet" << std::endl;
 		addToInterference(ph->Pr, CTRL, ofdmph->carriers, ofdmph->carrierNum);
-		EndInterfEvent *ee = new EndInterfEvent(ph->Pr, CTRL, car_power);
+		EndInterfEventOFDM *ee = new EndInterfEventOFDM(
+				ph->Pr, CTRL, ofdmph->carriers, car_power);
 		// EPSILON_TIME needed to avoid the scheduling of simultaneous events
 		Scheduler::instance().schedule(
 			&end_timerOFDM, ee, ph->duration - EPSILON_TIME);
@@ -137,78 +182,55 @@ void uwinterferenceofdm::addToInterference(Packet *p)
 		if (debug_)
 			std::cout << NOW << " uwinterference::addToInterference() DATA packet" << std::endl;
 		addToInterference(ph->Pr, DATA, ofdmph->carriers, ofdmph->carrierNum);
-		EndInterfEvent *ee = new EndInterfEvent(ph->Pr, DATA, car_power);
+		EndInterfEventOFDM *ee = new EndInterfEventOFDM(
+				ph->Pr, DATA, ofdmph->carriers, car_power);
 		// EPSILON_TIME needed to avoid the scheduling of simultaneous events
 		Scheduler::instance().schedule(
 			&end_timerOFDM, ee, ph->duration - EPSILON_TIME);
 	}
 }
 
-void uwinterferenceofdm::addToInterference(double pw, PKT_TYPE tp, int *carriers, int carNum)
+void
+uwinterferenceofdm::purgeOldSamples()
 {
-	std::vector<double> car_power;
-	int used_carriers = 0;
-
-	// Check how many carriers are effectively used
-	for (int i = 0; i < carNum; i++)
-	{
-		used_carriers += carriers[i];
+	if (use_maxinterval_) {
+		while (!power_list.empty() &&
+				power_list.front().time < NOW - maxinterval_)
+			power_list.pop_front();
 	}
+}
 
-	// For each used carrier fill with associated power
-	for (int i = 0; i < carNum; i++)
-	{
-		car_power.push_back(pw / used_carriers * carriers[i]);
-	}
+void uwinterferenceofdm::addToInterference(double pw, PKT_TYPE tp, ofdm_carriers_t carriers, int carNum)
+{
+	double car_power = getCarrierPower(pw, carriers);
 
-	if (use_maxinterval_) {
+	purgeOldSamples();
 
-		std::list<ListNodeOFDM>::iterator it;
-		for (it = power_list.begin(); it != power_list.end();)
-		{
-			if (it->time < NOW - maxinterval_) {
-				it = power_list.erase(it); // Side effect: it++
-			} else
-				break;
-		}
+	double power_temp = 0;
+	int ctrl_temp = 0;
+	int data_temp = 0;
+	if (!power_list.empty()) {
+		power_temp = power_list.back().sum_power;
+		ctrl_temp = power_list.back().ctrl_cnt;
+		data_temp = power_list.back().data_cnt;
 	}
 
-	if (power_list.empty()) {
-
-		if (tp == CTRL) {
-			ListNodeOFDM pn(NOW, pw, 1, 0, car_power);
-			power_list.push_back(pn);
-		} else {
-			ListNodeOFDM pn(NOW, pw, 0, 1, car_power);
-			power_list.push_back(pn);
-		}
-	} else {
+	double *row;
+	if (tp == CTRL)
+		row = power_list.push_back(NOW, pw + power_temp, ctrl_temp + 1, data_temp);
+	else
+		row = power_list.push_back(NOW, pw + power_temp, ctrl_temp, data_temp + 1);
 
-		double power_temp = power_list.back().sum_power;
-		int ctrl_temp = power_list.back().ctrl_cnt;
-		int data_temp = power_list.back().data_cnt;
-		std::vector<double> car_pwr_old = power_list.back().carrier_power;
+	// For each used carrier add the associated power
+	for (int i = 0; i < carNum; i++)
+		row[i] += car_power * ((carriers >> i) & 1);
 
+	if (debug_) {
 		string carPwr = "CarrierPower_Vector = [";
-
-		for (int i = 0; i < car_pwr_old.size(); i++)
-		{
-			car_power.at(i) += car_pwr_old.at(i);
-			carPwr += (std::to_string(car_power.at(i)) + ", ");
-		}
+		for (int i = 0; i < carNum; i++)
+			carPwr += (std::to_string(row[i]) + ", ");
 		carPwr += "]";
-
-		if (debug_)
-			std::cout << NOW << " uwinterference::addToInterference() " << carPwr << std::endl;
-
-		if (tp == CTRL)
-		{
-			ListNodeOFDM pn(NOW, pw + power_temp, ctrl_temp + 1, data_temp, car_power);
-			power_list.push_back(pn);
-		} else {
-			ListNodeOFDM pn(NOW, pw + power_temp, ctrl_temp, data_temp + 1, car_power);
-			power_list.push_back(pn);
-		}
+		std::cout << NOW << " uwinterference::addToInterference() " << carPwr << std::endl;
 	}
 
 	if (debug_)
@@ -221,20 +243,9 @@ void uwinterferenceofdm::addToInterference(double pw, PKT_TYPE tp, int *carriers
 	}
 }
 
-void uwinterferenceofdm::removeFromInterference(double pw, PKT_TYPE tp, const std::vector<double> &carPwr)
+void uwinterferenceofdm::removeFromInterference(double pw, PKT_TYPE tp, ofdm_carriers_t carriers, double carrier_pw)
 {
-	if (use_maxinterval_) {
-		std::list<ListNodeOFDM>::iterator it;
-
-		for (it = power_list.begin(); it != power_list.end();)
-		{
-			if (it->time < NOW - maxinterval_) {
-				it = power_list.erase(it); // Side effect: it++
-			}
-			else
-				break;
-		}
-	}
+	purgeOldSamples();
 
 	if (power_list.empty()) {
 
@@ -245,11 +256,22 @@ void uwinterferenceofdm::removeFromInterference(double pw, PKT_TYPE tp, const st
 		double power_temp = power_list.back().sum_power;
 		int ctrl_temp = power_list.back().ctrl_cnt;
 		int data_temp = power_list.back().data_cnt;
-		std::vector<double> car_pwr_old = power_list.back().carrier_power;
-		std::vector<double> car_pwr_new;
-		for (std::size_t i = 0; i < car_pwr_old.size(); ++i)
+
+		// NOW+EPSILON_TIME to compensate the early scheduling in
+		// addToInterference(Packet* p)
+		double *row;
+		if (tp == CTRL)
+			row = power_list.push_back(NOW + EPSILON_TIME,
+					power_temp - pw, ctrl_temp - 1, data_temp);
+		else
+			row = power_list.push_back(NOW + EPSILON_TIME,
+					power_temp - pw, ctrl_temp, data_temp - 1);
+
+		for (int i = 0; i < MAX_CARRIERS; i++)
 		{
-			double tempPwr = car_pwr_old[i] - carPwr[i];
+			if (!((carriers >> i) & 1))
+				continue;
+			double tempPwr = row[i] - carrier_pw;
 			if (tempPwr < 0)
 			{
 				if (tempPwr < -0.001)
@@ -257,26 +279,7 @@ void uwinterferenceofdm::removeFromInterference(double pw, PKT_TYPE tp, const st
 					<< tempPwr << ") car " << i << std::endl;
 				tempPwr = 0;
 			}
-			car_pwr_new.push_back(tempPwr);
-		}
-
-		if (tp == CTRL) {
-			// NOW+EPSILON_TIME to compensate the early scheduling in
-			// addToInterference(Packet* p)
-			ListNodeOFDM pn(NOW + EPSILON_TIME,
-							power_temp - pw,
-							ctrl_temp - 1,
-							data_temp, car_pwr_new);
-			power_list.push_back(pn);
-		} else {
-
-			// NOW+EPSILON_TIME to compensate the early scheduling in
-			// addToInterference(Packet* p)
-			ListNodeOFDM pn(NOW + EPSILON_TIME,
-							power_temp - pw,
-							ctrl_temp,
-							data_temp - 1, car_pwr_new);
-			power_list.push_back(pn);
+			row[i] = tempPwr;
 		}
 	}
 	if (debug_) {
@@ -314,45 +317,37 @@ uwinterferenceofdm::getInterferencePower(Packet *p)
 
 double
 uwinterferenceofdm::getInterferencePower(
-	double power, double starttime, double duration, int *carriers, int ncarriers)
+	double power, double starttime, double duration, ofdm_carriers_t carriers, int ncarriers)
 {
-	std::list<ListNodeOFDM>::reverse_iterator rit;
-
-	std::vector<double> car_pwr;
-
+	// Energy per carrier over the window, integrated row by row so that
+	// the inner loop runs on contiguous memory
+	double car_energy[MAX_CARRIERS] = {0};
 	double integral = 0;
-	double car_integral = 0;
-	double car_power = 0;
 	double lasttime = NOW;
 	assert(starttime <= NOW);
 	assert(duration > 0);
 
-	for (rit = power_list.rbegin(); rit != power_list.rend(); ++rit)
+	for (size_t k = power_list.size(); k-- > 0;)
 	{
-		car_power = 0;
-		if (starttime < rit->time)
-		{
-			integral += rit->sum_power * (lasttime - rit->time);
-
-			// for each carrier add interf pwr if carrier is used
-			for (int i = 0; i < rit->carrier_power.size(); i++)
-			{
-				car_power += carriers[i] * rit->carrier_power.at(i);
-			}
+		const CarrierPowerNode &node = power_list[k];
+		const double *row = power_list.carriers(k);
+		bool last = !(starttime < node.time);
+		double dt = lasttime - (last ? starttime : node.time);
 
-			car_integral += car_power * (lasttime - rit->time);
-			lasttime = rit->time;
-		} else {
+		integral += node.sum_power * dt;
+		for (int i = 0; i < MAX_CARRIERS; i++)
+			car_energy[i] += row[i] * dt;
 
-			integral += rit->sum_power * (lasttime - starttime);
-			for (int i = 0; i < rit->carrier_power.size(); i++)
-			{
-				car_power += carriers[i] * rit->carrier_power.at(i);
-			}
-			car_integral += car_power * (lasttime - starttime);
+		if (last)
 			break;
-		}
+		lasttime = node.time;
 	}
+
+	// Add interf pwr of each carrier used by the packet
+	double car_integral = 0;
+	for (int i = 0; i < MAX_CARRIERS; i++)
+		car_integral += ((carriers >> i) & 1) * car_energy[i];
+
 	double interference = (integral / duration) - power;
 	double ofdminterference = (car_integral / duration) - power;
 	if(interference < (ofdminterference - 1))
@@ -406,10 +401,10 @@ uwinterferenceofdm::getCurrentTotalPower()
 double
 uwinterferenceofdm::getCurrentTotalPowerOnCarrier(int carrier)
 {
-	if (power_list.empty())
+	if (power_list.empty() || carrier < 0 || carrier >= MAX_CARRIERS)
 		return 0.0;
 	else
-		return (power_list.back().carrier_power.at(carrier));
+		return (power_list.carriers(power_list.size() - 1)[carrier]);
 }
 
 double
@@ -423,23 +418,22 @@ uwinterferenceofdm::getTimeOverlap(Packet *p)
 double
 uwinterferenceofdm::getTimeOverlap(double starttime, double duration)
 {
-	std::list<ListNodeOFDM>::reverse_iterator rit;
-
 	double overlap = 0;
 	double lasttime = NOW;
 	assert(starttime <= NOW);
 	assert(duration > 0);
 
-	for (rit = power_list.rbegin(); rit != power_list.rend(); ++rit)
+	for (size_t k = power_list.size(); k-- > 0;)
 	{
-		if (starttime < rit->time) {
+		const CarrierPowerNode &node = power_list[k];
+		if (starttime < node.time) {
 
-			if (rit->ctrl_cnt > 1 || rit->data_cnt > 1) {
-				overlap += (lasttime - rit->time);
+			if (node.ctrl_cnt > 1 || node.data_cnt > 1) {
+				overlap += (lasttime - node.time);
 			}
-			lasttime = rit->time;
+			lasttime = node.time;
 		} else {
-			if (rit->ctrl_cnt > 1 || rit->data_cnt > 1) {
+			if (node.ctrl_cnt > 1 || node.data_cnt > 1) {
 				overlap += (lasttime - starttime);
 			}
 			break;
@@ -465,32 +459,33 @@ uwinterferenceofdm::getCounters(Packet *p)
 counter
 uwinterferenceofdm::getCounters(double starttime, double duration, PKT_TYPE tp)
 {
-	std::list<ListNodeOFDM>::reverse_iterator rit;
-
 	int ctrl_pkts = 0;
 	int data_pkts = 0;
 
 	assert(starttime <= NOW);
 	assert(duration > 0);
 
-	rit = power_list.rbegin();
-	int last_ctrl_cnt = rit->ctrl_cnt;
-	int last_data_cnt = rit->data_cnt;
-	rit++;
-	for (; rit != power_list.rend(); ++rit)
+	if (power_list.empty())
+		return counter(0, 0);
+
+	size_t k = power_list.size() - 1;
+	int last_ctrl_cnt = power_list[k].ctrl_cnt;
+	int last_data_cnt = power_list[k].data_cnt;
+	while (k-- > 0)
 	{
-		if (starttime < rit->time) {
-			if (last_ctrl_cnt - rit->ctrl_cnt >= 0) {
-				ctrl_pkts += last_ctrl_cnt - rit->ctrl_cnt;
+		const CarrierPowerNode &node = power_list[k];
+		if (starttime < node.time) {
+			if (last_ctrl_cnt - node.ctrl_cnt >= 0) {
+				ctrl_pkts += last_ctrl_cnt - node.ctrl_cnt;
 			}
-			if (last_data_cnt - rit->data_cnt >= 0) {
-				data_pkts += last_data_cnt - rit->data_cnt;
+			if (last_data_cnt - node.data_cnt >= 0) {
+				data_pkts += last_data_cnt - node.data_cnt;
 			}
-			last_ctrl_cnt = rit->ctrl_cnt;
-			last_data_cnt = rit->data_cnt;
+			last_ctrl_cnt = node.ctrl_cnt;
+			last_data_cnt = node.data_cnt;
 		} else {
-			ctrl_pkts += rit->ctrl_cnt;
-			data_pkts += rit->data_cnt;
+			ctrl_pkts += node.ctrl_cnt;
+			data_pkts += node.data_cnt;
 			break;
 		}
 	}
@@ -509,3 +504,26 @@ uwinterferenceofdm::getCounters(double starttime, double duration, PKT_TYPE tp)
 
 	return counter(ctrl_pkts, data_pkts);
 }
+
+InterferenceSummary
+uwinterferenceofdm::getInterferenceSummary(Packet *p)
+{
+	InterferenceSummary summary;
+	summary.power = getInterferencePower(p);
+	summary.overlap = getTimeOverlap(p);
+	summary.counters = getCounters(p);
+	return summary;
+}
+
+InterferenceSummary
+uwinterferenceofdm::getInterferenceSummary(
+		double power, double starttime, double duration, PKT_TYPE tp)
+{
+	InterferenceSummary summary;
+	ofdm_carriers_t all_carriers = ~ofdm_carriers_t(0) >> (64 - MAX_CARRIERS);
+	summary.power = getInterferencePower(
+			power, starttime, duration, all_carriers, MAX_CARRIERS);
+	summary.overlap = getTimeOverlap(starttime, duration);
+	summary.counters = getCounters(starttime, duration, tp);
+	return summary;
+}
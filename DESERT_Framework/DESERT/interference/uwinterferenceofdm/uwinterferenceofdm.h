@@ -50,34 +50,135 @@ typedef std::pair<int, int> counter; /**< counter of collisions */
 
 class uwinterferenceofdm;
 
-class ListNodeOFDM : public ListNode
+/**
+ * Sample of the multicarrier interference timeline. The power on each
+ * carrier is kept by CarrierPowerRing in a separate row.
+ */
+class CarrierPowerNode
 {
 public:
-	std::vector<double> carrier_power;
+	double time; /** time of the sample */
+	double sum_power; /** sum of the rx power in the node at the given time*/
+	int ctrl_cnt; /** control packet counter */
+	int data_cnt; /** data packet counter */
+};
 
+/**
+ * Contiguous ring buffer of the multicarrier interference timeline. Sample i
+ * is a CarrierPowerNode plus a row of MAX_CARRIERS powers in a single
+ * time x carrier matrix, so that the per-carrier loops run on contiguous
+ * memory and appending or removing a sample does not allocate.
+ */
+class CarrierPowerRing
+{
+public:
+	/**
+	 * Constructor of the class CarrierPowerRing
+	 */
+	CarrierPowerRing();
 
 	/**
-	 * Constructor of the class ListNode when used with multicarrier
-	 * @param t time
-	 * @param sum_pw sum of the rx power in the node at the given time
-	 * @param ctrl  control packet counter
+	 * Appends a sample to the timeline. Its carrier powers are a copy of
+	 * the ones of the last sample, or zero if the timeline is empty.
+	 * @param t time of the sample
+	 * @param sum_pw sum of the rx power at the given time
+	 * @param ctrl control packet counter
 	 * @param data data packet counter
+	 * @return the carrier powers of the new sample
+	 */
+	double *push_back(double t, double sum_pw, int ctrl, int data);
+
+	/**
+	 * Removes the oldest sample of the timeline
+	 */
+	void pop_front();
+
+	inline size_t
+	size() const
+	{
+		return size_;
+	}
+
+	inline bool
+	empty() const
+	{
+		return size_ == 0;
+	}
+
+	inline CarrierPowerNode &
+	operator[](size_t i)
+	{
+		return nodes_[(head_ + i) & (nodes_.size() - 1)];
+	}
+
+	inline const CarrierPowerNode &
+	operator[](size_t i) const
+	{
+		return nodes_[(head_ + i) & (nodes_.size() - 1)];
+	}
+
+	inline CarrierPowerNode &
+	front()
+	{
+		return (*this)[0];
+	}
+
+	inline CarrierPowerNode &
+	back()
+	{
+		return (*this)[size_ - 1];
+	}
+
+	/**
+	 * Returns the MAX_CARRIERS carrier powers of sample i
 	 */
-	ListNodeOFDM(double t, double sum_pw, int ctrl, int data, const std::vector<double>& carPwr): 
-	carrier_power(carPwr)
+	inline const double *
+	carriers(size_t i) const
+	{
+		return &carrier_power_[((head_ + i) & (nodes_.size() - 1)) * MAX_CARRIERS];
+	}
+
+	inline double *
+	carriers(size_t i)
 	{
-		time = t;
-		sum_power = sum_pw;
-		ctrl_cnt = ctrl;
-		data_cnt = data;		
+		return &carrier_power_[((head_ + i) & (nodes_.size() - 1)) * MAX_CARRIERS];
 	}
 
+protected:
+	/**
+	 * Doubles the capacity of the buffer, keeping the samples in order
+	 */
+	void grow();
+
+	std::vector<CarrierPowerNode> nodes_; /**< Samples, size is a power of 2 */
+	std::vector<double> carrier_power_; /**< nodes_.size() x MAX_CARRIERS powers */
+	size_t head_; /**< Index of the oldest sample */
+	size_t size_; /**< Number of samples */
+};
+
+/**
+ * End of an OFDM interferer: the power is spread evenly on the carriers of
+ * the mask, so the carrier powers do not need to be stored
+ */
+class EndInterfEventOFDM : public EndInterfEvent
+{
+public:
 	/**
-	 * Destructor of the class ListNode
+	 * Constructor of the class EndInterfEventOFDM
+	 * @param pw Received power of the current packet
+	 * @param tp type of the packet (DATA or CTRL)
+	 * @param car bitmask of carriers used by the packet
+	 * @param car_pw power on each used carrier
 	 */
-	virtual ~ListNodeOFDM()
+	EndInterfEventOFDM(double pw, PKT_TYPE tp, ofdm_carriers_t car, double car_pw)
+		: EndInterfEvent(pw, tp)
+		, carriers(car)
+		, carrier_pw(car_pw)
 	{
 	}
+
+	ofdm_carriers_t carriers;
+	double carrier_pw;
 };
 
 class EndInterfTimerOFDM : public Handler
@@ -128,16 +229,18 @@ public:
 	 * Add a packet to the interference calculation
 	 * @param pw Received power of the current packet
 	 * @param type type of the packet (DATA or CTRL)
-	 * @param carriers vector of carriers used in that packet
+	 * @param carriers bitmask of carriers used in that packet
 	 * @param carNum explicit number of carriers
 	 */
-	virtual void addToInterference(double pw, PKT_TYPE tp, int* carriers, int carNum);
+	virtual void addToInterference(double pw, PKT_TYPE tp, ofdm_carriers_t carriers, int carNum);
 	/**
 	 * Remove a packet to the interference calculation
 	 * @param pw Received power of the current packet
 	 * @param type type of the packet (DATA or CTRL)
+	 * @param carriers bitmask of carriers used in that packet
+	 * @param carrier_pw power of the packet on each used carrier
 	 */
-	virtual void removeFromInterference(double pw, PKT_TYPE tp, const std::vector<double>& carPwr);
+	virtual void removeFromInterference(double pw, PKT_TYPE tp, ofdm_carriers_t carriers, double carrier_pw);
 	/**
 	 * Compute the average interference power for the given packet
 	 * @param p Pointer to the interferer packet
@@ -152,7 +255,7 @@ public:
 	 * @return average interference power
 	 */
 	virtual double getInterferencePower(
-			double power, double starttime, double duration, int* carriers, int ncar);
+			double power, double starttime, double duration, ofdm_carriers_t carriers, int ncar);
 	/**/
 	virtual double getCurrentTotalPower();
 	/**
@@ -190,6 +293,25 @@ public:
 	 * @return counter variable that represent the counters of the interference
 	 */
 	virtual counter getCounters(double starttime, double duration, PKT_TYPE tp);
+	/**
+	 * Returns interference power, overlap and counters of collisions
+	 * computed on the multicarrier power list
+	 * @param p Pointer of the packet for which the values are needed
+	 * @return power, overlap and counters of the interference
+	 */
+	virtual InterferenceSummary getInterferenceSummary(Packet *p);
+	/**
+	 * Returns interference power, overlap and counters of collisions
+	 * computed on the multicarrier power list, for a packet that uses all
+	 * the carriers
+	 * @param power Received power of the current packet
+	 * @param starttime timestamp of the start of reception phase
+	 * @param duration duration of the reception phase
+	 * @param type type of the packet (DATA or CTRL)
+	 * @return power, overlap and counters of the interference
+	 */
+	virtual InterferenceSummary getInterferenceSummary(
+			double power, double starttime, double duration, PKT_TYPE tp);
 
 	/**
 	 * @return number of carriers used by the node
@@ -237,8 +359,25 @@ public:
 	}
 
 protected:
+	/**
+	 * Removes the samples older than maxinterval_, if use_maxinterval_ is set
+	 */
+	void purgeOldSamples();
+
+	/**
+	 * Power of a packet on each of its carriers
+	 * @param pw Received power of the packet
+	 * @param carriers bitmask of carriers used in that packet
+	 * @return pw split evenly on the used carriers, 0 if there are none
+	 */
+	static inline double
+	getCarrierPower(double pw, ofdm_carriers_t carriers)
+	{
+		int used_carriers = __builtin_popcountll(carriers);
+		return used_carriers > 0 ? pw / used_carriers : 0;
+	}
 
-	std::list<ListNodeOFDM> power_list; /**<List with power and counters*/
+	CarrierPowerRing power_list; /**< Timeline with power and counters*/
 	EndInterfTimerOFDM end_timerOFDM; /**< Timer for schedules end of interference for a transmission */
 	int inodeID; /* ID of the node */
 
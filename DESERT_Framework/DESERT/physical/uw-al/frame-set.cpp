@@ -96,17 +96,26 @@ RxFrameSet::RxFrameSet()
 {
 
 	memset(binPayload_, '\0', MAX_BIN_PAYLOAD_ARRAY_LENGTH);
+	reset(RxFrameSetKey());
+}
+
+RxFrameSet::~RxFrameSet()
+{
+}
+
+void
+RxFrameSet::reset(const RxFrameSetKey &key)
+{
+	// binPayload_ is only read up to tot_length_ once every byte has been
+	// received, so only the bitmap needs to be cleared
 	memset(binPayloadCheck_, '\0', MAX_BIN_PAYLOAD_CHECK_ARRAY_LENGTH);
+	key_ = key;
 	tot_length_ = -1;
 	curr_length_ = 0;
 	t_last_rx_frame_ = 0;
 	error_ = false;
 }
 
-RxFrameSet::~RxFrameSet()
-{
-}
-
 std::string
 RxFrameSet::displaySet()
 {
@@ -147,8 +156,8 @@ RxFrameSet::binPayload(bool extract) const
 }
 
 void
-RxFrameSet::UpdateRxFrameSet(
-		char *frame, size_t offset, size_t length, int tot_length, double time)
+RxFrameSet::UpdateRxFrameSet(const char *frame, size_t offset, size_t length,
+		int tot_length, double time)
 {
 
 	if (offset + length > MAX_BIN_PAYLOAD_ARRAY_LENGTH) {
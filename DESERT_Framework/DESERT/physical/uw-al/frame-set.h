@@ -45,12 +45,13 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <limits.h>
 #include "stdint.h"
 
 #define MAX_BIN_PAYLOAD_ARRAY_LENGTH 2240
 
 #define MAX_BIN_PAYLOAD_CHECK_ARRAY_LENGTH \
-	((MAX_BIN_PAYLOAD_ARRAY_LENGTH + sizeof(char) - 1) / sizeof(char))
+	((MAX_BIN_PAYLOAD_ARRAY_LENGTH + CHAR_BIT - 1) / CHAR_BIT)
 
 
 
@@ -61,7 +62,7 @@ class RxFrameSetKey
 	unsigned int pktID_; /**< ID of the packet. */
 
 public:
-	RxFrameSetKey(uint8_t, unsigned int);
+	RxFrameSetKey(uint8_t = 0, unsigned int = 0);
 
 	~RxFrameSetKey();
 
@@ -83,6 +84,15 @@ public:
 		return pktID_;
 	}
 
+	/**
+	 * Return a value identifying the key, to be used in hash tables.
+	 */
+	inline uint64_t
+	value() const
+	{
+		return ((uint64_t) srcID_ << 32) | pktID_;
+	}
+
 	bool operator<(RxFrameSetKey) const;
 
 	std::string displayKey() const;
@@ -95,8 +105,9 @@ class RxFrameSet
 													   binary data received
 													   as frames. */
 	char binPayloadCheck_
-			[MAX_BIN_PAYLOAD_CHECK_ARRAY_LENGTH]; /**< array to count already
-													 received frames. */
+			[MAX_BIN_PAYLOAD_CHECK_ARRAY_LENGTH]; /**< bitmap of the bytes
+													 already received. */
+	RxFrameSetKey key_; /**< Key of the packet being reassembled. */
 	int tot_length_;
 	size_t curr_length_;
 	double t_last_rx_frame_;
@@ -107,6 +118,31 @@ public:
 
 	~RxFrameSet();
 
+	/**
+	 * Prepare the frame set to reassemble a new packet.
+	 *
+	 * @param key key of the packet to reassemble.
+	 */
+	void reset(const RxFrameSetKey &key);
+
+	/**
+	 * Return the key of the packet being reassembled.
+	 */
+	inline const RxFrameSetKey &
+	key() const
+	{
+		return key_;
+	}
+
+	/**
+	 * Return true if all the bytes of the packet have been received.
+	 */
+	inline bool
+	complete() const
+	{
+		return tot_length_ > -1 && (size_t) tot_length_ == curr_length_;
+	}
+
 	/**
 	 * Reference to the tot_length_ variable.
 	 */
@@ -162,7 +198,7 @@ public:
 	 */
 	std::string binPayload(bool) const;
 
-	void UpdateRxFrameSet(char *, size_t, size_t, int, double);
+	void UpdateRxFrameSet(const char *, size_t, size_t, int, double);
 
 	std::string displaySet();
 };
@@ -37,10 +37,125 @@
 
 #include "hdr-uwal.h"
 
+#include <cstring>
+
 packet_t PT_UWAL;
 
 int hdr_uwal::offset_;
 
+std::vector<UwalBuffer *> UwalBuffer::pool_;
+
+unsigned long UwalBuffer::allocated_ = 0;
+
+unsigned long UwalData::created_ = 0;
+
+UwalBuffer *
+UwalBuffer::acquire()
+{
+	UwalBuffer *b;
+	if (pool_.empty()) {
+		b = new UwalBuffer();
+		allocated_++;
+	} else {
+		b = pool_.back();
+		pool_.pop_back();
+	}
+	memset(b->binPkt, '\0', MAX_BIN_PKT_ARRAY_LENGTH);
+	memset(b->dummyStr, '\0', MAX_DUMMY_STRING_LENGTH);
+	b->refs_ = 1;
+	return b;
+}
+
+void
+UwalBuffer::release(UwalBuffer *b)
+{
+	if (--b->refs_ == 0)
+		pool_.push_back(b);
+}
+
+const UwalBuffer &
+UwalBuffer::empty()
+{
+	static const UwalBuffer *zero = acquire();
+	return *zero;
+}
+
+UwalBuffer *
+UwalData::writable()
+{
+	if (buf_->shared()) {
+		UwalBuffer *b = UwalBuffer::acquire();
+		memcpy(b->binPkt, buf_->binPkt, MAX_BIN_PKT_ARRAY_LENGTH);
+		memcpy(b->dummyStr, buf_->dummyStr, MAX_DUMMY_STRING_LENGTH);
+		UwalBuffer::release(buf_);
+		buf_ = b;
+	}
+	return buf_;
+}
+
+void
+UwalData::reset()
+{
+	if (buf_->shared()) {
+		UwalBuffer::release(buf_);
+		buf_ = UwalBuffer::acquire();
+	} else {
+		memset(buf_->binPkt, '\0', MAX_BIN_PKT_ARRAY_LENGTH);
+		memset(buf_->dummyStr, '\0', MAX_DUMMY_STRING_LENGTH);
+	}
+}
+
+/**
+ * Attaches a new UwalData to the packet, keeping its data area as upper
+ * data.
+ */
+static UwalData *
+attachBin(Packet *p)
+{
+	UwalData *d = new UwalData(UwalBuffer::acquire(), p->userdata());
+	// the data area moves into d: detach it without deleting it
+	p->initdata();
+	p->setdata(d);
+	return d;
+}
+
+UwalBuffer *
+hdr_uwal::writable(Packet *p)
+{
+	UwalData *d = data(p);
+	if (d == NULL)
+		d = attachBin(p);
+	return d->writable();
+}
+
+void
+hdr_uwal::resetBin(Packet *p)
+{
+	UwalData *d = data(p);
+	if (d == NULL)
+		attachBin(p);
+	else
+		d->reset();
+}
+
+void
+hdr_uwal::setUpperData(Packet *p, AppData *upper)
+{
+	UwalData *d = data(p);
+	if (d != NULL)
+		d->setUpper(upper);
+	else if (upper != p->userdata())
+		p->setdata(upper);
+}
+
+void
+hdr_uwal::detachBin(Packet *p)
+{
+	UwalData *d = data(p);
+	if (d != NULL)
+		p->setdata(d->releaseUpper());
+}
+
 static class HdrUwalClass : public PacketHeaderClass
 {
 public:
@@ -40,12 +40,171 @@
 
 #include <packet.h>
 
+#include <vector>
+
 #define HDR_UWAL(p) (hdr_uwal::access(p))
 #define MAX_BIN_PKT_ARRAY_LENGTH 2240
 #define MAX_DUMMY_STRING_LENGTH 2240
 
 extern packet_t PT_UWAL;
 
+/**
+ * Pooled buffer with the binary data of an Uwal packet, shared by reference
+ * counting among the copies of the packet.
+ */
+class UwalBuffer
+{
+public:
+	/**
+	 * Returns a zeroed buffer, with one reference, taken from the pool.
+	 */
+	static UwalBuffer *acquire();
+
+	/**
+	 * Drops a reference to the buffer, which goes back to the pool when
+	 * no packet refers to it anymore.
+	 */
+	static void release(UwalBuffer *b);
+
+	/**
+	 * Returns a zeroed buffer for the packets with no binary data.
+	 */
+	static const UwalBuffer &empty();
+
+	inline void
+	retain()
+	{
+		refs_++;
+	}
+
+	inline bool
+	shared() const
+	{
+		return refs_ > 1;
+	}
+
+	/**
+	 * Returns the number of buffers allocated so far, i.e., the number of
+	 * times the pool was found empty.
+	 */
+	static inline unsigned long
+	allocated()
+	{
+		return allocated_;
+	}
+
+	char binPkt[MAX_BIN_PKT_ARRAY_LENGTH]; /**< binary data as encoded from or
+											  to be decoded to the packet. */
+	char dummyStr[MAX_DUMMY_STRING_LENGTH]; /**< dummy string. */
+
+private:
+	UwalBuffer()
+		: refs_(0)
+	{
+	}
+
+	unsigned int refs_; /**< Number of packets referring to the buffer. */
+	static std::vector<UwalBuffer *> pool_; /**< Buffers not in use. */
+	static unsigned long allocated_; /**< Number of buffers allocated. */
+};
+
+/**
+ * Payload of a packet pointing to its UwalBuffer. ns-2 copies it in
+ * Packet::copy() and deletes it in Packet::free(), so the copies of a packet
+ * share the buffer until one of them writes to it.
+ * A packet has a single data area: the one it had above UW-AL, if any, is
+ * kept by its UwalData as upper data, and given back when the packet is
+ * sent up.
+ */
+class UwalData : public AppData
+{
+public:
+	UwalData(UwalBuffer *b, AppData *upper = NULL)
+		: AppData(PACKET_DATA)
+		, buf_(b)
+		, upper_(upper)
+	{
+		created_++;
+	}
+
+	virtual ~UwalData()
+	{
+		UwalBuffer::release(buf_);
+		delete upper_;
+	}
+
+	virtual AppData *
+	copy()
+	{
+		buf_->retain();
+		return new UwalData(buf_, upper_ ? upper_->copy() : NULL);
+	}
+
+	/**
+	 * Returns the data area of the packet above UW-AL, NULL if none.
+	 */
+	inline AppData *
+	upper() const
+	{
+		return upper_;
+	}
+
+	/**
+	 * Replaces the data area of the packet above UW-AL, deleting the
+	 * current one.
+	 */
+	inline void
+	setUpper(AppData *upper)
+	{
+		if (upper != upper_) {
+			delete upper_;
+			upper_ = upper;
+		}
+	}
+
+	/**
+	 * Returns the data area of the packet above UW-AL, which the caller
+	 * then owns.
+	 */
+	inline AppData *
+	releaseUpper()
+	{
+		AppData *u = upper_;
+		upper_ = NULL;
+		return u;
+	}
+
+	inline const UwalBuffer *
+	buffer() const
+	{
+		return buf_;
+	}
+
+	/**
+	 * Returns the buffer for writing, copying it first if it is shared.
+	 */
+	UwalBuffer *writable();
+
+	/**
+	 * Zeroes the buffer, replacing it with a new one if it is shared.
+	 */
+	void reset();
+
+	/**
+	 * Returns the number of UwalData created so far.
+	 */
+	static inline unsigned long
+	created()
+	{
+		return created_;
+	}
+
+private:
+	UwalBuffer *buf_; /**< Buffer with the binary data of the packet. */
+	AppData *upper_; /**< Data area of the packet above UW-AL. */
+	static unsigned long created_; /**< Number of UwalData created. */
+};
+
 /**
  * <i>hdr_uwal</i> describes the packet header used by <i>Uwal</i> objects.
  */
@@ -72,19 +231,10 @@ typedef struct hdr_uwal {
 	uint8_t Mbit_; /**< M bit: if set to 0 the current frame is the last or the
 					  only one; if set to 1 the current frame is not the last.
 					  */
-	char dummyStr_[MAX_DUMMY_STRING_LENGTH]; /**< array containing a dummy
-												string. */
-
-	// Fields to handle only locally (actually, this is the information to be
-	// sent over and retrieved from the channel ad modem payload...)
-	char binPkt_[MAX_BIN_PKT_ARRAY_LENGTH]; /**< array to store binary data
-											   as encoded from or to be
-											   decoded to this NS-Miracle
-											   packet header (NOTE: this
-											   CANNOT be fragmented) and the
-											   active packers linked to
-											   packer. @see classes packer
-											   and uwmphy_modem */
+	// The dummy string and the binary data (i.e., the information to be sent
+	// over and retrieved from the channel as modem payload) are kept out of
+	// the header, in the UwalBuffer of the packet. @see classes packer and
+	// uwmphy_modem
 	uint32_t binPktLength_; /**< number of chars in binPkt_ to consider. */
 	uint32_t binHdrLength_; /**< number of chars in binPkt_ to consider as
 							   header. */
@@ -126,21 +276,85 @@ typedef struct hdr_uwal {
 	}
 
 	/**
-	 * Return the pointer to the dummyStr_ array.
+	 * Return the UwalData of the packet, NULL if it has no binary data.
+	 */
+	static inline UwalData *
+	data(Packet *p)
+	{
+		return dynamic_cast<UwalData *>(p->userdata());
+	}
+
+	/**
+	 * Return the buffer of the packet for writing, attaching a new one or
+	 * copying the current one if it is shared with other packets.
+	 */
+	static UwalBuffer *writable(Packet *p);
+
+	/**
+	 * Zero the dummy string and the binary data of the packet, without
+	 * copying them if they are shared with other packets.
+	 */
+	static void resetBin(Packet *p);
+
+	/**
+	 * Return the data area of the packet as seen by the layers above UW-AL,
+	 * NULL if none.
+	 */
+	static inline AppData *
+	upperData(Packet *p)
+	{
+		UwalData *d = data(p);
+		return d ? d->upper() : p->userdata();
+	}
+
+	/**
+	 * Replace the data area of the packet as seen by the layers above
+	 * UW-AL, deleting the current one.
+	 */
+	static void setUpperData(Packet *p, AppData *upper);
+
+	/**
+	 * Drop the binary data of the packet, giving it back the data area it
+	 * had above UW-AL. Called on the packets sent up.
+	 */
+	static void detachBin(Packet *p);
+
+	/**
+	 * Return the pointer to the dummy string of the packet.
+	 */
+	static inline const char *
+	dummyStr(Packet *p)
+	{
+		UwalData *d = data(p);
+		return d ? d->buffer()->dummyStr : UwalBuffer::empty().dummyStr;
+	}
+
+	/**
+	 * Return the pointer to the dummy string of the packet, for writing.
+	 */
+	static inline char *
+	writableDummyStr(Packet *p)
+	{
+		return writable(p)->dummyStr;
+	}
+
+	/**
+	 * Return the pointer to the binary data of the packet.
 	 */
-	inline char *
-	dummyStr()
+	static inline const char *
+	binPkt(Packet *p)
 	{
-		return dummyStr_;
+		UwalData *d = data(p);
+		return d ? d->buffer()->binPkt : UwalBuffer::empty().binPkt;
 	}
 
 	/**
-	 * Return to the binPkt_ array pointer.
+	 * Return the pointer to the binary data of the packet, for writing.
 	 */
-	inline char *
-	binPkt()
+	static inline char *
+	writableBinPkt(Packet *p)
 	{
-		return binPkt_;
+		return writable(p)->binPkt;
 	}
 
 	/**
@@ -0,0 +1,422 @@
+//
+// Copyright (c) 2017 Regents of the SIGNET lab, University of Padova.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. Neither the name of the University of Padova (SIGNET lab) nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+/**
+ * @file packer-schema.h
+ * \version 1.0.0
+ * \brief  Declarative description of the header fields serialized by a
+ * packer, from which pack, unpack, print and length code is generated.
+ *
+ * A packer lists the fields of its header once:
+ *
+ * \code
+ * typedef PackerSchema<
+ *		PACKER_FIELD(hdr_uwudp, sport_, 8),
+ *		PACKER_FIELD(hdr_uwudp, dport_, 8)> UwudpSchema;
+ * \endcode
+ *
+ * and calls UwudpSchema::pack, UwudpSchema::unpack, ... with the widths
+ * found in n_bits, so that the widths set from Tcl are still honoured.
+ * The widths given in the schema are the defaults of the Tcl bindings, and
+ * compile time constants: when n_bits holds the defaults, pack and unpack
+ * switch once per packet to packFixed and unpackFixed, where the compiler
+ * folds the width of each field into the inline packer::put and packer::get.
+ */
+
+#ifndef PACKER_SCHEMA_H
+#define PACKER_SCHEMA_H
+
+#include "packer.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+/**
+ * Field of a packer schema: the member Member, of type T, of the header Hdr,
+ * serialized on Bits bits by default.
+ * Bits may be larger than the member: the value is then zero extended on
+ * the stream, and the extra bits are skipped when it is read back.
+ */
+template <typename Hdr, typename T, T Hdr::*Member,
+		size_t Bits = CHAR_BIT * sizeof(T)>
+struct PackerField {
+	static_assert(sizeof(T) <= sizeof(uint64_t),
+			"packer fields must fit in 64 bits");
+
+	typedef Hdr header_type;
+	typedef T value_type;
+
+	/**
+	 * Default number of bits of the field.
+	 */
+	static constexpr size_t
+	bits()
+	{
+		return Bits;
+	}
+
+	static const T &
+	ref(const Hdr *h)
+	{
+		return h->*Member;
+	}
+
+	static T &
+	ref(Hdr *h)
+	{
+		return h->*Member;
+	}
+};
+
+/**
+ * Declares the PackerField of a member of a header, deducing its type.
+ */
+#define PACKER_FIELD(Hdr, member, bits) \
+	PackerField<Hdr, decltype(Hdr::member), &Hdr::member, bits>
+
+/**
+ * Access point of the schemas to packer::put and packer::get: moves a single
+ * field, whatever its type and its number of bits.
+ */
+class PackerFieldIo
+{
+public:
+	template <typename T>
+	static size_t
+	put(packer &pk, unsigned char *buf, size_t offset, const T &val,
+			size_t h)
+	{
+		// The raw bytes of the value, zero extended to 64 bits: h is not
+		// bound to the size of the member.
+		unsigned char word[sizeof(uint64_t)] = {0};
+		std::memcpy(word, &val, sizeof(T));
+		size_t n = std::min(h, CHAR_BIT * sizeof(word));
+		pk.put(buf, offset, word, n);
+		std::memset(word, 0, sizeof(word));
+		for (size_t j = n; j < h; j += CHAR_BIT * sizeof(word))
+			pk.put(buf,
+					offset + j,
+					word,
+					std::min(h - j, CHAR_BIT * sizeof(word)));
+		return h;
+	}
+
+	template <typename T>
+	static size_t
+	get(packer &pk, unsigned char *buf, size_t offset, T &val, size_t h)
+	{
+		unsigned char word[sizeof(uint64_t)] = {0};
+		pk.get(buf, offset, word, std::min(h, CHAR_BIT * sizeof(word)));
+		std::memcpy(&val, word, sizeof(T));
+		return h;
+	}
+
+	/**
+	 * Prints a field: integers also as the hex dump of their h low bits.
+	 */
+	template <typename T>
+	static void
+	print(std::ostream &os, const T &val, size_t h)
+	{
+		printValue(os, val, h, std::is_integral<T>());
+	}
+
+private:
+	template <typename T>
+	static void
+	printValue(std::ostream &os, const T &val, size_t h, std::true_type)
+	{
+		typedef typename std::conditional<std::is_signed<T>::value,
+				int64_t,
+				uint64_t>::type wide_type;
+		wide_type v = static_cast<wide_type>(val);
+		os << v << " "
+		   << packer::hex_bytes(
+					  v, std::min(h, CHAR_BIT * sizeof(wide_type)));
+	}
+
+	template <typename T>
+	static void
+	printValue(std::ostream &os, const T &val, size_t, std::false_type)
+	{
+		os << val;
+	}
+};
+
+/**
+ * I-th field of a list of PackerField.
+ */
+template <size_t I, typename F, typename... Rest>
+struct PackerSchemaField {
+	typedef typename PackerSchemaField<I - 1, Rest...>::type type;
+};
+
+template <typename F, typename... Rest>
+struct PackerSchemaField<0, F, Rest...> {
+	typedef F type;
+};
+
+/**
+ * Ordered list of the fields of a header, as they appear on the stream.
+ * Each method taking a bits argument reads the width of the i-th field from
+ * bits[i], which is normally the n_bits vector of the packer.
+ */
+template <typename... Fields>
+class PackerSchema;
+
+template <>
+class PackerSchema<>
+{
+public:
+	static constexpr size_t
+	size()
+	{
+		return 0;
+	}
+
+	static constexpr size_t
+	fixedLength()
+	{
+		return 0;
+	}
+
+	static size_t
+	length(const size_t *)
+	{
+		return 0;
+	}
+
+	static bool
+	isDefault(const size_t *)
+	{
+		return true;
+	}
+
+	template <typename Hdr>
+	static size_t
+	packBits(packer &, const Hdr *, unsigned char *, size_t offset,
+			const size_t *)
+	{
+		return offset;
+	}
+
+	template <typename Hdr>
+	static size_t
+	unpackBits(packer &, unsigned char *, size_t offset, Hdr *,
+			const size_t *)
+	{
+		return offset;
+	}
+
+	template <typename Hdr>
+	static size_t
+	packFixed(packer &, const Hdr *, unsigned char *, size_t offset)
+	{
+		return offset;
+	}
+
+	template <typename Hdr>
+	static size_t
+	unpackFixed(packer &, unsigned char *, size_t offset, Hdr *)
+	{
+		return offset;
+	}
+
+	static void
+	printMap(std::ostream &, const char *const *, const size_t *,
+			const char *)
+	{
+	}
+
+	template <typename Hdr>
+	static void
+	printFields(std::ostream &, const Hdr *, const char *const *,
+			const size_t *, const char *)
+	{
+	}
+};
+
+template <typename F, typename... Rest>
+class PackerSchema<F, Rest...>
+{
+	typedef PackerSchema<Rest...> Tail;
+
+public:
+	typedef typename F::header_type header_type;
+
+	/**
+	 * Number of fields of the schema.
+	 */
+	static constexpr size_t
+	size()
+	{
+		return 1 + sizeof...(Rest);
+	}
+
+	/**
+	 * Default width of the I-th field.
+	 */
+	template <size_t I>
+	static constexpr size_t
+	bits()
+	{
+		return PackerSchemaField<I, F, Rest...>::type::bits();
+	}
+
+	/**
+	 * Number of bits of the header with the default widths.
+	 */
+	static constexpr size_t
+	fixedLength()
+	{
+		return F::bits() + Tail::fixedLength();
+	}
+
+	/**
+	 * Number of bits of the header with the given widths.
+	 */
+	static size_t
+	length(const size_t *bits)
+	{
+		return bits[0] + Tail::length(bits + 1);
+	}
+
+	/**
+	 * Tells whether the given widths are the default ones.
+	 */
+	static bool
+	isDefault(const size_t *bits)
+	{
+		return bits[0] == F::bits() && Tail::isDefault(bits + 1);
+	}
+
+	/**
+	 * Writes the fields of h to buf, starting from bit offset.
+	 * @return the offset after the last field.
+	 */
+	static size_t
+	pack(packer &pk, const header_type *h, unsigned char *buf, size_t offset,
+			const size_t *bits)
+	{
+		if (isDefault(bits))
+			return packFixed(pk, h, buf, offset);
+		return packBits(pk, h, buf, offset, bits);
+	}
+
+	/**
+	 * Reads the fields of h from buf, starting from bit offset. The bits of
+	 * each member not found on the stream are zero.
+	 * @return the offset after the last field.
+	 */
+	static size_t
+	unpack(packer &pk, unsigned char *buf, size_t offset, header_type *h,
+			const size_t *bits)
+	{
+		if (isDefault(bits))
+			return unpackFixed(pk, buf, offset, h);
+		return unpackBits(pk, buf, offset, h, bits);
+	}
+
+	/**
+	 * Same as pack, with the widths read from bits.
+	 */
+	static size_t
+	packBits(packer &pk, const header_type *h, unsigned char *buf,
+			size_t offset, const size_t *bits)
+	{
+		offset += PackerFieldIo::put(pk, buf, offset, F::ref(h), bits[0]);
+		return Tail::packBits(pk, h, buf, offset, bits + 1);
+	}
+
+	/**
+	 * Same as unpack, with the widths read from bits.
+	 */
+	static size_t
+	unpackBits(packer &pk, unsigned char *buf, size_t offset, header_type *h,
+			const size_t *bits)
+	{
+		offset += PackerFieldIo::get(pk, buf, offset, F::ref(h), bits[0]);
+		return Tail::unpackBits(pk, buf, offset, h, bits + 1);
+	}
+
+	/**
+	 * Same as pack, with the default widths.
+	 */
+	static size_t
+	packFixed(packer &pk, const header_type *h, unsigned char *buf,
+			size_t offset)
+	{
+		offset += PackerFieldIo::put(pk, buf, offset, F::ref(h), F::bits());
+		return Tail::packFixed(pk, h, buf, offset);
+	}
+
+	/**
+	 * Same as unpack, with the default widths.
+	 */
+	static size_t
+	unpackFixed(packer &pk, unsigned char *buf, size_t offset, header_type *h)
+	{
+		offset += PackerFieldIo::get(pk, buf, offset, F::ref(h), F::bits());
+		return Tail::unpackFixed(pk, buf, offset, h);
+	}
+
+	/**
+	 * Prints the name and the width of each field.
+	 */
+	static void
+	printMap(std::ostream &os, const char *const *names, const size_t *bits,
+			const char *color)
+	{
+		os << color << " " << names[0] << ": \033[0m" << bits[0] << " bits"
+		   << std::endl;
+		Tail::printMap(os, names + 1, bits + 1, color);
+	}
+
+	/**
+	 * Prints the name and the value of each field actually serialized.
+	 */
+	static void
+	printFields(std::ostream &os, const header_type *h,
+			const char *const *names, const size_t *bits, const char *color)
+	{
+		if (bits[0] != 0) {
+			os << color << " " << names[0] << ":\033[0m ";
+			PackerFieldIo::print(os, F::ref(h), bits[0]);
+			os << std::endl;
+		}
+		Tail::printFields(os, h, names + 1, bits + 1, color);
+	}
+};
+
+#endif
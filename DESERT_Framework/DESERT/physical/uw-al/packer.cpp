@@ -41,6 +41,8 @@
 #include <iostream>
 #include <limits.h>
 #include <cmath>
+#include <algorithm>
+#include <random>
 
 typedef unsigned char BARR_ELTYPE;
 
@@ -196,6 +198,15 @@ packer::command(int argc, const char *const *argv)
 		}
 	}
 
+	if (argc == 3 || argc == 4) {
+		if (strcmp(argv[1], "checkBitEngine") == 0) {
+			unsigned int seed = (argc == 4) ? atoi(argv[3]) : 1;
+			if (!checkBitEngine(atoi(argv[2]), seed))
+				return TCL_ERROR;
+			return TCL_OK;
+		}
+	}
+
 	if (argc == 3) {
 		if (strcmp(argv[1], "addPacker") == 0) {
 			activePackers.push_back((packer *) TclObject::lookup(argv[2]));
@@ -230,23 +241,36 @@ packer::getHdrBinLength()
 	return getMyHdrBinLength();
 }
 
-std::string
-packer::packHdr(Packet *p)
+size_t
+packer::packHdr(Packet *p, unsigned char *buf, size_t len)
 {
-	unsigned char *buf = new unsigned char[hdr_length];
+	if (hdr_length > len) {
+		std::cout << "\033[0;0;31m"
+				  << " ERROR"
+				  << "\033[0m" << std::endl;
+		cout << "in packer::packHdr -> hdr size returned by packer is "
+			 << hdr_length << ", higher than the buffer size: " << len
+			 << ". Hdr is not serialized." << endl;
+		return 0;
+	}
+
 	memset(buf, '\0', hdr_length);
+	packMyHdr(p, buf, 0);
 
-	size_t offset = 0;
-	packMyHdr(p, buf, offset);
+	return hdr_length;
+}
+
+size_t
+packer::packHdrToBinPkt(Packet *p)
+{
 	hdr_uwal *hal = HDR_UWAL(p);
-	memset(hal->binPkt(), '\0', hdr_length);
+	unsigned char *binPkt = (unsigned char *) hdr_uwal::writableBinPkt(p);
 	hal->binHdrLength() = 0;
 
-	if (!(hdr_length > MAX_BIN_PKT_ARRAY_LENGTH)) {
-
-		memcpy(hal->binPkt(), buf, hdr_length);
-		hal->binHdrLength() = hdr_length;
-		hal->binPktLength() += hdr_length;
+	size_t length = packHdr(p, binPkt, MAX_BIN_PKT_ARRAY_LENGTH);
+	if (length > 0) {
+		hal->binHdrLength() = length;
+		hal->binPktLength() += length;
 
 		if (hal->binPktLength() != hdr_length &&
 				hal->binPktLength() != hdr_length + payload_length) {
@@ -261,128 +285,98 @@ packer::packHdr(Packet *p)
 				 << endl;
 			exit(-1);
 		}
-
-	} else {
-		std::cout << "\033[0;0;31m"
-				  << " ERROR"
-				  << "\033[0m" << std::endl;
-		;
-		cout << "in packer::packHdr -> hdr size returned by packer is "
-			 << hdr_length << ", higher than MAX_BIN_PKT_ARRAY_LENGTH: "
-			 << MAX_BIN_PKT_ARRAY_LENGTH << ". Hdr is not serialized." << endl;
 	}
 
-	std::string res;
-	res.assign((const char *) buf, hdr_length);
-	delete[] buf;
-
 	if (debug_) {
 		std::cout << "\033[0;47;30m"
 				  << " TX"
 				  << "\033[0m" << std::endl;
 		cout << "--> Bin data header generated by packer:"
-			 << hexdump(hal->binPkt(), hdr_length) << endl;
-		cout << "--> Header length (unsigned char):" << hdr_length << endl;
+			 << hexdump((const char *) binPkt, length) << endl;
+		cout << "--> Header length (unsigned char):" << length << endl;
 	}
 
-	return res;
+	return length;
 }
 
 std::string
-packer::packPayload(Packet *p)
+packer::packHdr(Packet *p)
 {
-	std::string res;
-	hdr_uwal *hal = HDR_UWAL(p);
-	memset(hal->binPkt() + hdr_length,
-			'\0',
-			MAX_BIN_PKT_ARRAY_LENGTH - hdr_length);
-	size_t offset;
-	if (!activePackers.empty()) {
-		// unsigned char *buf = new unsigned char[payload_length];
-		// memset(buf, '\0', payload_length);
-		unsigned char *buf =
-				new unsigned char[MAX_BIN_PKT_ARRAY_LENGTH - hdr_length];
-		memset(buf, '\0', MAX_BIN_PKT_ARRAY_LENGTH - hdr_length);
-
-		offset = 0;
-		for (std::vector<packer *>::iterator it = activePackers.begin();
-				it != activePackers.end();
-				++it) {
-			offset = (*it)->packMyHdr(p, buf, offset);
-		}
-
-		if (!(BARR_ARRAYSIZE(offset) > MAX_BIN_PKT_ARRAY_LENGTH - hdr_length)) {
-			memcpy(hal->binPkt() + hdr_length, buf, std::ceil(offset/8.0));
-			hal->binPktLength() += BARR_ARRAYSIZE(offset);
-			if (hal->binPktLength() != hdr_length + payload_length) {
-				if (debug_ > 1) {
-					std::cout << "\033[0;0;31m"
-							  << " WARNING - REDUCED PACKET"
-							  << "\033[0m" << std::endl;
-					;
-					std::cout << "in packer::packPayload -> pkt size set to: "
-							  << hal->binPktLength()
-							  << ", header length is: " << hdr_length
-							  << " and payload length is: "
-							  << BARR_ARRAYSIZE(offset)
-							  << " , DEFAULT payload length is "
-							  << payload_length << std::endl;
-				}
-			}
-		} else {
-			std::cout << "\033[0;0;31m"
-					  << " ERROR"
-					  << "\033[0m" << std::endl;
-			;
-			std::cout << "in packer::packPayload -> payload size returned by "
-						 "packer is: "
-					  << offset << ", higher than: "
-					  << (MAX_BIN_PKT_ARRAY_LENGTH - hdr_length)
-					  << " Which is the max pkt length: "
-					  << MAX_BIN_PKT_ARRAY_LENGTH
-					  << " minus the header length: " << hdr_length
-					  << ". Payload is not serialized." << std::endl;
-		}
+	size_t length = packHdrToBinPkt(p);
+	return std::string(hdr_uwal::binPkt(p), length);
+}
 
-		/*      if (!(payload_length > MAX_BIN_PKT_ARRAY_LENGTH - hdr_length)) {
-					memcpy(hal->binPkt() + hdr_length, buf, payload_length);
-					hal->binPktLength() += payload_length;
-					if (hal->binPktLength() != payload_length &&
-		   hal->binPktLength() != hdr_length + payload_length) {
-						std::cout << "\033[0;0;31m" << " ERROR" << "\033[0m" <<
-		   std::endl;;
-						cout << "in packer::packHdr -> pkt size set to: " <<
-		   hal->binPktLength() << ", whilst header length is: " << hdr_length <<
-		   " and payload length is: " << payload_length << endl;
-						exit(-1);
-					}
-				} else {
-					std::cout << "\033[0;0;31m" << " ERROR" << "\033[0m" <<
-		   std::endl;;
-					std::cout << "in packer::packPayload -> payload size
-		   returned by packer is: " << payload_length << ", higher than: " <<
-		   (MAX_BIN_PKT_ARRAY_LENGTH - hdr_length) << " Which is the max pkt
-		   length: " << MAX_BIN_PKT_ARRAY_LENGTH << " minus the header length: "
-		   << hdr_length << ". Payload is not serialized." << std::endl;
-				}
-				// conversion from const char* to string
-				res.assign((const char *) buf, payload_length);
-				delete[] buf;
-		*/
-		// conversion from const char* to string
-		res.assign((const char *) buf, BARR_ARRAYSIZE(offset));
-		delete[] buf;
-	} else {
+size_t
+packer::packPayload(Packet *p, unsigned char *buf, size_t len)
+{
+	if (activePackers.empty()) {
 		if (payload_length != 0) {
 			std::cout << "\033[0;0;31m"
 					  << " WARNING"
 					  << "\033[0m" << std::endl;
 			std::cout << "in packer::packPayload -> payload activePackers "
 						 "empty but payload_length: "
-					  << payload_length << ". Empty string is returned"
+					  << payload_length << ". Empty payload is returned"
+					  << std::endl;
+		}
+		return 0;
+	}
+
+	// The active packers can write more than payload_length bytes (e.g. a
+	// variable size payload after their fixed fields) and can skip bits
+	// without writing them: they write in a zeroed scratch buffer, and only
+	// the bytes actually packed are copied
+	unsigned char scratch[MAX_BIN_PKT_ARRAY_LENGTH];
+	memset(scratch, '\0', MAX_BIN_PKT_ARRAY_LENGTH);
+
+	size_t offset = 0;
+	for (std::vector<packer *>::iterator it = activePackers.begin();
+			it != activePackers.end();
+			++it) {
+		offset = (*it)->packMyHdr(p, scratch, offset);
+	}
+
+	size_t length = BARR_ARRAYSIZE(offset);
+	if (length > len) {
+		std::cout << "\033[0;0;31m"
+				  << " ERROR"
+				  << "\033[0m" << std::endl;
+		;
+		std::cout << "in packer::packPayload -> payload size returned by "
+					 "packer is: "
+				  << offset << ", higher than the buffer size: " << len
+				  << ". Payload is not serialized." << std::endl;
+		return 0;
+	}
+
+	memcpy(buf, scratch, length);
+
+	return length;
+}
+
+size_t
+packer::packPayloadToBinPkt(Packet *p)
+{
+	hdr_uwal *hal = HDR_UWAL(p);
+	unsigned char *binPkt = (unsigned char *) hdr_uwal::writableBinPkt(p);
+
+	size_t length = packPayload(
+			p, binPkt + hdr_length, MAX_BIN_PKT_ARRAY_LENGTH - hdr_length);
+	hal->binPktLength() += length;
+
+	if (length > 0 && hal->binPktLength() != hdr_length + payload_length) {
+		if (debug_ > 1) {
+			std::cout << "\033[0;0;31m"
+					  << " WARNING - REDUCED PACKET"
+					  << "\033[0m" << std::endl;
+			;
+			std::cout << "in packer::packPayload -> pkt size set to: "
+					  << hal->binPktLength()
+					  << ", header length is: " << hdr_length
+					  << " and payload length is: " << length
+					  << " , DEFAULT payload length is " << payload_length
 					  << std::endl;
 		}
-		res.assign("");
 	}
 
 	if (debug_) {
@@ -390,22 +384,38 @@ packer::packPayload(Packet *p)
 				  << " TX"
 				  << "\033[0m" << std::endl;
 		std::cout << "--> Bin data payload generated by packer:"
-				  << hexdump(hal->binPkt() + hdr_length, BARR_ARRAYSIZE(offset))
+				  << hexdump((const char *) binPkt + hdr_length, length)
+				  << std::endl;
+		std::cout << "--> Payload length (unsigned char):" << length
 				  << std::endl;
-		std::cout << "--> Payload length (unsigned char):"
-				  << BARR_ARRAYSIZE(offset) << std::endl;
 	}
 
-	/*    if (debug_) {
+	return length;
+}
 
-			std::cout << "\033[0;47;30m" << " TX" << "\033[0m" << std::endl;
-			std::cout << "--> Bin data payload generated by packer:" <<
-	   hexdump(hal->binPkt() + hdr_length, payload_length) << std::endl;
-			std::cout << "--> Payload length (unsigned char):" << payload_length
-	   << std::endl;
-		}
-	*/
-	return res;
+std::string
+packer::packPayload(Packet *p)
+{
+	size_t length = packPayloadToBinPkt(p);
+	return std::string(hdr_uwal::binPkt(p) + hdr_length, length);
+}
+
+size_t
+packer::unpackHdr(const unsigned char *buf, size_t len, Packet *p)
+{
+	if (hdr_length > len) {
+		std::cout << "\033[0;0;31m"
+				  << " ERROR"
+				  << "\033[0m" << std::endl;
+		cout << "in packer::unpackHdr -> hdr size is " << hdr_length
+			 << ", higher than the buffer size: " << len
+			 << ". Hdr is not deserialized." << endl;
+		return 0;
+	}
+
+	unpackMyHdr((unsigned char *) buf, 0, p);
+
+	return hdr_length;
 }
 
 Packet *
@@ -419,43 +429,71 @@ packer::unpackHdr(Packet *p)
 				  << " RX"
 				  << "\033[0m" << std::endl;
 		std::cout << "<-- Bin data header received by packer:"
-				  << hexdump(hal->binPkt(), hdr_length) << std::endl;
+				  << hexdump(hdr_uwal::binPkt(p), hdr_length) << std::endl;
+	}
+
+	unpackHdr((const unsigned char *) hdr_uwal::binPkt(p),
+			MAX_BIN_PKT_ARRAY_LENGTH,
+			p);
+
+	return p;
+}
+
+size_t
+packer::unpackPayload(const unsigned char *buf, size_t len, Packet *p)
+{
+	// The active packers read up to payload_length bytes: a shorter buffer
+	// is zero padded into a scratch one
+	unsigned char scratch[MAX_BIN_PKT_ARRAY_LENGTH];
+	unsigned char *src = (unsigned char *) buf;
+	if (payload_length > len) {
+		memset(scratch, '\0', MAX_BIN_PKT_ARRAY_LENGTH);
+		memcpy(scratch, buf, std::min(len, (size_t) MAX_BIN_PKT_ARRAY_LENGTH));
+		src = scratch;
 	}
 
 	size_t offset = 0;
+	for (std::vector<packer *>::iterator it = activePackers.begin();
+			it != activePackers.end();
+			++it) {
+		offset = (*it)->unpackMyHdr(src, offset, p);
+	}
 
-	unpackMyHdr((unsigned char *) hal->binPkt(), offset, p);
+	// Now we have unpacked the whole packet, set the size according to the
+	// total received bits
+	HDR_CMN(p)->size() = offset / (sizeof(char) * 8);
+	if (debug_) {
+		std::cout << "ch->size() after unpack is: " << HDR_CMN(p)->size()
+				  << std::endl;
+	}
 
-	return p;
+	return BARR_ARRAYSIZE(offset);
 }
 
 Packet *
 packer::unpackPayload(Packet *p)
 {
 	hdr_uwal *hal = HDR_UWAL(p);
+	const char *binPayload = hdr_uwal::binPkt(p) + hal->binHdrLength();
+	size_t binPayloadLength = hal->binPktLength() - hal->binHdrLength();
 
 	if (debug_) {
 		std::cout << "\033[0;47;30m"
 				  << " RX"
 				  << "\033[0m" << std::endl;
-		// std::cout << "<-- Bin data payload received by packer:" <<
-		// hexdump(hal->binPkt() + hal->binHdrLength(), payload_length) <<
-		// std::endl;
 		hdr_cmn *ch = HDR_CMN(p);
 		std::cout << "<-- Bin data payload received by packer:"
-				  << hexdump(hal->binPkt() + hal->binHdrLength(), ch->size())
-				  << std::endl;
+				  << hexdump(binPayload, ch->size()) << std::endl;
 	}
 
 	if (activePackers.empty()) {
-		if (hal->binPktLength() - hal->binHdrLength() != 0) {
+		if (binPayloadLength != 0) {
 			std::cout << "\033[0;0;31m"
 					  << " WARNING"
 					  << "\033[0m" << std::endl;
 			std::cout << "in packer::unpackPayload -> payload activePackers "
 						 "empty but binary payload: "
-					  << hexdump(hal->binPkt() + hal->binHdrLength(),
-								 hal->binPktLength() - hal->binHdrLength())
+					  << hexdump(binPayload, binPayloadLength)
 					  << ". Packet in ERROR is returned" << std::endl;
 			hdr_cmn *ch = HDR_CMN(p);
 			ch->error() = 1;
@@ -463,41 +501,24 @@ packer::unpackPayload(Packet *p)
 		}
 	}
 
-	if (hal->binPktLength() - hal->binHdrLength() < payload_length) {
+	if (binPayloadLength < payload_length) {
 		if (debug_ > 1) {
 			std::cout << "\033[0;0;31m"
 					  << " WARNING"
 					  << "\033[0m" << std::endl;
 			std::cout << "in packer::unpackPayload -> the payload size "
 						 "computed from the HDR_UWAL corresponding fields is: "
-					  << hal->binPktLength() - hal->binHdrLength()
+					  << binPayloadLength
 					  << " which is not the DEFAULT expected size: "
 					  << payload_length << ". Is it a REDUCED packet?"
 					  << std::endl;
 		}
-
-		//        hdr_cmn *ch = HDR_CMN(p);
-		//        ch->error() = 1;
-		//        return p;
 	}
 
-	size_t offset = 0;
-	for (std::vector<packer *>::iterator it = activePackers.begin();
-			it != activePackers.end();
-			++it) {
-		offset = (*it)->unpackMyHdr(
-				(unsigned char *) (hal->binPkt() + hal->binHdrLength()),
-				offset,
-				p);
-	}
-
-	// Now we have unpacked the whole packet, set the size according to the
-	// total received bits
-	HDR_CMN(p)->size() = offset / (sizeof(char) * 8);
-	if (debug_) {
-		std::cout << "ch->size() after unpack is: " << HDR_CMN(p)->size()
-				  << std::endl;
-	}
+	// binPkt is zero padded up to MAX_BIN_PKT_ARRAY_LENGTH
+	unpackPayload((const unsigned char *) binPayload,
+			MAX_BIN_PKT_ARRAY_LENGTH - hal->binHdrLength(),
+			p);
 
 	return p;
 }
@@ -532,7 +553,7 @@ packer::packMyHdr(Packet *p, unsigned char *buf, size_t offset)
 	offset +=
 			put(buf, offset, &(alh->framePayloadOffset_), n_bits[field_idx++]);
 	offset += put(buf, offset, &(alh->Mbit_), n_bits[field_idx++]);
-	offset += put(buf, offset, &(alh->dummyStr_), n_bits[field_idx++]);
+	offset += put(buf, offset, hdr_uwal::dummyStr(p), n_bits[field_idx++]);
 
 	if (debug_) {
 		std::cout << "\033[0;47;30m"
@@ -565,8 +586,9 @@ packer::unpackMyHdr(unsigned char *buf, size_t offset, Packet *p)
 	memset(&(alh->Mbit_), 0, sizeof(alh->Mbit_));
 	offset += get(buf, offset, &(alh->Mbit_), n_bits[field_idx++]);
 
-	memset(&(alh->dummyStr_), '\0', MAX_DUMMY_STRING_LENGTH);
-	offset += get(buf, offset, &(alh->dummyStr_), n_bits[field_idx++]);
+	char *dummyStr = hdr_uwal::writableDummyStr(p);
+	memset(dummyStr, '\0', MAX_DUMMY_STRING_LENGTH);
+	offset += get(buf, offset, dummyStr, n_bits[field_idx++]);
 
 	if (debug_) {
 		std::cout << "\033[0;47;30m"
@@ -646,7 +668,8 @@ packer::printMyHdrField(Packet *p, int field)
 			break;
 		case 4:
 			std::cout << "\033[0;47;30m dummy content:\033[0m "
-					  << hexdump(alh->dummyStr()) << std::endl;
+					  << hexdump(std::string(hdr_uwal::dummyStr(p)))
+					  << std::endl;
 			break;
 		default:
 			std::cout << "\033[0;41;30m WARNING \033[0m, Field number "
@@ -669,28 +692,78 @@ packer::getMyHdrBinLength()
 	return total_bits;
 }
 
-size_t
-packer::get(unsigned char *buffer, size_t offset, void *val, size_t h)
+/**
+ * Bit by bit version of packer::get, used as reference by
+ * packer::checkBitEngine.
+ */
+static void
+getBitByBit(unsigned char *buffer, size_t offset, void *val, size_t h)
 {
 	for (size_t j = 0; j < h; j++)
 		if (BARR_TEST(buffer, (offset + j)))
 			BARR_SET(val, j);
 		else
 			BARR_CLEAR(val, j);
-
-	return h;
 }
 
-size_t
-packer::put(unsigned char *buffer, size_t offset, void *val, size_t h)
+/**
+ * Bit by bit version of packer::put, used as reference by
+ * packer::checkBitEngine.
+ */
+static void
+putBitByBit(unsigned char *buffer, size_t offset, const void *val, size_t h)
 {
 	for (size_t j = 0; j < h; j++)
 		if (BARR_TEST(val, j))
 			BARR_SET(buffer, (offset + j));
 		else
 			BARR_CLEAR(buffer, (offset + j));
+}
+
+bool
+packer::checkBitEngine(unsigned int iterations, unsigned int seed)
+{
+	const size_t len = 64;
+	unsigned char val[len];
+	unsigned char ref_val[len];
+	unsigned char buf[len];
+	unsigned char ref_buf[len];
+
+	// a generator of its own, not to alter the random stream of the
+	// simulation
+	std::mt19937 gen(seed);
+	std::uniform_int_distribution<int> byte(0, 255);
+	std::uniform_int_distribution<size_t> bits(1, len * CHAR_BIT / 2);
+
+	for (unsigned int it = 0; it < iterations; it++) {
+		for (size_t k = 0; k < len; k++) {
+			buf[k] = ref_buf[k] = (unsigned char) byte(gen);
+			val[k] = ref_val[k] = (unsigned char) byte(gen);
+		}
+		size_t h = bits(gen);
+		size_t offset = std::uniform_int_distribution<size_t>(
+				0, len * CHAR_BIT - h - 1)(gen);
+
+		put(buf, offset, val, h);
+		putBitByBit(ref_buf, offset, ref_val, h);
+		if (memcmp(buf, ref_buf, len) != 0) {
+			std::cerr << "packer::checkBitEngine() put mismatch, offset "
+					  << offset << ", bits " << h << std::endl;
+			return false;
+		}
+
+		for (size_t k = 0; k < len; k++)
+			val[k] = ref_val[k] = (unsigned char) byte(gen);
+		get(buf, offset, val, h);
+		getBitByBit(ref_buf, offset, ref_val, h);
+		if (memcmp(val, ref_val, len) != 0) {
+			std::cerr << "packer::checkBitEngine() get mismatch, offset "
+					  << offset << ", bits " << h << std::endl;
+			return false;
+		}
+	}
 
-	return h;
+	return true;
 }
 
 std::string
@@ -43,7 +43,11 @@
 #include <math.h>
 #include <packet.h>
 
+#include <stdint.h>
+
+#include <algorithm>
 #include <bitset>
+#include <climits>
 #include <cstring>
 #include <sstream>
 #include <string>
@@ -55,6 +59,8 @@
  */
 class packer : public TclObject
 {
+	friend class PackerFieldIo;
+
 public:
 	/**
 	 * Class constructor.
@@ -129,8 +135,56 @@ public:
 	 */
 	std::string packPayload(Packet *);
 
+	/**
+	 * Method to map the header of the AL into a string of binary characters,
+	 * that is also stored at the beginning of hdr_uwal::binPkt().
+	 *
+	 * @see packer::packHdrToBinPkt
+	 * @param p pointer to the NS-Miracle packet.
+	 * @return the binary string of the header.
+	 */
 	std::string packHdr(Packet *);
 
+	/**
+	 * Method to map the header of the AL into a buffer provided by the
+	 * caller, with no heap allocation.
+	 *
+	 * @param p pointer to the NS-Miracle packet.
+	 * @param buf buffer where to write the header.
+	 * @param len size of the buffer, in bytes.
+	 * @return the number of bytes written, 0 if the header does not fit.
+	 */
+	size_t packHdr(Packet *p, unsigned char *buf, size_t len);
+
+	/**
+	 * Method to map the headers of the active packers into a buffer
+	 * provided by the caller, with no heap allocation.
+	 *
+	 * @param p pointer to the NS-Miracle packet.
+	 * @param buf buffer where to write the payload.
+	 * @param len size of the buffer, in bytes.
+	 * @return the number of bytes written, 0 if the payload does not fit.
+	 */
+	size_t packPayload(Packet *p, unsigned char *buf, size_t len);
+
+	/**
+	 * Method to map the header of the AL at the beginning of
+	 * hdr_uwal::binPkt(), updating binHdrLength() and binPktLength().
+	 *
+	 * @param p pointer to the NS-Miracle packet.
+	 * @return the number of bytes written.
+	 */
+	size_t packHdrToBinPkt(Packet *p);
+
+	/**
+	 * Method to map the headers of the active packers in hdr_uwal::binPkt(),
+	 * after the header of the AL, updating binPktLength().
+	 *
+	 * @param p pointer to the NS-Miracle packet.
+	 * @return the number of bytes written.
+	 */
+	size_t packPayloadToBinPkt(Packet *p);
+
 	/**
 	 * Method to de-map a legal modem payload (i.e., a string of binary
 	 * characters) into an NS-Miracle packet, when one among the following
@@ -167,8 +221,42 @@ public:
 
 	Packet *unpackHdr(Packet *);
 
+	/**
+	 * Method to de-map the header of the AL from a buffer provided by the
+	 * caller.
+	 *
+	 * @param buf buffer with the binary header.
+	 * @param len size of the buffer, in bytes.
+	 * @param p pointer to the NS-Miracle packet to fill.
+	 * @return the number of bytes read, 0 if the buffer is too short.
+	 */
+	size_t unpackHdr(const unsigned char *buf, size_t len, Packet *p);
+
+	/**
+	 * Method to de-map the headers of the active packers from a buffer
+	 * provided by the caller, setting the size of the packet.
+	 *
+	 * @param buf buffer with the binary payload.
+	 * @param len size of the buffer, in bytes.
+	 * @param p pointer to the NS-Miracle packet to fill.
+	 * @return the number of bytes read.
+	 */
+	size_t unpackPayload(const unsigned char *buf, size_t len, Packet *p);
+
 	void printMap();
 
+	/**
+	 * Differential check of put and get against a bit by bit copy, on
+	 * random fields of random buffers.
+	 *
+	 * @param iterations number of random fields to check.
+	 * @param seed seed of the generator of the fields, which does not use
+	 * the random stream of the simulation.
+	 * @return true if every field is packed and unpacked as with the bit by
+	 * bit copy, false otherwise.
+	 */
+	bool checkBitEngine(unsigned int iterations, unsigned int seed = 1);
+
 	template <typename T>
 	static T
 	restoreSignedValue(T _header_field, const uint32_t &_num_compressed_bits)
@@ -264,9 +352,26 @@ protected:
 	 * @param h the number of bits to use for the mapping.
 	 * @return \e h, namely the number of written bits.
 	 */
-	size_t put(unsigned char *buffer, size_t offset, void *val, size_t h);
+	size_t put(
+			unsigned char *buffer, size_t offset, const void *val, size_t h);
 
 private:
+	/**
+	 * Reads n bytes, in little endian order, from a buffer with no alignment.
+	 */
+	static uint64_t loadBytes(const unsigned char *p, size_t n);
+
+	/**
+	 * Writes the n less significant bytes of w, in little endian order, to a
+	 * buffer with no alignment.
+	 */
+	static void storeBytes(unsigned char *p, uint64_t w, size_t n);
+
+	/**
+	 * Returns a word with the n less significant bits set, n <= 64.
+	 */
+	static uint64_t lowMask(size_t n);
+
 	std::vector<packer *>
 			activePackers; /**< Vector of elements containing the pointers to
 							  the active packers (i.e., the derived classed of
@@ -297,4 +402,92 @@ private:
 								  the header stream of bits. */
 };
 
+/*
+ * put and get are defined here, and not in packer.cpp, so that the compiler
+ * can fold the widths known at compile time, as the default ones of the
+ * packer schemas (see packer-schema.h).
+ */
+
+/**
+ * Maximum number of bits moved by each step of put and get: the field and its
+ * bit offset inside the first byte must fit in a 64 bit word.
+ */
+#define PACKER_WORD_BITS (64 - CHAR_BIT)
+
+inline uint64_t
+packer::loadBytes(const unsigned char *p, size_t n)
+{
+	uint64_t w = 0;
+	for (size_t k = 0; k < n; k++)
+		w |= (uint64_t) p[k] << (CHAR_BIT * k);
+	return w;
+}
+
+inline void
+packer::storeBytes(unsigned char *p, uint64_t w, size_t n)
+{
+	for (size_t k = 0; k < n; k++)
+		p[k] = (unsigned char) (w >> (CHAR_BIT * k));
+}
+
+inline uint64_t
+packer::lowMask(size_t n)
+{
+	return n >= 64 ? ~(uint64_t) 0 : (((uint64_t) 1 << n) - 1);
+}
+
+inline size_t
+packer::get(unsigned char *buffer, size_t offset, void *val, size_t h)
+{
+	unsigned char *dst = (unsigned char *) val;
+
+	// Bit j of the stream is bit j % 8 of byte j / 8, both in the buffer and
+	// in val: each step moves a field of up to PACKER_WORD_BITS bits, that
+	// starts on a byte boundary of val.
+	for (size_t j = 0; j < h; j += PACKER_WORD_BITS) {
+		size_t n = std::min((size_t) PACKER_WORD_BITS, h - j);
+		size_t pos = offset + j;
+		size_t shift = pos % CHAR_BIT;
+		uint64_t w = loadBytes(buffer + pos / CHAR_BIT,
+				(shift + n + CHAR_BIT - 1) / CHAR_BIT);
+		uint64_t v = (w >> shift) & lowMask(n);
+
+		size_t full = n / CHAR_BIT;
+		size_t rest = n % CHAR_BIT;
+		storeBytes(dst + j / CHAR_BIT, v, full);
+		if (rest) {
+			// keep the bits of val beyond h untouched
+			unsigned char &last = dst[j / CHAR_BIT + full];
+			unsigned char m = (unsigned char) lowMask(rest);
+			last = (last & ~m) | ((unsigned char) (v >> (CHAR_BIT * full)) & m);
+		}
+	}
+
+	return h;
+}
+
+inline size_t
+packer::put(unsigned char *buffer, size_t offset, const void *val, size_t h)
+{
+	const unsigned char *src = (const unsigned char *) val;
+
+	for (size_t j = 0; j < h; j += PACKER_WORD_BITS) {
+		size_t n = std::min((size_t) PACKER_WORD_BITS, h - j);
+		size_t pos = offset + j;
+		size_t shift = pos % CHAR_BIT;
+		size_t len = (shift + n + CHAR_BIT - 1) / CHAR_BIT;
+		uint64_t v = loadBytes(
+				src + j / CHAR_BIT, (n + CHAR_BIT - 1) / CHAR_BIT);
+		uint64_t mask = lowMask(n) << shift;
+
+		// keep the bits of the buffer around the field untouched
+		unsigned char *p = buffer + pos / CHAR_BIT;
+		uint64_t w = loadBytes(p, len);
+		w = (w & ~mask) | ((v << shift) & mask);
+		storeBytes(p, w, len);
+	}
+
+	return h;
+}
+
 #endif
@@ -38,6 +38,7 @@ Module/UW/AL set PSDU 32
 Module/UW/AL set debug_ 0
 Module/UW/AL set interframe_period 0
 Module/UW/AL set frame_set_validity 0
+Module/UW/AL set frame_set_pool 16
 Module/UW/AL set frame_padding 0
 
 UW/AL/Packer set SRC_ID_Bits 8
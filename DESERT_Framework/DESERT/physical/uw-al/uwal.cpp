@@ -38,6 +38,9 @@
 #include "uwal.h"
 #include <phymac-clmsg.h>
 
+#include <algorithm>
+#include <chrono>
+
 /**
  * The size, in bytes, of the default Physical Service Data Unit (i.e., the
  * maximum length of a packet coded into a stream of bits to be sent to the
@@ -45,6 +48,17 @@
  */
 #define DEFAULT_PSDU 32
 
+/**
+ * Number of buckets of the timer wheel used to expire the frame sets. Must be
+ * a power of 2.
+ */
+#define FRAME_SET_WHEEL_SIZE 64
+
+/**
+ * Number of ticks of the timer wheel in a frame_set_validity period.
+ */
+#define FRAME_SET_TICKS_PER_VALIDITY 4
+
 
 
 /**
@@ -73,10 +87,18 @@ Uwal::Uwal()
 	, debug_(0)
 	, sendDownPkts()
 	, sendDownFrames()
+	, frameSetPool()
+	, freeFrameSets()
 	, sendUpFrameSet()
+	, completeFrameSets()
+	, frameSetTicks()
+	, frameSetWheel()
+	, frameSetTick(0)
+	, frameSetWheelPos(-1)
 	, InterframeTmr(this)
 	, interframe_period(0)
 	, frame_set_validity(0)
+	, frame_set_pool(16)
 	, frame_padding(0)
 	, force_endTx_(0)
 {
@@ -91,6 +113,7 @@ Uwal::Uwal()
 
 	bind("interframe_period", &interframe_period);
 	bind("frame_set_validity", &frame_set_validity);
+	bind("frame_set_pool", &frame_set_pool);
 	bind("frame_padding", &frame_padding);
 	bind("force_endTx", &force_endTx_);
 }
@@ -108,6 +131,26 @@ Uwal::command(int argc, const char *const *argv)
 			PERList.clear();
 			return TCL_OK;
 		}
+		if (strcmp(argv[1], "getSourceStats") ==
+				0) { // tcl command returning, for each source node, the list
+					 // {srcID frames_rx per_drops timeouts}
+			std::ostringstream stats;
+			for (std::map<int, UwalSourceStats>::const_iterator it =
+							sourceStats.begin();
+					it != sourceStats.end();
+					++it) {
+				stats << "{" << it->first << " " << it->second.frames_rx << " "
+					  << it->second.per_drops << " " << it->second.timeouts
+					  << "} ";
+			}
+			Tcl &tcl = Tcl::instance();
+			tcl.result(stats.str().c_str());
+			return TCL_OK;
+		}
+		if (strcmp(argv[1], "resetSourceStats") == 0) {
+			sourceStats.clear();
+			return TCL_OK;
+		}
 	}
 	if (argc == 3) {
 		if (strcmp(argv[1], "linkPacker") == 0) { // tcl command to link to this
@@ -126,35 +169,41 @@ Uwal::command(int argc, const char *const *argv)
 			return TCL_OK;
 		}
 	}
+	if (argc == 4) {
+		if (strcmp(argv[1], "benchmark") ==
+				0) { // tcl command to measure the pack and unpack time of
+					 // n packets of the given type
+			int n = atoi(argv[2]);
+			int ptype = -1;
+			for (int t = 0; t < (int) p_info::nPkt_; t++) {
+				if (strcmp(packet_info.name((packet_t) t), argv[3]) == 0) {
+					ptype = t;
+					break;
+				}
+			}
+			if (ptype < 0) {
+				cerr << "UW-AL(" << nodeID << ") benchmark: unknown packet type "
+					 << argv[3] << endl;
+				return TCL_ERROR;
+			}
+			double result[3];
+			if (n <= 0 || !benchmark(n, (packet_t) ptype, result))
+				return TCL_ERROR;
+			Tcl &tcl = Tcl::instance();
+			tcl.resultf("%f %f %f", result[0], result[1], result[2]);
+			return TCL_OK;
+		}
+	}
 	if (argc >= 3) {
 		if (strcmp(argv[1], "Set_PER_List") == 0) {
 			for (int i = 2; i < argc - 1; i = i + 2) {
-				int id = atoi(argv[i]);
-				double per = atof(argv[i + 1]);
-				pl_element pl;
-				pl.node_ID = id;
-				pl.per = per;
-				for (list<pl_element>::iterator it = PERList.begin();
-						it != PERList.end();
-						++it) {
-					if (it->node_ID == pl.node_ID) {
-						it = PERList.erase(it);
-					}
-				}
-				PERList.insert(PERList.begin(), pl);
+				PERList[atoi(argv[i])] = atof(argv[i + 1]);
 			}
 			return TCL_OK;
 		}
 		if (strcmp(argv[1], "Clear_PER_List") == 0) {
 			for (int i = 2; i < argc; i++) {
-				int id = atoi(argv[i]);
-				for (list<pl_element>::iterator it = PERList.begin();
-						it != PERList.end();
-						++it) {
-					if (it->node_ID == id) {
-						it = PERList.erase(it);
-					}
-				}
+				PERList.erase(atoi(argv[i]));
 			}
 			return TCL_OK;
 		}
@@ -165,33 +214,15 @@ Uwal::command(int argc, const char *const *argv)
 bool
 Uwal::isInPERList(int mac_addr)
 {
-	bool flag = false;
-
-	for (list<PERListElement>::iterator it = PERList.begin();
-			it != PERList.end();
-			++it) {
-		if (it->node_ID == mac_addr) {
-			flag = true;
-			break;
-		}
-	}
-	return flag;
+	return PERList.find(mac_addr) != PERList.end();
 }
 
 double
 Uwal::getPERfromID(int mac_addr)
 {
-	double per;
-	for (list<PERListElement>::iterator it = PERList.begin();
-			it != PERList.end();
-			++it) {
-		if (it->node_ID == mac_addr) {
-			per = it->per;
-			cout << "getPER! " << it->per << endl;
-			break;
-		}
-	}
-	return per;
+	std::unordered_map<int, double>::const_iterator it =
+			PERList.find(mac_addr);
+	return it != PERList.end() ? it->second : 0;
 }
 
 void
@@ -218,8 +249,10 @@ Uwal::recv(Packet *p)
 		//        identify the packet at the AL
 		if (pPacker != NULL) {
 			hdr_cmn *ch = HDR_CMN(p);
-			pPacker->packHdr(p);
-			pPacker->packPayload(p);
+			pPacker->packHdrToBinPkt(p);
+			pPacker->packPayloadToBinPkt(p);
+			// the upper data is now serialized in the binary data
+			hdr_uwal::setUpperData(p, NULL);
 			// ch->size_ = pPacker->getHdrBytesLength() +
 			// pPacker->getPayloadBytesLength();
 		}
@@ -277,10 +310,11 @@ Uwal::initializeHdr(Packet *p, unsigned int pkt_counter_)
 	hal->pktID() = pkt_counter_;
 	hal->framePayloadOffset() = 0;
 	hal->Mbit() = 0;
-	memset(hal->dummyStr(), '\0', MAX_DUMMY_STRING_LENGTH);
-	memcpy(hal->dummyStr(), dummyStr.c_str(), dummyStr.size());
+	// a fragment gets a buffer of its own, without copying the one of the
+	// original packet
+	hdr_uwal::resetBin(p);
+	memcpy(hdr_uwal::writableDummyStr(p), dummyStr.c_str(), dummyStr.size());
 
-	memset(hal->binPkt(), '\0', MAX_BIN_PKT_ARRAY_LENGTH);
 	hal->binPktLength() = 0;
 	hal->binHdrLength() = 0;
 }
@@ -362,13 +396,14 @@ Uwal::fragmentPkt(Packet *p)
 				if (!(i == (frameNumber - 1) && lastFramePayloadLength == 0))
 					hal_tmp->Mbit() = 1;
 
-				pPacker->packHdr(f_tmp);
+				pPacker->packHdrToBinPkt(f_tmp);
 
 				// memcpy(hal_tmp->binPkt() + hal_tmp->binHdrLength(),
 				// hal->binPkt() + hal->binHdrLength() +
 				// hal_tmp->framePayloadOffset(), framePayloadLength);
-				memcpy(hal_tmp->binPkt() + hal_tmp->binHdrLength(),
-						hal->binPkt() + hal->binHdrLength() +
+				memcpy(hdr_uwal::writableBinPkt(f_tmp) +
+								hal_tmp->binHdrLength(),
+						hdr_uwal::binPkt(p) + hal->binHdrLength() +
 								hal_tmp->framePayloadOffset() *
 										framePayloadLength,
 						framePayloadLength);
@@ -380,11 +415,11 @@ Uwal::fragmentPkt(Packet *p)
 					else
 						std::cout << "TX frame num: " << i << endl;
 					std::cout << "Header: "
-							  << pPacker->hexdump(hal_tmp->binPkt(),
+							  << pPacker->hexdump(hdr_uwal::binPkt(f_tmp),
 										 hal_tmp->binHdrLength())
 							  << endl;
 					std::cout << "Payload: "
-							  << pPacker->hexdump(hal_tmp->binPkt() +
+							  << pPacker->hexdump(hdr_uwal::binPkt(f_tmp) +
 												 hal_tmp->binHdrLength(),
 										 hal_tmp->binPktLength() -
 												 hal_tmp->binHdrLength())
@@ -406,19 +441,21 @@ Uwal::fragmentPkt(Packet *p)
 				// frameNumber*framePayloadLength;
 				hal_tmp->framePayloadOffset() = frameNumber;
 
-				pPacker->packHdr(f_tmp);
+				pPacker->packHdrToBinPkt(f_tmp);
 
 				if (frame_padding) {
-					memcpy(hal_tmp->binPkt() + hal_tmp->binHdrLength(),
-							hal->binPkt() + hal->binHdrLength() +
+					memcpy(hdr_uwal::writableBinPkt(f_tmp) +
+									hal_tmp->binHdrLength(),
+							hdr_uwal::binPkt(p) + hal->binHdrLength() +
 									hal_tmp->framePayloadOffset() *
 											framePayloadLength,
 							PSDU - hal_tmp->binHdrLength());
 					hal_tmp->binPktLength() += (PSDU - hal_tmp->binHdrLength());
 					ch_tmp->size_ = PSDU;
 				} else {
-					memcpy(hal_tmp->binPkt() + hal_tmp->binHdrLength(),
-							hal->binPkt() + hal->binHdrLength() +
+					memcpy(hdr_uwal::writableBinPkt(f_tmp) +
+									hal_tmp->binHdrLength(),
+							hdr_uwal::binPkt(p) + hal->binHdrLength() +
 									hal_tmp->framePayloadOffset() *
 											framePayloadLength,
 							lastFramePayloadLength);
@@ -430,11 +467,11 @@ Uwal::fragmentPkt(Packet *p)
 				if (debug_) {
 					std::cout << "TX (last) frame num: " << frameNumber << endl;
 					std::cout << "Header: "
-							  << pPacker->hexdump(hal_tmp->binPkt(),
+							  << pPacker->hexdump(hdr_uwal::binPkt(f_tmp),
 										 hal_tmp->binHdrLength())
 							  << endl;
 					std::cout << "Payload: "
-							  << pPacker->hexdump(hal_tmp->binPkt() +
+							  << pPacker->hexdump(hdr_uwal::binPkt(f_tmp) +
 												 hal_tmp->binHdrLength(),
 										 hal_tmp->binPktLength() -
 												 hal_tmp->binHdrLength())
@@ -467,87 +504,46 @@ Uwal::reassembleFrames(Packet *p)
 		sendUpPkts.push(p);
 	} else {
 		RxFrameSetKey newKey(hal->srcID(), hal->pktID());
-		std::map<RxFrameSetKey, RxFrameSet>::iterator it =
-				sendUpFrameSet.find(newKey);
+		sourceStats[hal->srcID()].frames_rx++;
+		std::unordered_map<uint64_t, int>::iterator it =
+				sendUpFrameSet.find(newKey.value());
+		int slot = (it != sendUpFrameSet.end()) ? it->second
+												: allocFrameSet(newKey);
+		RxFrameSet &frameSet = frameSetPool[slot];
 
 		size_t framePayloadOffset =
 				hal->framePayloadOffset() * (PSDU - hal->binHdrLength());
 		// size_t framePayloadOffset = hal->framePayloadOffset()*(ch->size() -
 		// hal->binHdrLength());
-
-		if (it != sendUpFrameSet.end()) {
-			if (hal->Mbit()) { // not the last pkt frame
-				//(it->second).UpdateRxFrameSet(hal->binPkt() +
-				// hal->binHdrLength(), hal->framePayloadOffset(),
-				// hal->binPktLength() - hal->binHdrLength(), -1,
-				// Scheduler::instance().clock());
-				(it->second)
-						.UpdateRxFrameSet(hal->binPkt() + hal->binHdrLength(),
-								framePayloadOffset,
-								hal->binPktLength() - hal->binHdrLength(),
-								-1,
-								Scheduler::instance().clock());
-			} else {
-				//(it->second).UpdateRxFrameSet(hal->binPkt() +
-				// hal->binHdrLength(), hal->framePayloadOffset(),
-				// hal->binPktLength() - hal->binHdrLength(),
-				//(hal->framePayloadOffset() + hal->binPktLength() -
-				// hal->binHdrLength()), Scheduler::instance().clock());
-				(it->second)
-						.UpdateRxFrameSet(hal->binPkt() + hal->binHdrLength(),
-								framePayloadOffset,
-								hal->binPktLength() - hal->binHdrLength(),
-								(framePayloadOffset + hal->binPktLength() -
-										hal->binHdrLength()),
-								Scheduler::instance().clock());
-			}
-
-			if (ch->error()) {
-				if (debug_) {
-					std::cout << NOW << "  UW-AL(" << nodeID
-							  << ") - Received frame in error" << std::endl;
-				}
-				(it->second).setError();
-			}
-
+		size_t framePayloadLength = hal->binPktLength() - hal->binHdrLength();
+		bool wasComplete = frameSet.complete();
+
+		if (hal->Mbit()) { // not the last pkt frame
+			frameSet.UpdateRxFrameSet(hdr_uwal::binPkt(p) + hal->binHdrLength(),
+					framePayloadOffset,
+					framePayloadLength,
+					-1,
+					Scheduler::instance().clock());
 		} else {
-			RxFrameSet newSet;
-
-			if (hal->Mbit()) { // not the unique or last pkt frame
-				// newSet.UpdateRxFrameSet(hal->binPkt() + hal->binHdrLength(),
-				// hal->framePayloadOffset(), hal->binPktLength() -
-				// hal->binHdrLength(), -1, Scheduler::instance().clock());
-				newSet.UpdateRxFrameSet(hal->binPkt() + hal->binHdrLength(),
-						framePayloadOffset,
-						hal->binPktLength() - hal->binHdrLength(),
-						-1,
-						Scheduler::instance().clock());
-			} else {
-				// newSet.UpdateRxFrameSet(hal->binPkt() + hal->binHdrLength(),
-				// hal->framePayloadOffset(), hal->binPktLength() -
-				// hal->binHdrLength(), (hal->framePayloadOffset() +
-				// hal->binPktLength() - hal->binHdrLength()),
-				// Scheduler::instance().clock());
-				newSet.UpdateRxFrameSet(hal->binPkt() + hal->binHdrLength(),
-						framePayloadOffset,
-						hal->binPktLength() - hal->binHdrLength(),
-						(hal->framePayloadOffset() + hal->binPktLength() -
-								hal->binHdrLength()),
-						Scheduler::instance().clock());
-			}
+			frameSet.UpdateRxFrameSet(hdr_uwal::binPkt(p) + hal->binHdrLength(),
+					framePayloadOffset,
+					framePayloadLength,
+					framePayloadOffset + framePayloadLength,
+					Scheduler::instance().clock());
+		}
 
-			if (ch->error()) {
-				if (debug_) {
-					std::cout << NOW << "  UW-AL(" << nodeID
-							  << ") - Received frame in error" << std::endl;
-				}
-				newSet.setError();
+		if (ch->error()) {
+			if (debug_) {
+				std::cout << NOW << "  UW-AL(" << nodeID
+						  << ") - Received frame in error" << std::endl;
 			}
-
-			sendUpFrameSet.insert(
-					std::pair<RxFrameSetKey, RxFrameSet>(newKey, newSet));
+			frameSet.setError();
 		}
 
+		if (!wasComplete && frameSet.complete())
+			completeFrameSets.push(slot);
+		scheduleFrameSet(slot);
+
 		Packet::free(p);
 
 		if (debug_) {
@@ -555,14 +551,15 @@ Uwal::reassembleFrames(Packet *p)
 					  << ") Generated map of RxFrameSets. Number of elements: "
 					  << sendUpFrameSet.size() << endl;
 			int i = 1;
-			for (std::map<RxFrameSetKey, RxFrameSet>::iterator it =
+			for (std::unordered_map<uint64_t, int>::iterator it =
 							sendUpFrameSet.begin();
 					it != sendUpFrameSet.end();
 					it++) {
+				RxFrameSet &set = frameSetPool[it->second];
 				std::cout << "Element num: " << i++ << endl;
-				std::cout << "Key: " << it->first.displayKey() << endl;
+				std::cout << "Key: " << set.key().displayKey() << endl;
 				if (debug_ > 5) {
-					std::cout << "Set: " << it->second.displaySet() << endl;
+					std::cout << "Set: " << set.displaySet() << endl;
 				}
 			}
 		}
@@ -585,80 +582,158 @@ Uwal::recvSyncClMsg(ClMessage *m)
 void
 Uwal::checkRxFrameSet()
 {
-	int fs_size = sendUpFrameSet.size();
-	std::map<RxFrameSetKey, RxFrameSet>::iterator it = sendUpFrameSet.begin();
+	while (!completeFrameSets.empty()) {
+		int slot = completeFrameSets.front();
+		completeFrameSets.pop();
+		RxFrameSet &frameSet = frameSetPool[slot];
 
-	for (int i = 0; i < fs_size; i++) {
-		if (it->second.tot_length() == it->second.curr_length()) {
-			if (debug_) {
-				std::cout
-						<< NOW << "  UW-AL(" << nodeID
-						<< ")::checkRxFrameSet() - COMPLETE pkt RECEIVED! ****"
-						<< endl;
-				std::cout << "Number of elements in sendUpFrameSet: "
-						  << sendUpFrameSet.size() << endl;
-				std::cout << "Key: " << it->first.displayKey() << endl;
-				if (debug_ > 5) {
-					std::cout << "Set: " << it->second.displaySet() << endl;
-				}
+		if (debug_) {
+			std::cout << NOW << "  UW-AL(" << nodeID
+					  << ")::checkRxFrameSet() - COMPLETE pkt RECEIVED! ****"
+					  << endl;
+			std::cout << "Number of elements in sendUpFrameSet: "
+					  << sendUpFrameSet.size() << endl;
+			std::cout << "Key: " << frameSet.key().displayKey() << endl;
+			if (debug_ > 5) {
+				std::cout << "Set: " << frameSet.displaySet() << endl;
 			}
-			Packet *p = Packet::alloc();
-			initializeHdr(p, it->first.pktID());
+		}
+		Packet *p = Packet::alloc();
+		initializeHdr(p, frameSet.key().pktID());
 
-			hdr_uwal *hal = HDR_UWAL(p);
-			hdr_cmn *ch = HDR_CMN(p);
+		hdr_uwal *hal = HDR_UWAL(p);
+		hdr_cmn *ch = HDR_CMN(p);
+
+		hal->srcID() = frameSet.key().srcID();
 
-			hal->srcID() = it->first.srcID();
+		// pPacker -> packHdr(p); // (NOTE: it is not necessary to re-pack
+		// the uwal header, since the new allocated packet must be forwarded
+		// to the upper layers)
 
-			// pPacker -> packHdr(p); // (NOTE: it is not necessary to re-pack
-			// the uwal header, since the new allocated packet must be forwarded
-			// to the upper layers)
+		std::string binPayload = frameSet.binPayload();
+		memcpy(hdr_uwal::writableBinPkt(p) + hal->binHdrLength(),
+				binPayload.c_str(),
+				binPayload.size());
+		hal->binPktLength() += binPayload.size();
 
-			memcpy(hal->binPkt() + hal->binHdrLength(),
-					(it->second.binPayload()).c_str(),
-					(it->second.binPayload()).size());
-			hal->binPktLength() += (it->second.binPayload()).size();
+		// Set temporary size as num_frames*payload_lenght
+		ch->size() = frameSet.tot_length();
+		if (debug_) {
+			std::cout << "Packet size = " << ch->size() << std::endl;
+		}
 
-			// check if this is right
-			//            ch->uid() = hal->pktID();
-			//            if (debug_){
-			//                std::cout << "Size: " << ch->size() << endl;
-			//                std::cout << "Uid : "<< ch->uid() << std::endl;
-			//            }
+		pPacker->unpackPayload(p);
 
-			// Set temporary size as num_frames*payload_lenght
-			ch->size() = it->second.tot_length();
+		hdr_mac *mach = HDR_MAC(p);
+		std::unordered_map<int, double>::const_iterator per =
+				PERList.find(mach->macSA());
+		if (per != PERList.end()) {
+			double x = RNG::defaultrng()->uniform_double();
 			if (debug_) {
-				std::cout << "Packet size = " << ch->size() << std::endl;
+				cout << "x = " << x << endl;
+				cout << "PER = " << per->second << endl;
 			}
+			if (x <= per->second) {
+				ch->error() = 1;
+				sourceStats[frameSet.key().srcID()].per_drops++;
+			}
+		}
 
-			pPacker->unpackPayload(p);
-
-			hdr_mac *mach = HDR_MAC(p);
-			if (isInPERList(mach->macSA())) {
-				double x = RNG::defaultrng()->uniform_double();
-				cout << "x = " << x << endl;
-				double per = getPERfromID(mach->macSA());
-				cout << "PER = " << per << endl;
-				bool error = x <= per;
-				if (error)
-					ch->error() = 1;
+		if (frameSet.getError()) {
+			if (debug_) {
+				std::cout << NOW << "  UW-AL(" << nodeID
+						  << ") - Packet in error" << std::endl;
 			}
 
-			if (it->second.getError()) {
-				if (debug_) {
-					std::cout << NOW << "  UW-AL(" << nodeID
-							  << ") - Packet in error" << std::endl;
-				}
+			ch->error() = 1;
+		}
 
-				ch->error() = 1;
-			}
+		sendUpPkts.push(p);
+		freeFrameSet(slot);
+	}
 
-			sendUpPkts.push(p);
-			sendUpFrameSet.erase(it++);
-		} else if (Scheduler::instance().clock() -
-						it->second.t_last_rx_frame() >
-				frame_set_validity) {
+	expireFrameSets();
+}
+
+int
+Uwal::allocFrameSet(const RxFrameSetKey &key)
+{
+	if (freeFrameSets.empty()) {
+		size_t old_size = frameSetPool.size();
+		size_t new_size = old_size > 0 ? 2 * old_size
+									   : std::max(frame_set_pool, 1);
+		frameSetPool.resize(new_size);
+		frameSetTicks.resize(new_size, -1);
+		// lowest indexes are used first
+		for (size_t i = new_size; i-- > old_size;)
+			freeFrameSets.push_back(i);
+	}
+
+	int slot = freeFrameSets.back();
+	freeFrameSets.pop_back();
+	frameSetPool[slot].reset(key);
+	sendUpFrameSet[key.value()] = slot;
+	return slot;
+}
+
+void
+Uwal::freeFrameSet(int slot)
+{
+	sendUpFrameSet.erase(frameSetPool[slot].key().value());
+	frameSetTicks[slot] = -1;
+	freeFrameSets.push_back(slot);
+}
+
+void
+Uwal::scheduleFrameSet(int slot)
+{
+	if (frameSetWheel.empty()) {
+		frameSetWheel.resize(FRAME_SET_WHEEL_SIZE);
+		frameSetTick = frame_set_validity > 0
+				? frame_set_validity / FRAME_SET_TICKS_PER_VALIDITY
+				: 1;
+	}
+
+	double expiration =
+			frameSetPool[slot].t_last_rx_frame() + frame_set_validity;
+	long long tick = (long long) floor(expiration / frameSetTick);
+
+	// the previous entry of the slot, if any, is skipped when found stale
+	if (tick != frameSetTicks[slot]) {
+		frameSetTicks[slot] = tick;
+		frameSetWheel[tick & (FRAME_SET_WHEEL_SIZE - 1)].push_back(
+				std::make_pair(slot, tick));
+	}
+}
+
+void
+Uwal::expireFrameSets()
+{
+	if (frameSetWheel.empty())
+		return;
+
+	double now = Scheduler::instance().clock();
+	long long now_tick = (long long) floor(now / frameSetTick);
+	long long from = std::max(frameSetWheelPos,
+			now_tick - FRAME_SET_WHEEL_SIZE + 1);
+
+	// Only the buckets of the ticks elapsed since the last check are visited;
+	// the bucket of the current tick is visited again at the next check
+	for (long long t = from; t <= now_tick; t++) {
+		std::vector<std::pair<int, long long> > &bucket =
+				frameSetWheel[t & (FRAME_SET_WHEEL_SIZE - 1)];
+		size_t kept = 0;
+		for (size_t i = 0; i < bucket.size(); i++) {
+			int slot = bucket[i].first;
+			long long tick = bucket[i].second;
+			if (frameSetTicks[slot] != tick)
+				continue; // stale entry
+			if (tick > now_tick ||
+					now - frameSetPool[slot].t_last_rx_frame() <=
+							frame_set_validity) {
+				bucket[kept++] = bucket[i];
+				continue;
+			}
 			if (debug_) {
 				printf("\033[0;0;31m WARNING: \033[0m ");
 				std::cout << "**** Uwal::checkRxFrameSet() - INCOMPLETE pkt "
@@ -667,11 +742,121 @@ Uwal::checkRxFrameSet()
 				std::cout << "Number of elements in sendUpFrameSet: "
 						  << sendUpFrameSet.size() << endl;
 			}
-			sendUpFrameSet.erase(it++);
-		} else {
-			++it;
+			sourceStats[frameSetPool[slot].key().srcID()].timeouts++;
+			freeFrameSet(slot);
 		}
+		bucket.resize(kept);
 	}
+	frameSetWheelPos = now_tick;
+}
+
+bool
+Uwal::benchmark(int n, packet_t ptype, double result[3])
+{
+	if (pPacker == NULL || PSDU <= pPacker->getHdrBytesLength()) {
+		cerr << "UW-AL(" << nodeID << ") benchmark: no packer linked, or PSDU "
+			 << PSDU << " not larger than the header" << endl;
+		return false;
+	}
+	if (!sendDownPkts.empty() || !sendDownFrames.empty() ||
+			!sendUpFrames.empty() || !sendUpPkts.empty()) {
+		cerr << "UW-AL(" << nodeID << ") benchmark: packets in the queues"
+			 << endl;
+		return false;
+	}
+
+	// The benchmark runs on scratch reassembly slots, statistics and PER
+	// list, swapped with the ones of the module and restored at the end: the
+	// packets in reassembly are not touched, and no random number is drawn
+	// from the stream of the simulation.
+	std::map<int, UwalSourceStats> scratchStats;
+	std::unordered_map<int, double> scratchPER;
+	std::vector<RxFrameSet> scratchPool;
+	std::vector<int> scratchFree;
+	std::unordered_map<uint64_t, int> scratchSets;
+	std::queue<int> scratchComplete;
+	std::vector<long long> scratchTicks;
+	std::vector<std::vector<std::pair<int, long long> > > scratchWheel;
+	double scratchTick = 0;
+	long long scratchWheelPos = -1;
+	auto swapState = [&]() {
+		sourceStats.swap(scratchStats);
+		PERList.swap(scratchPER);
+		frameSetPool.swap(scratchPool);
+		freeFrameSets.swap(scratchFree);
+		sendUpFrameSet.swap(scratchSets);
+		completeFrameSets.swap(scratchComplete);
+		frameSetTicks.swap(scratchTicks);
+		frameSetWheel.swap(scratchWheel);
+		std::swap(frameSetTick, scratchTick);
+		std::swap(frameSetWheelPos, scratchWheelPos);
+	};
+	swapState();
+
+	unsigned long allocs = UwalBuffer::allocated() + UwalData::created();
+	// pktIDs of their own, as the reassembly slots: pkt_counter is not
+	// shifted for the packets sent afterwards
+	unsigned int bench_counter = 0;
+	size_t bytes = 0;
+	size_t frames = 0;
+	std::chrono::steady_clock::time_point start =
+			std::chrono::steady_clock::now();
+
+	for (int i = 0; i < n; i++) {
+		Packet *p = Packet::alloc();
+		hdr_cmn *ch = HDR_CMN(p);
+		ch->ptype() = ptype;
+		ch->direction() = hdr_cmn::DOWN;
+
+		initializeHdr(p, ++bench_counter);
+		pPacker->packHdrToBinPkt(p);
+		pPacker->packPayloadToBinPkt(p);
+		bytes += HDR_UWAL(p)->binPktLength();
+		fragmentPkt(p);
+
+		while (!sendDownFrames.empty()) {
+			// the frame is received as the modems do, in a new packet
+			Packet *f = sendDownFrames.front();
+			sendDownFrames.pop();
+			frames++;
+
+			Packet *r = Packet::alloc();
+			hdr_uwal *hal = HDR_UWAL(r);
+			hal->binPktLength() = HDR_UWAL(f)->binPktLength();
+			memcpy(hdr_uwal::writableBinPkt(r),
+					hdr_uwal::binPkt(f),
+					hal->binPktLength());
+			HDR_CMN(r)->direction() = hdr_cmn::UP;
+			Packet::free(f);
+
+			pPacker->unpackHdr(r);
+			reassembleFrames(r);
+		}
+
+		checkRxFrameSet();
+		while (!sendUpPkts.empty()) {
+			Packet::free(sendUpPkts.front());
+			sendUpPkts.pop();
+		}
+	}
+
+	double elapsed = std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start)
+							 .count();
+	allocs = UwalBuffer::allocated() + UwalData::created() - allocs;
+	swapState();
+
+	result[0] = elapsed * 1e9 / n;
+	result[1] = elapsed > 0 ? bytes / elapsed : 0;
+	result[2] = (double) allocs / n;
+
+	std::cout << "UW-AL(" << nodeID << ") benchmark: "
+			  << packet_info.name(ptype) << ", PSDU " << PSDU << ", " << n
+			  << " packets of " << (double) bytes / n << " bytes in "
+			  << (double) frames / n << " frames: " << result[0]
+			  << " ns/packet, " << result[1] << " bytes/s, " << result[2]
+			  << " uw-al buffers/packet" << std::endl;
+	return true;
 }
 
 void
@@ -703,6 +888,7 @@ Uwal::startRx(Packet *p)
 void
 Uwal::endRx(Packet *p)
 {
+	hdr_uwal::detachBin(p);
 	sendUp(p);
 }
 
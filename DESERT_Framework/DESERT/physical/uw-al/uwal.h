@@ -62,11 +62,26 @@
 #include <sys/types.h>
 #include <time.h>
 #include <unistd.h>
+#include <unordered_map>
+#include <vector>
 
-typedef struct PERListElement {
-	int node_ID;
-	double per;
-} pl_element;
+/**
+ * Counters kept by Uwal for each source node, identified by the srcID of its
+ * packets.
+ */
+typedef struct UwalSourceStats {
+	unsigned long frames_rx; /**< Frames received. */
+	unsigned long per_drops; /**< Packets in error due to the emulated PER. */
+	unsigned long timeouts; /**< Packets discarded since incomplete after
+							   frame_set_validity. */
+
+	UwalSourceStats()
+		: frames_rx(0)
+		, per_drops(0)
+		, timeouts(0)
+	{
+	}
+} uwal_source_stats;
 
 
 
@@ -178,10 +193,24 @@ protected:
 										  the upper protocols */
 	std::queue<Packet *> sendUpPkts; /**< queue of the packets to send up to the
 										upper protocols */
-	list<PERListElement> PERList; /**< PER list (couple of ID of the node and
-									 Packet Error Rate associated ) */
-	std::map<RxFrameSetKey, RxFrameSet>
-			sendUpFrameSet; /**< map of the frames to send up */
+	std::unordered_map<int, double> PERList; /**< PER list (Packet Error Rate
+												associated to the MAC address
+												of each node) */
+	std::map<int, UwalSourceStats>
+			sourceStats; /**< counters of each source node */
+	std::vector<RxFrameSet> frameSetPool; /**< reassembly slots */
+	std::vector<int> freeFrameSets; /**< indexes of the unused slots */
+	std::unordered_map<uint64_t, int>
+			sendUpFrameSet; /**< slot of each packet being reassembled,
+							   indexed by RxFrameSetKey::value() */
+	std::queue<int> completeFrameSets; /**< slots completed since the last
+										  call to checkRxFrameSet */
+	std::vector<long long> frameSetTicks; /**< expiration tick of each slot,
+											 -1 if unused */
+	std::vector<std::vector<std::pair<int, long long> > >
+			frameSetWheel; /**< timer wheel of (slot, expiration tick) */
+	double frameSetTick; /**< duration of a tick of the timer wheel [s] */
+	long long frameSetWheelPos; /**< last tick checked on the wheel */
 	/**
 	 * Method responsible to manage the queueing system of Adaptation Layer
 	 */
@@ -207,6 +236,44 @@ protected:
 	 * Method responsible to check for errors the received frames
 	 */
 	void checkRxFrameSet();
+	/**
+	 * Method responsible to get a reassembly slot for a new packet
+	 * @param key Key of the packet
+	 * @return index of the slot in frameSetPool
+	 */
+	int allocFrameSet(const RxFrameSetKey &key);
+	/**
+	 * Method responsible to release a reassembly slot
+	 * @param slot Index of the slot in frameSetPool
+	 */
+	void freeFrameSet(int slot);
+	/**
+	 * Method responsible to (re)schedule the expiration of a reassembly slot
+	 * after the reception of one of its frames
+	 * @param slot Index of the slot in frameSetPool
+	 */
+	void scheduleFrameSet(int slot);
+	/**
+	 * Method responsible to discard the reassembly slots not updated since
+	 * more than frame_set_validity
+	 */
+	void expireFrameSets();
+	/**
+	 * Method that runs packets through the whole adaptation layer, as if
+	 * sent to and received back from a modem: packing, fragmentation in PSDU
+	 * sized frames, unpacking and reassembly. It prints the time per packet,
+	 * the throughput and the uw-al buffers allocated per packet, that is
+	 * UwalBuffer and UwalData only: the allocations of the containers, of
+	 * the strings and of the packets are not counted. The reassembly slots,
+	 * the statistics and the PER list of the module are left untouched.
+	 * @param n Number of packets
+	 * @param ptype Type of the packets, which selects the headers serialized
+	 * by the packers of the payload
+	 * @param result Array filled with ns per packet, bytes per second and
+	 * uw-al buffers allocated per packet
+	 * @return false if the benchmark cannot be run
+	 */
+	bool benchmark(int n, packet_t ptype, double result[3]);
 
 	/**
 	 *  Method to start the packet transmission.
@@ -276,6 +343,7 @@ private:
 	double interframe_period; /**< Time period [s] between two successive frame
 								 to be sent down. */
 	double frame_set_validity; /**< Time of validity of a frame set */
+	int frame_set_pool; /**< Number of reassembly slots to preallocate */
 	int frame_padding; /**< Flag to determine if perfoming bit padding up to
 						  PSDU size. */
 	int force_endTx_; /**< 0 not force, otherwise force endTx*/
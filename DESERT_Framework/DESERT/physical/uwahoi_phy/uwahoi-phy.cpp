@@ -178,10 +178,7 @@ UwAhoiPhy::endRx(Packet *p)
 	hdr_MPhy *ph = HDR_MPHY(p);
 	hdr_mac *mach = HDR_MAC(p);
 	counter interferent_pkts;
-	static int mac_addr = -1;
-	ClMsgPhy2MacAddr msg;
-	sendSyncClMsg(&msg);
-	mac_addr = msg.getAddr();
+	int mac_addr = getMacAddr();
 	if (PktRx != 0) {
 		if (PktRx == p) {
 			double per_ni; // packet error rate due to noise and/or interference
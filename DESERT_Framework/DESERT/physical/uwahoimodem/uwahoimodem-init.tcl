@@ -36,3 +36,8 @@ Module/UW/UwModem/AHOI set stop_bit			1
 Module/UW/UwModem/AHOI set flow_control		0
 Module/UW/UwModem/AHOI set baud_rate		115200
 Module/UW/UwModem/AHOI set period_			0.1
+Module/UW/UwModem/AHOI set use_reactor		0
+Module/UW/UwModem/AHOI set event_wakeup		0
+Module/UW/UwModem/AHOI set queue_size		64
+Module/UW/UwModem/AHOI set log_queue_size		1024
+Module/UW/UwModem/AHOI set log_flush_period		0.1
@@ -33,10 +33,12 @@
 #include <uwahoimodem.h>
 #include <uwal.h>
 #include <uwphy-clmsg.h>
+#include <uwreactor.h>
 #include <uwserial.h>
 
 #include <algorithm>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <iterator>
 
@@ -78,14 +80,16 @@ UwAhoiModem::UwAhoiModem()
 	, tx_status(TransmissionState::TX_IDLE)
 	, status_m()
 	, tx_status_m()
-	, tx_queue_m()
 	, status_cv()
 	, tx_status_cv()
-	, tx_queue_cv()
 	, receiving(false)
 	, transmitting(false)
 	, rx_thread()
 	, tx_thread()
+	, tx_step(TxStep::NEXT_PACKET)
+	, tx_pck(NULL)
+	, tx_cmd()
+	, tx_retx(0)
 	, rx_payload("")
 	, virtual_time_ref(0.0)
 	, WAIT_DELIVERY(std::chrono::milliseconds(3000))
@@ -152,11 +156,15 @@ UwAhoiModem::recv(Packet *p)
 		ph->dstAntenna = 0;
 		ph->modulationType = getModulationType(p);
 
-		std::unique_lock<std::mutex> tx_lock(tx_queue_m);
-		tx_queue.push(p);
-		tx_lock.unlock();
+		if (!tx_queue.push(p)) {
+			printOnLog(LogLevel::ERROR, "AHOIMODEM", "recv::TX_QUEUE_FULL");
+			endTx(p);
+			return;
+		}
+		if (in_reactor) {
+			UwReactor::instance().post(p_connector.get());
+		}
 		printOnLog(LogLevel::DEBUG, "AHOIMODEM", "recv::PUSHING_IN_TX_QUEUE");
-		tx_queue_cv.notify_one();
 	}
 }
 
@@ -209,9 +217,11 @@ UwAhoiModem::startTx(Packet *p)
 				return tx_status == TransmissionState::TX_IDLE;
 			}))) {
 
-		printOnLog(LogLevel::DEBUG,
-		    "AHOIMODEM",
-			"startTx::SENDING_PACKET[" + std::to_string(n_retx) + "]");
+		if (getLogLevel() >= LogLevel::DEBUG) {
+			printOnLog(LogLevel::DEBUG,
+					"AHOIMODEM",
+					"startTx::SENDING_PACKET[" + std::to_string(n_retx) + "]");
+		}
 
 		tx_status = TransmissionState::TX_WAITING;
 
@@ -225,6 +235,120 @@ UwAhoiModem::startTx(Packet *p)
 	}
 }
 
+void
+UwAhoiModem::stepTx()
+{
+	// same sequence as transmittingData and startTx, where each wait returns
+	// to the reactor
+	std::lock(status_m, tx_status_m);
+	std::lock_guard<std::mutex> state_lock(status_m, std::adopt_lock);
+	std::lock_guard<std::mutex> tx_state_lock(tx_status_m, std::adopt_lock);
+
+	while (true) {
+		switch (tx_step) {
+		case TxStep::NEXT_PACKET:
+			if (!tx_queue.pop(tx_pck)) {
+				UwReactor::instance().cancelTimer(p_connector.get());
+				return;
+			}
+			tx_cmd = p_interpreter->buildSend(fillAhoiPkt(tx_pck));
+			tx_step = TxStep::WAIT_AVAILABLE;
+			waitTx(p_connector.get(), MODEM_TIMEOUT);
+			break;
+
+		case TxStep::WAIT_AVAILABLE:
+			if (status != ModemState::AVAILABLE) {
+				if (!txExpired()) {
+					return;
+				}
+				printOnLog(LogLevel::ERROR,
+						"AHOIMODEM",
+						"stepTx::FORCING_MODEM_AVAILABILITY");
+			}
+			status = ModemState::TRANSMITTING;
+			tx_step = TxStep::WAIT_TX_IDLE;
+			waitTx(p_connector.get(), WAIT_DELIVERY);
+			break;
+
+		case TxStep::WAIT_TX_IDLE:
+			if (tx_status != TransmissionState::TX_IDLE) {
+				if (!txExpired()) {
+					return;
+				}
+				printOnLog(LogLevel::DEBUG,
+						"AHOIMODEM",
+						"stepTx::FORCING_TX_STATUS_IDLE");
+			}
+			tx_status = TransmissionState::TX_WAITING;
+
+			printOnLog(LogLevel::DEBUG, "AHOIMODEM", "stepTx::SENDING_PACKET");
+			if (p_connector->writeToDevice(tx_cmd) < 0) {
+				printOnLog(LogLevel::ERROR,
+						"AHOIMODEM",
+						"stepTx::FAIL_TO_WRITE_TO_DEVICE::[" + tx_cmd + "]");
+				endStepTx();
+				break;
+			}
+			tx_retx = 1;
+			if (tx_retx > MAX_RETX) {
+				endStepTx();
+				break;
+			}
+			tx_step = TxStep::WAIT_CONFIRM;
+			waitTx(p_connector.get(),
+					std::chrono::milliseconds(WAIT_DELIVERY_INT));
+			break;
+
+		case TxStep::WAIT_CONFIRM:
+			if (tx_status == TransmissionState::TX_IDLE) {
+				endStepTx();
+				break;
+			}
+			if (!txExpired()) {
+				return;
+			}
+
+			// retry, since the tx_status did not slip to TX_IDLE
+			if (getLogLevel() >= LogLevel::DEBUG) {
+				printOnLog(LogLevel::DEBUG,
+						"AHOIMODEM",
+						"stepTx::SENDING_PACKET[" + std::to_string(tx_retx) +
+								"]");
+			}
+			tx_status = TransmissionState::TX_WAITING;
+			if (p_connector->writeToDevice(tx_cmd) < 0) {
+				printOnLog(LogLevel::ERROR,
+						"AHOIMODEM",
+						"stepTx::FAIL_TO_WRITE_TO_DEVICE::[" + tx_cmd + "]");
+				endStepTx();
+				break;
+			}
+			if (++tx_retx > MAX_RETX) {
+				endStepTx();
+				break;
+			}
+			waitTx(p_connector.get(),
+					std::chrono::milliseconds(WAIT_DELIVERY_INT));
+			break;
+		}
+	}
+}
+
+void
+UwAhoiModem::endStepTx()
+{
+	updateSN();
+
+	// schedule call to endTx in events queue
+	std::function<void(UwModem &, Packet * p)> callback =
+			&UwModem::realTxEnded;
+	ModemEvent e = {callback, tx_pck};
+	pushEvent(tx_events, e);
+
+	tx_pck = NULL;
+	tx_step = TxStep::NEXT_PACKET;
+}
+
 ahoi::packet_t
 UwAhoiModem::fillAhoiPkt(Packet *p)
 {
@@ -233,7 +357,7 @@ UwAhoiModem::fillAhoiPkt(Packet *p)
 
 	ahoi::packet_t packet = {0};
 
-	std::string payload(uwalh->binPkt(), uwalh->binPktLength());
+	std::string payload(hdr_uwal::binPkt(p), uwalh->binPktLength());
 
 	ahoi::header_t header;
 	header.src = (unsigned int)modemID;
@@ -304,16 +428,26 @@ UwAhoiModem::start()
 		exit(1);
 	}
 
+	resizeQueues();
+	startEventCheck();
+
 	// set flags to true so loops can start
 	receiving.store(true);
 	transmitting.store(true);
 
 	// spawn off threads
-	rx_thread = std::thread(&UwAhoiModem::receivingData, this);
-	tx_thread = std::thread(&UwAhoiModem::transmittingData, this);
-
-	checkTimer = new CheckTimer(this);
-	checkTimer->resched(period);
+	rx_len = 0;
+	in_reactor = use_reactor &&
+			UwReactor::instance().add(p_connector.get(),
+					std::bind(&UwAhoiModem::readAvailable, this),
+					std::bind(&UwAhoiModem::stepTx, this));
+	if (in_reactor) {
+		// send the packets queued before the start, if any
+		UwReactor::instance().post(p_connector.get());
+	} else {
+		rx_thread = std::thread(&UwAhoiModem::receivingData, this);
+		tx_thread = std::thread(&UwAhoiModem::transmittingData, this);
+	}
 
 	printOnLog(LogLevel::INFO, "AHOIMODEM", "start::STARTING_OPERATIONS");
 }
@@ -325,9 +459,18 @@ UwAhoiModem::stop()
 
 	receiving.store(false);
 	transmitting.store(false);
-	tx_queue_cv.notify_one();
+	tx_queue.wakeUp();
 	if (tx_thread.joinable())
 		tx_thread.join();
+	if (in_reactor) {
+		UwReactor::instance().remove(p_connector.get());
+		in_reactor = false;
+		if (tx_pck) {
+			Packet::free(tx_pck);
+			tx_pck = NULL;
+		}
+		tx_step = TxStep::NEXT_PACKET;
+	}
 	if (p_connector->isConnected() && !p_connector->closeConnection()) {
 		printOnLog(LogLevel::ERROR, "AHOIMODEM", "stop::CONNECTION_CLOSE_FAIL");
 	}
@@ -335,7 +478,8 @@ UwAhoiModem::stop()
 		rx_thread.join();
 	}
 
-	checkTimer->force_cancel();
+	stopEventCheck();
+	log_writer.close();
 }
 
 void
@@ -343,17 +487,11 @@ UwAhoiModem::transmittingData()
 {
 	while (transmitting.load()) {
 
-		std::unique_lock<std::mutex> tx_q_lock(tx_queue_m);
-		tx_queue_cv.wait(
-		    tx_q_lock, [&] { return !tx_queue.empty() || !transmitting; });
-		if (!transmitting) {
+		Packet *pck = NULL;
+		if (!tx_queue.waitPop(pck, transmitting)) {
 			break;
 		}
 
-		Packet *pck = tx_queue.front();
-		tx_queue.pop();
-		tx_q_lock.unlock();
-
 		if (pck) {
 
 			std::unique_lock<std::mutex> state_lock(status_m);
@@ -382,7 +520,7 @@ UwAhoiModem::transmittingData()
 		std::function<void(UwModem &, Packet * p)> callback =
 				&UwModem::realTxEnded;
 		ModemEvent e = {callback, pck};
-		event_q.push(e);
+		pushEvent(tx_events, e);
 
 		printOnLog(LogLevel::DEBUG, "AHOIMODEM",
 		    "transmittingData::BLOCKING_ON_NEXT_PACKET");
@@ -392,23 +530,9 @@ UwAhoiModem::transmittingData()
 void
 UwAhoiModem::receivingData()
 {
-	data_buffer.resize(DATA_BUFFER_LEN);
-	std::fill(data_buffer.begin(), data_buffer.end(), '\0');
-	// iterators that keep track of read/write operations
-	std::vector<char>::iterator beg_it = data_buffer.begin();
-	std::vector<char>::iterator end_it = data_buffer.begin();
-	// iterators that keep track of commands research
-	std::vector<char>::iterator cmd_b = data_buffer.begin();
-	std::vector<char>::iterator cmd_e = data_buffer.begin();
-	int r_bytes = 0; // bytes read from the device interface
-	int offset = 0; // offset to not overwrite unparsed data
-
-	std::shared_ptr<ahoi::packet_t> pck = std::make_shared<ahoi::packet_t>();
-
 	while (receiving.load()) {
 
-		r_bytes = p_connector->readFromDevice(
-				&(*end_it), MAX_READ_BYTES - offset);
+		int r_bytes = readRx(p_connector.get());
 
 		if (r_bytes < 0) {
 			if (p_connector->getErrno() != 0) {
@@ -416,34 +540,66 @@ UwAhoiModem::receivingData()
 						"AHOIMODEM",
 						strerror(p_connector->getErrno()));
 			}
-			r_bytes = 0;
+		} else if (r_bytes > 0) {
+			parseRx();
 		}
+	}
+}
 
-		end_it += r_bytes;
-
-		while (p_interpreter->findResponse(
-		    beg_it, end_it, cmd_b, cmd_e) != "") {
+void
+UwAhoiModem::readAvailable()
+{
+	while (readRx(p_connector.get()) > 0) {
+		parseRx();
+	}
+	stepTx();
+}
 
-			offset = std::distance(cmd_e, end_it);
+void
+UwAhoiModem::parseRx()
+{
+	std::vector<char>::iterator beg_it = data_buffer.begin();
+	std::vector<char>::iterator end_it = beg_it + rx_len;
+	// first byte not parsed yet
+	std::vector<char>::iterator left_it = beg_it;
+	// iterators that keep track of commands research
+	std::vector<char>::iterator cmd_b = beg_it;
+	std::vector<char>::iterator cmd_e = beg_it;
 
-			p_interpreter->fixEscapes(data_buffer, cmd_b, cmd_e);
+	std::shared_ptr<ahoi::packet_t> pck;
 
-			if ((pck = p_interpreter->parseResponse(cmd_b, cmd_e)) != nullptr) {
+	while (p_interpreter->findResponse(left_it, end_it, cmd_b, cmd_e) != "") {
 
-				updateStatus(pck);
-				printOnLog(LogLevel::DEBUG,
-						   "AHOIMODEM",
-						   "receivingData::RX_MSG=" + std::string(cmd_b, cmd_e));
-			}
+		// escapes are removed from a copy, so that data_buffer keeps its
+		// layout
+		std::vector<char> rsp(cmd_b, cmd_e);
+		std::vector<char>::iterator rsp_b = rsp.begin();
+		std::vector<char>::iterator rsp_e = rsp.end();
+		p_interpreter->fixEscapes(rsp, rsp_b, rsp_e);
 
-			offset = std::distance(cmd_e, end_it);
-			std::copy(cmd_e, end_it, beg_it);
-			std::fill(beg_it + offset, end_it, '\0');
-			end_it = beg_it + offset;
+		if ((pck = p_interpreter->parseResponse(rsp.begin(), rsp.end())) !=
+				nullptr) {
 
-			pck.reset();
+			updateStatus(pck);
+			printOnLog(LogLevel::DEBUG,
+					"AHOIMODEM",
+					"receivingData::RX_MSG=",
+					rsp.data(),
+					rsp.size());
 		}
+
+		left_it = cmd_e;
+		pck.reset();
+	}
+
+	// cmd_b is the beginning of a response not complete yet, if any
+	if (cmd_b > left_it) {
+		left_it = cmd_b;
 	}
+
+	// move the bytes left after parsing to the beginning
+	rx_len = std::distance(left_it, end_it);
+	std::copy(left_it, end_it, beg_it);
 }
 
 void
@@ -451,8 +607,9 @@ UwAhoiModem::createRxPacket(Packet *p)
 {
 	hdr_uwal *uwalh = HDR_UWAL(p);
 	uwalh->binPktLength() = rx_payload.size();
-	std::memset(uwalh->binPkt(), 0, uwalh->binPktLength());
-	std::copy(rx_payload.begin(), rx_payload.end(), uwalh->binPkt());
+	char *binPkt = hdr_uwal::writableBinPkt(p);
+	std::memset(binPkt, 0, uwalh->binPktLength());
+	std::copy(rx_payload.begin(), rx_payload.end(), binPkt);
 	HDR_CMN(p)->direction() = hdr_cmn::UP;
 	rx_payload = "";  // clean up the rx payload string
 }
@@ -479,8 +636,11 @@ UwAhoiModem::storePacketInfo(std::shared_ptr<ahoi::packet_t> packet, Packet *p)
 		agc_min = footer.agcMin;
 		agc_max = footer.agcMax;
 
-		printOnLog(LogLevel::INFO,
-			"AHOIMODEM", "storePacketInfo::PAYLOAD[" + rx_payload + "]");
+		if (getLogLevel() >= LogLevel::INFO) {
+			printOnLog(LogLevel::INFO,
+					"AHOIMODEM",
+					"storePacketInfo::PAYLOAD[" + rx_payload + "]");
+		}
 	}
 
 	return true;
@@ -516,13 +676,15 @@ UwAhoiModem::updateStatus(std::shared_ptr<ahoi::packet_t> packet)
 				"updateStatus::UNKNOWN_COMMAND_RECEIVED");
 	}
 
-	std::string dbg_str = std::string("updateStatus::HEADER::") +
-			"[SRC::" + std::to_string((packet->header).src) +
-			"][DST::" + std::to_string((packet->header).dst) +
-			"][TYP::" + std::to_string((packet->header).type) +
-			"][DSN::" + std::to_string((packet->header).dsn) +
-		    "][LEN::" + std::to_string((packet->header).len) + "]";
-	printOnLog(LogLevel::DEBUG, "AHOIMODEM", dbg_str);
+	if (getLogLevel() >= LogLevel::DEBUG) {
+		std::string dbg_str = std::string("updateStatus::HEADER::") +
+				"[SRC::" + std::to_string((packet->header).src) +
+				"][DST::" + std::to_string((packet->header).dst) +
+				"][TYP::" + std::to_string((packet->header).type) +
+				"][DSN::" + std::to_string((packet->header).dsn) +
+				"][LEN::" + std::to_string((packet->header).len) + "]";
+		printOnLog(LogLevel::DEBUG, "AHOIMODEM", dbg_str);
+	}
 
 	std::lock(status_m, tx_status_m);
 	std::unique_lock<std::mutex> state_lock(status_m, std::adopt_lock);
@@ -546,7 +708,7 @@ UwAhoiModem::updateStatus(std::shared_ptr<ahoi::packet_t> packet)
 			  std::function<void(UwModem &, Packet * p)> callback =
 				&UwModem::recv;
 			  ModemEvent e = {callback, p};
-			  event_q.push(e);
+			  pushEvent(rx_events, e);
 
 			}
 
@@ -71,6 +71,22 @@ public:
 	 */
 	enum class TransmissionState { TX_IDLE = 0, TX_WAITING };
 
+	/**
+	 * Step of a transmission running on the UwReactor thread, i.e., of the
+	 * waits done by transmittingData() and startTx() in the transmitting
+	 * thread.
+	 * NEXT_PACKET: no transmission in progress
+	 * WAIT_AVAILABLE: waiting for the modem to become available
+	 * WAIT_TX_IDLE: waiting for the previous packet to be confirmed
+	 * WAIT_CONFIRM: the packet was written, waiting for its confirmation
+	 */
+	enum class TxStep {
+		NEXT_PACKET,
+		WAIT_AVAILABLE,
+		WAIT_TX_IDLE,
+		WAIT_CONFIRM
+	};
+
 	/**
 	 * Constructor of the UwAhoiModem class
 	 * @param address string containing the address to connect to
@@ -119,6 +135,20 @@ private:
 	 */
 	virtual void startTx(Packet *p);
 
+	/**
+	 * Method called on the UwReactor thread when a packet is queued, when a
+	 * response is parsed and when the wait of the transmission expires: it
+	 * advances the transmission in progress as far as it can without
+	 * waiting, and starts the following ones.
+	 */
+	void stepTx();
+
+	/**
+	 * Method that ends the transmission in progress on the UwReactor thread,
+	 * scheduling the call to endTx.
+	 */
+	void endStepTx();
+
 	/**
 	 * Method that starts a packet reception. This method is also in charge of
 	 * sending a ClMsg, Phy2MacStartRx(p), to notify the upper layers of
@@ -157,6 +187,19 @@ private:
 	 */
 	virtual void receivingData();
 
+	/**
+	 * Method called by the UwReactor when the connector is readable: reads
+	 * and parses all the data available.
+	 */
+	void readAvailable();
+
+	/**
+	 * Method that parses the responses found in the first rx_len bytes of
+	 * data_buffer. The bytes of a response not yet complete are moved to
+	 * the beginning of the buffer, to be parsed after the next read.
+	 */
+	void parseRx();
+
 	/**
 	 * Method that updates the status of the modem State Machine: state change
 	 * is triggered by recepting the response packet from the ahoi! modem on the
@@ -215,14 +258,10 @@ private:
 	std::mutex status_m;
 	/** Mutex associated with the state machine of the transmission process */
 	std::mutex tx_status_m;
-	/** Mutex associated with the transmission queue */
-	std::mutex tx_queue_m;
 	/** Condition variable to wait for ModemState::AVAILABLE */
 	std::condition_variable status_cv;
 	/** Condition variable to wait for TransmissionState::TX_IDLE */
 	std::condition_variable tx_status_cv;
-	/** Condition variable that is linked with the transmitting queue */
-	std::condition_variable tx_queue_cv;
 	/** Atomic boolean variable that controls the receiving looping thread */
 	std::atomic<bool> receiving;
 	/** Atomic boolean variable that controls the transmitting looping thread */
@@ -231,6 +270,14 @@ private:
 	std::thread rx_thread;
 	/** Object with the tx thread */
 	std::thread tx_thread;
+	/** Step of the transmission running on the UwReactor thread */
+	TxStep tx_step;
+	/** Packet being transmitted on the UwReactor thread */
+	Packet *tx_pck;
+	/** Command of the packet being transmitted on the UwReactor thread */
+	std::string tx_cmd;
+	/** Number of the next retransmission on the UwReactor thread */
+	uint tx_retx;
 	/** String that is updated witn each new received messsage */
 	std::string rx_payload;
 	/** Maximum time to wait for modem to become ModemState::AVAILABLE */
@@ -0,0 +1,105 @@
+//
+// Copyright (c) 2018 Regents of the SIGNET lab, University of Padova.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. Neither the name of the University of Padova (SIGNET lab) nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file    uwconnector.cpp
+ * @version 1.0.0
+ * @brief   Output queue of the connectors used in non blocking mode.
+ */
+
+#include <uwconnector.h>
+#include <uwreactor.h>
+
+#include <cerrno>
+
+bool
+UwConnector::queueWrite(const std::string &msg, int &written)
+{
+	std::lock_guard<std::mutex> lock(pending_m);
+
+	if (reactor == NULL) {
+		return false;
+	}
+
+	written = msg.size();
+	size_t off = 0;
+	if (pending.empty()) {
+		int n = writeRaw(msg.data(), msg.size());
+		if (n < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+				local_errno = errno;
+				written = -1;
+				return true;
+			}
+			n = 0;
+		}
+		if (static_cast<size_t>(n) == msg.size()) {
+			return true;
+		}
+		off = n;
+	}
+
+	pending.push_back(msg);
+	if (pending.size() == 1) {
+		pending_off = off;
+		reactor->watchWrite(this, true);
+	}
+	return true;
+}
+
+bool
+UwConnector::flushPending()
+{
+	std::lock_guard<std::mutex> lock(pending_m);
+
+	while (!pending.empty()) {
+		const std::string &msg = pending.front();
+		int n = writeRaw(msg.data() + pending_off, msg.size() - pending_off);
+		if (n < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				return false;
+			}
+			// the device is not usable: the output is dropped
+			local_errno = errno;
+			pending.clear();
+			pending_off = 0;
+			break;
+		}
+		pending_off += n;
+		if (pending_off < msg.size()) {
+			return false;
+		}
+		pending.pop_front();
+		pending_off = 0;
+	}
+
+	if (reactor != NULL) {
+		reactor->watchWrite(this, false);
+	}
+	return true;
+}
@@ -38,9 +38,15 @@
 #define UWCONNECTOR_H
 
 #include <array>
+#include <cerrno>
+#include <deque>
+#include <mutex>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
+class UwReactor;
+
 /**
  * Class UwConnector allows to specify an interface between the UwDriver object
  * and the device. The connector is typically a TCP or UDP connection, but
@@ -56,7 +62,13 @@ public:
 	 * UwConnector constructor
 	 * @param address string representing an address, whatever that is
 	 */
-	inline UwConnector(){};
+	inline UwConnector()
+		: local_errno(0)
+		, reactor(NULL)
+		, reactor_id(0)
+		, pending_m()
+		, pending()
+		, pending_off(0){};
 
 	/**
 	 * UwConnector destructor
@@ -128,9 +140,61 @@ public:
 	 */
 	virtual const bool isConnected() = 0;
 
+	/**
+	 * Returns the file descriptor of the connection, to be watched by a
+	 * UwReactor
+	 * @return the file descriptor, -1 if the connector has none
+	 */
+	virtual int
+	getFd()
+	{
+		return -1;
+	};
+
+	/**
+	 * Writes the output queued while the connector is in non blocking mode,
+	 * as far as the device accepts it. Called by the UwReactor when the
+	 * device is writable.
+	 * @return true if no output is left
+	 */
+	bool flushPending();
+
 protected:
+	/**
+	 * Single write to the device, without retries. Needed to use the
+	 * connector with a UwReactor.
+	 * @param buf data to write
+	 * @param len number of bytes to write
+	 * @return number of bytes written, -1 on error with errno set
+	 */
+	virtual int
+	writeRaw(const char *, size_t)
+	{
+		errno = ENOTSUP;
+		return -1;
+	}
+
+	/**
+	 * Write in non blocking mode, i.e., when the connector is watched by a
+	 * UwReactor: what the device does not accept at once is queued, and
+	 * written by the reactor as soon as the device is writable.
+	 * @param msg data to write
+	 * @param written set to the number of bytes accepted
+	 * @return false if the connector is in blocking mode, and the write is
+	 *         up to the caller
+	 */
+	bool queueWrite(const std::string &msg, int &written);
 
 	int local_errno; /** Local variable to stoe the errno of connectors */
+
+private:
+	friend class UwReactor;
+
+	UwReactor *reactor; /** Reactor watching the connector, NULL if none */
+	uint64_t reactor_id; /** Identifier of the connector in the reactor */
+	std::mutex pending_m; /** Mutex for the reactor and the pending output */
+	std::deque<std::string> pending; /** Output not yet written */
+	size_t pending_off; /** Bytes of the first pending message written */
 };
 
 #endif
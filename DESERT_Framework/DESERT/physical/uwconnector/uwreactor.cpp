@@ -0,0 +1,347 @@
+//
+// Copyright (c) 2018 Regents of the SIGNET lab, University of Padova.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. Neither the name of the University of Padova (SIGNET lab) nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file    uwreactor.cpp
+ * @version 1.0.0
+ * @brief   Implementation of the UwReactor class.
+ */
+
+#include <uwreactor.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+const int UwReactor::MAX_EVENTS = 32;
+
+UwReactor &
+UwReactor::instance()
+{
+	static UwReactor reactor;
+	return reactor;
+}
+
+UwReactor::UwReactor()
+	: epoll_fd(-1)
+	, wake_fd(-1)
+	, thread()
+	, running(false)
+	, entries_m()
+	, entries()
+	, next_id(1)
+	, posted_m()
+	, posted()
+{
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (epoll_fd < 0 || wake_fd < 0) {
+		std::cerr << "UWREACTOR::ERROR::" + std::to_string(errno) << std::endl;
+		return;
+	}
+
+	struct epoll_event ev;
+	std::memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.u64 = 0;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev) < 0) {
+		std::cerr << "UWREACTOR::ERROR::" + std::to_string(errno) << std::endl;
+	}
+}
+
+UwReactor::~UwReactor()
+{
+	if (thread.joinable()) {
+		running.store(false);
+		uint64_t one = 1;
+		if (write(wake_fd, &one, sizeof(one)) < 0) {
+			std::cerr << "UWREACTOR::ERROR::" + std::to_string(errno)
+					  << std::endl;
+		}
+		thread.join();
+	}
+	if (wake_fd >= 0)
+		close(wake_fd);
+	if (epoll_fd >= 0)
+		close(epoll_fd);
+}
+
+bool
+UwReactor::add(UwConnector *conn, Handler on_readable, Handler on_tx)
+{
+	int fd = conn->getFd();
+	if (fd < 0 || epoll_fd < 0) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(entries_m);
+
+	uint64_t id = next_id++;
+	int flags = fcntl(fd, F_GETFL, 0);
+	if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+		std::cerr << "UWREACTOR::ERROR::" + std::to_string(errno) << std::endl;
+		return false;
+	}
+	{
+		std::lock_guard<std::mutex> p_lock(conn->pending_m);
+		conn->reactor = this;
+		conn->reactor_id = id;
+	}
+	Entry e = {conn,
+			fd,
+			on_readable,
+			on_tx,
+			false,
+			std::chrono::steady_clock::time_point()};
+	std::unordered_map<uint64_t, Entry>::iterator it =
+			entries.insert(std::make_pair(id, e)).first;
+
+	struct epoll_event ev;
+	std::memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN | EPOLLRDHUP;
+	ev.data.u64 = id;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+		std::cerr << "UWREACTOR::ERROR::" + std::to_string(errno) << std::endl;
+		detach(it);
+		return false;
+	}
+
+	if (!thread.joinable()) {
+		running.store(true);
+		thread = std::thread(&UwReactor::run, this);
+	}
+	return true;
+}
+
+void
+UwReactor::remove(UwConnector *conn)
+{
+	std::lock_guard<std::mutex> lock(entries_m);
+
+	for (std::unordered_map<uint64_t, Entry>::iterator it = entries.begin();
+			it != entries.end();
+			++it) {
+		if (it->second.conn == conn) {
+			detach(it);
+			return;
+		}
+	}
+}
+
+void
+UwReactor::post(UwConnector *conn)
+{
+	{
+		std::lock_guard<std::mutex> lock(posted_m);
+		posted.push_back(conn->reactor_id);
+	}
+	uint64_t one = 1;
+	if (write(wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+		std::cerr << "UWREACTOR::ERROR::" + std::to_string(errno) << std::endl;
+	}
+}
+
+void
+UwReactor::setTimer(UwConnector *conn, std::chrono::milliseconds delay)
+{
+	// called by a handler, i.e., with entries_m held by the reactor thread
+	std::unordered_map<uint64_t, Entry>::iterator it =
+			entries.find(conn->reactor_id);
+	if (it != entries.end()) {
+		it->second.timer_set = true;
+		it->second.deadline = std::chrono::steady_clock::now() + delay;
+	}
+}
+
+void
+UwReactor::cancelTimer(UwConnector *conn)
+{
+	std::unordered_map<uint64_t, Entry>::iterator it =
+			entries.find(conn->reactor_id);
+	if (it != entries.end()) {
+		it->second.timer_set = false;
+	}
+}
+
+void
+UwReactor::watchWrite(UwConnector *conn, bool enable)
+{
+	struct epoll_event ev;
+	std::memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN | EPOLLRDHUP;
+	if (enable)
+		ev.events |= EPOLLOUT;
+	ev.data.u64 = conn->reactor_id;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, conn->getFd(), &ev) < 0) {
+		std::cerr << "UWREACTOR::ERROR::" + std::to_string(errno) << std::endl;
+	}
+}
+
+void
+UwReactor::detach(std::unordered_map<uint64_t, Entry>::iterator it)
+{
+	Entry &e = it->second;
+
+	// the connector may have been closed already
+	epoll_ctl(epoll_fd, EPOLL_CTL_DEL, e.fd, NULL);
+	{
+		std::lock_guard<std::mutex> p_lock(e.conn->pending_m);
+		e.conn->reactor = NULL;
+		e.conn->pending.clear();
+		e.conn->pending_off = 0;
+	}
+	if (e.conn->getFd() == e.fd) {
+		int flags = fcntl(e.fd, F_GETFL, 0);
+		if (flags >= 0)
+			fcntl(e.fd, F_SETFL, flags & ~O_NONBLOCK);
+	}
+	entries.erase(it);
+}
+
+int
+UwReactor::nextTimeout()
+{
+	std::lock_guard<std::mutex> lock(entries_m);
+
+	bool found = false;
+	std::chrono::steady_clock::time_point earliest;
+	for (std::unordered_map<uint64_t, Entry>::iterator it = entries.begin();
+			it != entries.end();
+			++it) {
+		if (it->second.timer_set && (!found || it->second.deadline < earliest)) {
+			earliest = it->second.deadline;
+			found = true;
+		}
+	}
+	if (!found) {
+		return -1;
+	}
+
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (earliest <= now) {
+		return 0;
+	}
+	// rounded up, not to wake up before the deadline
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+				   earliest - now)
+				   .count() +
+			1;
+}
+
+void
+UwReactor::runPosted()
+{
+	std::vector<uint64_t> ids;
+	{
+		std::lock_guard<std::mutex> lock(posted_m);
+		ids.swap(posted);
+	}
+
+	std::lock_guard<std::mutex> lock(entries_m);
+	for (size_t i = 0; i < ids.size(); i++) {
+		std::unordered_map<uint64_t, Entry>::iterator it = entries.find(ids[i]);
+		if (it != entries.end() && it->second.on_tx) {
+			it->second.on_tx();
+		}
+	}
+}
+
+void
+UwReactor::runTimers()
+{
+	std::lock_guard<std::mutex> lock(entries_m);
+
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	for (std::unordered_map<uint64_t, Entry>::iterator it = entries.begin();
+			it != entries.end();
+			++it) {
+		Entry &e = it->second;
+		if (e.timer_set && e.deadline <= now) {
+			e.timer_set = false;
+			if (e.on_tx) {
+				e.on_tx();
+			}
+		}
+	}
+}
+
+void
+UwReactor::run()
+{
+	struct epoll_event events[MAX_EVENTS];
+
+	while (running.load()) {
+		int n = epoll_wait(epoll_fd, events, MAX_EVENTS, nextTimeout());
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			std::cerr << "UWREACTOR::ERROR::" + std::to_string(errno)
+					  << std::endl;
+			break;
+		}
+
+		for (int i = 0; i < n; i++) {
+			uint64_t id = events[i].data.u64;
+			uint32_t ev = events[i].events;
+
+			if (id == 0) {
+				uint64_t count;
+				while (read(wake_fd, &count, sizeof(count)) > 0)
+					;
+				runPosted();
+				continue;
+			}
+
+			std::lock_guard<std::mutex> lock(entries_m);
+			std::unordered_map<uint64_t, Entry>::iterator it = entries.find(id);
+			if (it == entries.end()) {
+				continue; // removed after epoll_wait returned
+			}
+
+			if (ev & EPOLLOUT) {
+				it->second.conn->flushPending();
+			}
+			if (ev & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+				it->second.on_readable();
+			}
+			if (ev & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+				// the handler has read what was left: stop watching the
+				// connector, or the event would be reported forever
+				std::cerr << "UWREACTOR::CONNECTION_CLOSED::" << it->second.fd
+						  << std::endl;
+				detach(it);
+			}
+		}
+
+		runTimers();
+	}
+}
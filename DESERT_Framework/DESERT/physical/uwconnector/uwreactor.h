@@ -0,0 +1,192 @@
+//
+// Copyright (c) 2018 Regents of the SIGNET lab, University of Padova.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. Neither the name of the University of Padova (SIGNET lab) nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file    uwreactor.h
+ * @version 1.0.0
+ * @brief   Single thread, epoll based, serving the I/O of many connectors.
+ */
+
+#ifndef UWREACTOR_H
+#define UWREACTOR_H
+
+#include <uwconnector.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Class UwReactor watches the file descriptors of many UwConnector objects
+ * with a single epoll instance and a single thread, in place of a receiving
+ * and a transmitting thread per connector. When a connector is readable its
+ * handler is called, and it is expected to read with readFromDevice until no
+ * data is left, since the connector is switched to non blocking mode. The
+ * output that a connector cannot write at once is kept and written when the
+ * device is writable. The transmissions are driven by a second handler,
+ * called when another thread posts new data to send (see post()) and when
+ * the timer of the connector expires (see setTimer()), so that the waits on
+ * the device responses never block the thread.
+ * A process has a single reactor, see UwReactor::instance().
+ */
+class UwReactor
+{
+
+public:
+	/**
+	 * Function called by the reactor thread on the events of a connector
+	 */
+	typedef std::function<void()> Handler;
+
+	/**
+	 * Returns the reactor of the process, creating it at the first call
+	 * @return the reactor
+	 */
+	static UwReactor &instance();
+
+	/**
+	 * Starts watching a connected connector, switching it to non blocking
+	 * mode. The reactor thread is started by the first call.
+	 * @param conn connector to watch
+	 * @param on_readable handler called when conn is readable; it must not
+	 *        call remove()
+	 * @param on_tx handler called after post() and when the timer expires;
+	 *        it must not call remove()
+	 * @return true if the connector is watched, false otherwise
+	 */
+	bool add(UwConnector *conn, Handler on_readable,
+			Handler on_tx = Handler());
+
+	/**
+	 * Stops watching a connector, and switches it back to blocking mode.
+	 * On return, the handler of the connector is not running and is not
+	 * called anymore. The output still pending is discarded.
+	 * @param conn connector to remove
+	 */
+	void remove(UwConnector *conn);
+
+	/**
+	 * Asks the reactor thread to call the on_tx handler of a connector.
+	 * It can be called by any thread, e.g., after queueing a packet.
+	 * @param conn connector watched by the reactor
+	 */
+	void post(UwConnector *conn);
+
+	/**
+	 * Arms the timer of a connector, replacing the previous deadline: the
+	 * on_tx handler is called when the delay has elapsed. To be called by
+	 * the handlers of the connector only.
+	 * @param conn connector watched by the reactor
+	 * @param delay time after which on_tx is called
+	 */
+	void setTimer(UwConnector *conn, std::chrono::milliseconds delay);
+
+	/**
+	 * Disarms the timer of a connector. To be called by the handlers of the
+	 * connector only.
+	 * @param conn connector watched by the reactor
+	 */
+	void cancelTimer(UwConnector *conn);
+
+	/**
+	 * Enables or disables the writability events of a connector, while its
+	 * pending output is not empty. Called by the connector.
+	 * @param conn connector
+	 * @param enable true to enable the events, false to disable them
+	 */
+	void watchWrite(UwConnector *conn, bool enable);
+
+private:
+	/**
+	 * Connector watched by the reactor
+	 */
+	struct Entry {
+		UwConnector *conn; /** Connector */
+		int fd; /** File descriptor of the connector */
+		Handler on_readable; /** Handler of the received data */
+		Handler on_tx; /** Handler of the transmissions */
+		bool timer_set; /** True if the timer is armed */
+		std::chrono::steady_clock::time_point deadline; /** Timer expiry */
+	};
+
+	/**
+	 * UwReactor constructor, see instance()
+	 */
+	UwReactor();
+
+	/**
+	 * UwReactor destructor: stops the thread
+	 */
+	~UwReactor();
+
+	/**
+	 * Loop of the reactor thread
+	 */
+	void run();
+
+	/**
+	 * Stops watching the connector of an entry
+	 * @param it entry to remove
+	 */
+	void detach(std::unordered_map<uint64_t, Entry>::iterator it);
+
+	/**
+	 * Returns the time to wait for the earliest timer to expire
+	 * @return timeout of epoll_wait, in milliseconds, -1 if no timer is armed
+	 */
+	int nextTimeout();
+
+	/**
+	 * Calls the on_tx handlers of the connectors posted since the last call
+	 */
+	void runPosted();
+
+	/**
+	 * Calls the on_tx handlers of the connectors whose timer has expired
+	 */
+	void runTimers();
+
+	int epoll_fd; /** epoll instance */
+	int wake_fd; /** eventfd used to wake up the thread */
+	std::thread thread; /** Reactor thread */
+	std::atomic<bool> running; /** Flag to keep the thread running */
+	std::mutex entries_m; /** Mutex held while a handler runs */
+	std::unordered_map<uint64_t, Entry> entries; /** Watched connectors */
+	uint64_t next_id; /** Identifier of the next connector, 0 is wake_fd */
+	std::mutex posted_m; /** Mutex for the posted connectors */
+	std::vector<uint64_t> posted; /** Connectors whose on_tx is to be called */
+
+	static const int MAX_EVENTS; /** Events handled by each epoll_wait */
+};
+
+#endif
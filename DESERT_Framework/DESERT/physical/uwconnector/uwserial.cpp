@@ -96,6 +96,11 @@ UwSerial::closeConnection()
 int
 UwSerial::writeToDevice(const std::string& msg)
 {
+	int w_bytes = 0;
+	if (queueWrite(msg, w_bytes)) {
+		return w_bytes;
+	}
+
 	if (serialfd > 0) {
 		int s_bytes = write(serialfd, msg.c_str(), msg.size());
 		if (s_bytes >= static_cast<int>(msg.size())) {
@@ -105,6 +110,16 @@ UwSerial::writeToDevice(const std::string& msg)
 	return 0;
 }
 
+int
+UwSerial::writeRaw(const char *buf, size_t len)
+{
+	if (serialfd <= 0) {
+		errno = EBADF;
+		return -1;
+	}
+	return write(serialfd, buf, len);
+}
+
 int
 UwSerial::readFromDevice(void *wpos, int maxlen)
 {
@@ -98,6 +98,16 @@ public:
 	 */
 	virtual int readFromDevice(void *wpos, int maxlen);
 
+	/**
+	 * Returns the file descriptor of the serial port
+	 * @return the serial port descriptor, -1 if not connected
+	 */
+	virtual int
+	getFd()
+	{
+		return serialfd;
+	};
+
 	/**
 	 * Method that loads the termios struct with the serial port parameters.
 	 * @param path const std::string with address and flag
@@ -111,6 +121,15 @@ public:
 	 */
 	virtual bool refreshConnection(const std::string &path);
 
+protected:
+	/**
+	 * Single write to the serial port, without retries
+	 * @param buf data to write
+	 * @param len number of bytes to write
+	 * @return number of bytes written, -1 on error
+	 */
+	virtual int writeRaw(const char *buf, size_t len);
+
 private:
 	/**
 	 * Integer value that stores the serial port descriptor as generated by the
@@ -285,6 +285,11 @@ UwSocket::closeConnection()
 int
 UwSocket::writeToDevice(const std::string& msg)
 {
+	int w_bytes = 0;
+	if (queueWrite(msg, w_bytes)) {
+		return w_bytes;
+	}
+
 	if (proto == Transport::TCP) {
 
 		if (socketfd > 0) {
@@ -313,6 +318,21 @@ UwSocket::writeToDevice(const std::string& msg)
 	}
 }
 
+int
+UwSocket::writeRaw(const char *buf, size_t len)
+{
+	if (socketfd <= 0) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (proto == Transport::TCP) {
+		return send(socketfd, buf, len, MSG_NOSIGNAL);
+	}
+	return sendto(socketfd, buf, len, 0,
+			(const struct sockaddr *) &cl_addr, sizeof(cl_addr));
+}
+
 int
 UwSocket::readFromDevice(void *wpos, int maxlen)
 {
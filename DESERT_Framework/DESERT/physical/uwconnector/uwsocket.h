@@ -115,6 +115,16 @@ public:
 	 */
 	virtual int readFromDevice(void *wpos, int maxlen);
 
+	/**
+	 * Returns the file descriptor of the socket
+	 * @return the socket descriptor, -1 if not connected
+	 */
+	virtual int
+	getFd()
+	{
+		return socketfd;
+	};
+
 	/**
 	 * Method that sets TCP as transport protocol
 	 */
@@ -141,6 +151,15 @@ public:
 		isClient = false;
 	};
 
+protected:
+	/**
+	 * Single send to the socket, without retries
+	 * @param buf data to send
+	 * @param len number of bytes to send
+	 * @return number of bytes sent, -1 on error
+	 */
+	virtual int writeRaw(const char *buf, size_t len);
+
 private:
 	/**
 	 * Integer value that stores the socket descriptor as generated by the
@@ -33,3 +33,8 @@ Module/UW/UwModem/EvoLogicsS2C set debug_    0
 Module/UW/UwModem/EvoLogicsS2C set period_    0.1
 Module/UW/UwModem/EvoLogicsS2C set max_read_size    2000
 Module/UW/UwModem/EvoLogicsS2C set buffer_size    2000
+Module/UW/UwModem/EvoLogicsS2C set use_reactor    0
+Module/UW/UwModem/EvoLogicsS2C set event_wakeup    0
+Module/UW/UwModem/EvoLogicsS2C set queue_size    64
+Module/UW/UwModem/EvoLogicsS2C set log_queue_size    1024
+Module/UW/UwModem/EvoLogicsS2C set log_flush_period    0.1
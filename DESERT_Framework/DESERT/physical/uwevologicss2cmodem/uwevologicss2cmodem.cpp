@@ -32,9 +32,12 @@
 #include <uwal.h>
 #include <uwevologicss2cmodem.h>
 #include <uwphy-clmsg.h>
+#include <uwreactor.h>
 #include <uwsocket.h>
 
+#include <algorithm>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <string>
@@ -79,15 +82,19 @@ UwEvoLogicsS2CModem::UwEvoLogicsS2CModem()
 	, tx_status(TransmissionState::TX_IDLE)
 	, status_m()
 	, tx_status_m()
-	, tx_queue_m()
 	, status_cv()
 	, tx_status_cv()
-	, tx_queue_cv()
 	, receiving(false)
 	, transmitting(false)
 	, im_status_updated(false)
 	, rx_thread()
 	, tx_thread()
+	, tx_step(TxStep::NEXT_PACKET)
+	, tx_pck(NULL)
+	, tx_cmd()
+	, tx_polls(0)
+	, rx_payload(NULL)
+	, rx_payload_len(0)
 	, tx_mode(TransmissionMode::IM)
 	, ack_mode(false)
 	, curr_source_level(3)
@@ -141,13 +148,17 @@ UwEvoLogicsS2CModem::recv(Packet *p)
 		ph->modulationType = getModulationType(p);
 		ph->duration = getTxDuration(p);
 
-		std::unique_lock<std::mutex> tx_lock(tx_queue_m);
-		tx_queue.push(p);
-		tx_lock.unlock();
+		if (!tx_queue.push(p)) {
+			printOnLog(LogLevel::ERROR, "EVOLOGICSS2CMODEM", "recv::TX_QUEUE_FULL");
+			endTx(p);
+			return;
+		}
+		if (in_reactor) {
+			UwReactor::instance().post(p_connector.get());
+		}
 		printOnLog(LogLevel::DEBUG,
 				"EVOLOGICSS2CMODEM",
 				"recv::PUSHING_IN_TX_QUEUE");
-		tx_queue_cv.notify_one();
 	}
 }
 
@@ -293,7 +304,7 @@ UwEvoLogicsS2CModem::configure(Config cmd)
 		if (!p_connector->writeToDevice(config_cmd)) {
 			printOnLog(LogLevel::ERROR,
 					   "EVOLOGICSS2CMODEM",
-					   "configure::FAIL_TO_WRITE_TO_DEVICE=" + config_cmd);
+					   "configure::FAIL_TO_WRITE_TO_DEVICE=", config_cmd);
 			return false;
 		}
 
@@ -314,23 +325,11 @@ UwEvoLogicsS2CModem::startTx(Packet *p)
 {
 	// this method does nothing in ns, so it can be called from an
 	// external thread
-	// save MAC and AL headers and write payload
-	hdr_mac *mach = HDR_MAC(p);
-	hdr_uwal *uwalh = HDR_UWAL(p);
-	std::string payload;
-	payload.assign(uwalh->binPkt(), uwalh->binPktLength());
-
-	// build command to perform a SEND or SENDIM
-	std::string cmd_s;
-	if (tx_mode == TransmissionMode::IM) {
-		cmd_s = p_interpreter->buildSendIM(payload, mach->macDA(), ack_mode);
-	} else {
-		cmd_s = p_interpreter->buildSend(payload, mach->macDA());
-	}
+	std::string cmd_s = buildTxCommand(p);
 
 	printOnLog(LogLevel::INFO,
 			"EVOLOGICSS2CMODEM",
-			"startTx::COMMAND_TX::" + cmd_s);
+			"startTx::COMMAND_TX::", cmd_s);
 
 	// write the obtained command to the device, through the connector
 	std::unique_lock<std::mutex> state_lock(status_m);
@@ -345,7 +344,7 @@ UwEvoLogicsS2CModem::startTx(Packet *p)
 		if ((p_connector->writeToDevice(cmd_s)) < 0) {
 			printOnLog(LogLevel::ERROR,
 					"EVOLOGICSS2CMODEM",
-					"startTx::FAIL_TO_WRITE_TO_DEVICE=" + cmd_s);
+					"startTx::FAIL_TO_WRITE_TO_DEVICE=", cmd_s);
 			return;
 		}
 
@@ -366,12 +365,12 @@ UwEvoLogicsS2CModem::startTx(Packet *p)
 
 				printOnLog(LogLevel::INFO,
 						   "EVOLOGICSS2CMODEM",
-						   "startTx::SENDING=" + cmd_s);
+						   "startTx::SENDING=", cmd_s);
 
 				if ((p_connector->writeToDevice(cmd_s)) < 0) {
 					printOnLog(LogLevel::ERROR,
 							   "EVOLOGICSS2CMODEM",
-							   "startTx::FAIL_TO_WRITE_TO_DEVICE=" + cmd_s);
+							   "startTx::FAIL_TO_WRITE_TO_DEVICE=", cmd_s);
 				}
 
 				tx_status_cv.wait_for(tx_state_lock, WAIT_DELIVERY_IM, [&]
@@ -409,7 +408,7 @@ UwEvoLogicsS2CModem::startTx(Packet *p)
 		std::function<void(UwModem &, Packet * p)> callback =
 				&UwModem::realTxEnded;
 		ModemEvent e = {callback, p};
-		event_q.push(e);
+		pushEvent(tx_events, e);
 
 	} else {
 		printOnLog(LogLevel::ERROR,
@@ -419,6 +418,153 @@ UwEvoLogicsS2CModem::startTx(Packet *p)
 	}
 }
 
+std::string
+UwEvoLogicsS2CModem::buildTxCommand(Packet *p)
+{
+	// save MAC and AL headers and write payload
+	hdr_mac *mach = HDR_MAC(p);
+	hdr_uwal *uwalh = HDR_UWAL(p);
+	std::string payload;
+	payload.assign(hdr_uwal::binPkt(p), uwalh->binPktLength());
+
+	// build command to perform a SEND or SENDIM
+	if (tx_mode == TransmissionMode::IM) {
+		return p_interpreter->buildSendIM(payload, mach->macDA(), ack_mode);
+	}
+	return p_interpreter->buildSend(payload, mach->macDA());
+}
+
+void
+UwEvoLogicsS2CModem::stepTx()
+{
+	// same sequence as startTx, where each wait returns to the reactor
+	std::lock(status_m, tx_status_m);
+	std::lock_guard<std::mutex> state_lock(status_m, std::adopt_lock);
+	std::lock_guard<std::mutex> tx_state_lock(tx_status_m, std::adopt_lock);
+
+	while (true) {
+		switch (tx_step) {
+		case TxStep::NEXT_PACKET:
+			if (!tx_queue.pop(tx_pck)) {
+				UwReactor::instance().cancelTimer(p_connector.get());
+				return;
+			}
+			tx_cmd = buildTxCommand(tx_pck);
+			printOnLog(LogLevel::INFO,
+					"EVOLOGICSS2CMODEM",
+					"stepTx::COMMAND_TX::", tx_cmd);
+			tx_step = TxStep::WAIT_AVAILABLE;
+			waitTx(p_connector.get(), MODEM_TIMEOUT);
+			break;
+
+		case TxStep::WAIT_AVAILABLE:
+			if (status != ModemState::AVAILABLE) {
+				if (!txExpired()) {
+					return;
+				}
+				printOnLog(LogLevel::ERROR,
+						"EVOLOGICSS2CMODEM",
+						"stepTx::TIMEOUT_EXPIRED::FORCING_MODEM_AVAILABILITY");
+				status = ModemState::AVAILABLE;
+				setFailedTx(tx_pck);
+				endStepTx();
+				break;
+			}
+			status = ModemState::BUSY;
+			if (p_connector->writeToDevice(tx_cmd) < 0) {
+				printOnLog(LogLevel::ERROR,
+						"EVOLOGICSS2CMODEM",
+						"stepTx::FAIL_TO_WRITE_TO_DEVICE=", tx_cmd);
+				status = ModemState::AVAILABLE;
+				setFailedTx(tx_pck);
+				endStepTx();
+				break;
+			}
+			tx_status = TransmissionState::TX_PENDING;
+			tx_step = TxStep::WAIT_ACCEPTED;
+			waitTx(p_connector.get(), MODEM_TIMEOUT);
+			break;
+
+		case TxStep::WAIT_ACCEPTED:
+			if (status != ModemState::AVAILABLE && !txExpired()) {
+				return;
+			}
+			if (tx_mode == TransmissionMode::IM) {
+				tx_polls = 0;
+				im_status_updated.store(false);
+				tx_step = TxStep::QUERY_IM;
+			} else {
+				tx_step = TxStep::WAIT_BURST;
+				waitTx(p_connector.get(), WAIT_DELIVERY_BURST);
+			}
+			break;
+
+		case TxStep::QUERY_IM: {
+			if (tx_status == TransmissionState::TX_IDLE) {
+				printOnLog(LogLevel::DEBUG,
+						"EVOLOGICSS2CMODEM",
+						"stepTx::TX_IDLE");
+				endStepTx();
+				break;
+			}
+			if (tx_polls == MAX_N_STATUS_QUERIES) {
+				printOnLog(LogLevel::ERROR,
+						"EVOLOGICSS2CMODEM",
+						"stepTx::MAX_N_STATUS_QUERIES_REACHED");
+				endStepTx();
+				break;
+			}
+
+			std::string cmd_s = p_interpreter->buildATDI();
+			printOnLog(LogLevel::INFO,
+					"EVOLOGICSS2CMODEM",
+					"stepTx::SENDING=", cmd_s);
+			if (p_connector->writeToDevice(cmd_s) < 0) {
+				printOnLog(LogLevel::ERROR,
+						"EVOLOGICSS2CMODEM",
+						"stepTx::FAIL_TO_WRITE_TO_DEVICE=", cmd_s);
+			}
+			tx_polls++;
+			tx_step = TxStep::WAIT_IM;
+			waitTx(p_connector.get(), WAIT_DELIVERY_IM);
+			break;
+		}
+
+		case TxStep::WAIT_IM:
+			if (tx_status != TransmissionState::TX_IDLE) {
+				if (!txExpired()) {
+					return;
+				}
+				im_status_updated.store(false);
+				printOnLog(LogLevel::DEBUG,
+						"EVOLOGICSS2CMODEM",
+						"stepTx::TX_PENDING");
+			}
+			tx_step = TxStep::QUERY_IM;
+			break;
+
+		case TxStep::WAIT_BURST:
+			if (tx_status != TransmissionState::TX_IDLE && !txExpired()) {
+				return;
+			}
+			endStepTx();
+			break;
+		}
+	}
+}
+
+void
+UwEvoLogicsS2CModem::endStepTx()
+{
+	std::function<void(UwModem &, Packet * p)> callback =
+			&UwModem::realTxEnded;
+	ModemEvent e = {callback, tx_pck};
+	pushEvent(tx_events, e);
+
+	tx_pck = NULL;
+	tx_step = TxStep::NEXT_PACKET;
+}
+
 void
 UwEvoLogicsS2CModem::startRx(Packet *p)
 {
@@ -454,17 +600,27 @@ UwEvoLogicsS2CModem::start()
 		return;
 	}
 
+	resizeQueues();
+	startEventCheck();
+
 	// set flags to true so loops can start
 	receiving.store(true);
 	transmitting.store(true);
 
 	// branch off threads
-	rx_thread = std::thread(&UwEvoLogicsS2CModem::receivingData, this);
-
-	tx_thread = std::thread(&UwEvoLogicsS2CModem::transmittingData, this);
-
-	checkTimer = new CheckTimer(this);
-	checkTimer->resched(period);
+	rx_len = 0;
+	p_interpreter->resetParser();
+	in_reactor = use_reactor &&
+			UwReactor::instance().add(p_connector.get(),
+					std::bind(&UwEvoLogicsS2CModem::readAvailable, this),
+					std::bind(&UwEvoLogicsS2CModem::stepTx, this));
+	if (in_reactor) {
+		// send the packets queued before the start, if any
+		UwReactor::instance().post(p_connector.get());
+	} else {
+		rx_thread = std::thread(&UwEvoLogicsS2CModem::receivingData, this);
+		tx_thread = std::thread(&UwEvoLogicsS2CModem::transmittingData, this);
+	}
 }
 
 void
@@ -476,9 +632,18 @@ UwEvoLogicsS2CModem::stop()
 
 	receiving.store(false);
 	transmitting.store(false);
-	tx_queue_cv.notify_one();
+	tx_queue.wakeUp();
 	if (tx_thread.joinable())
 		tx_thread.join();
+	if (in_reactor) {
+		UwReactor::instance().remove(p_connector.get());
+		in_reactor = false;
+		if (tx_pck) {
+			Packet::free(tx_pck);
+			tx_pck = NULL;
+		}
+		tx_step = TxStep::NEXT_PACKET;
+	}
 	if (p_connector->isConnected() && !p_connector->closeConnection()) {
 		printOnLog(LogLevel::ERROR,
 				"EVOLOGICSS2CMODEM",
@@ -488,7 +653,8 @@ UwEvoLogicsS2CModem::stop()
 		rx_thread.join();
 	}
 
-	checkTimer->force_cancel();
+	stopEventCheck();
+	log_writer.close();
 }
 
 void
@@ -496,16 +662,10 @@ UwEvoLogicsS2CModem::transmittingData()
 {
 	while (transmitting.load()) {
 
-		std::unique_lock<std::mutex> tx_lock(tx_queue_m);
-		tx_queue_cv.wait(
-				tx_lock, [&] { return !tx_queue.empty() || !transmitting; });
-		if (!transmitting) {
+		Packet *pck = NULL;
+		if (!tx_queue.waitPop(pck, transmitting)) {
 			break;
 		}
-
-		Packet *pck = tx_queue.front();
-		tx_queue.pop();
-		tx_lock.unlock();
 		if (pck) {
 			startTx(pck);
 		}
@@ -519,58 +679,62 @@ UwEvoLogicsS2CModem::transmittingData()
 void
 UwEvoLogicsS2CModem::receivingData()
 {
-	data_buffer.resize(DATA_BUFFER_LEN);
-	std::fill(data_buffer.begin(), data_buffer.end(), '\0');
-	// iterators that keep track of read/write operations
-	std::vector<char>::iterator beg_it = data_buffer.begin();
-	std::vector<char>::iterator end_it = data_buffer.begin();
-	// iterators that keep track of commands research
-	std::vector<char>::iterator cmd_b = data_buffer.begin();
-	std::vector<char>::iterator cmd_e = data_buffer.begin();
-	UwInterpreterS2C::Response cmd = UwInterpreterS2C::Response::NO_COMMAND;
-	int r_bytes = 0;
-	int offset = 0;
-
 	while (receiving.load()) {
+		if (readRx(p_connector.get()) > 0) {
+			parseRx();
+		}
+	}
+}
 
-		r_bytes = p_connector->readFromDevice(
-				&(*beg_it) + offset, MAX_READ_BYTES - r_bytes);
-
-		end_it = beg_it + r_bytes + offset;
-
-		while (receiving.load() && r_bytes > 0 &&
-				(cmd = p_interpreter->findResponse(beg_it, end_it, cmd_b)) !=
-						UwInterpreterS2C::Response::NO_COMMAND) {
-
-			while (receiving.load() &&
-					!p_interpreter->parseResponse(
-							cmd, end_it, cmd_b, cmd_e, rx_payload)) {
-
-				int new_r_bytes = p_connector->readFromDevice(
-				    &(*end_it), MAX_READ_BYTES - r_bytes);
-
-				r_bytes += new_r_bytes;
-				end_it = beg_it + r_bytes;
+void
+UwEvoLogicsS2CModem::readAvailable()
+{
+	while (readRx(p_connector.get()) > 0) {
+		parseRx();
+	}
+	stepTx();
+}
 
-			}
+void
+UwEvoLogicsS2CModem::parseRx()
+{
+	UwInterpreterS2C::Message msg;
 
-			printOnLog(LogLevel::DEBUG,
-					"EVOLOGICSS2CMODEM",
-					"receivingData::RX_MSG=" + std::string(cmd_b, cmd_e));
+	while (p_interpreter->nextResponse(data_buffer.data(), rx_len, msg)) {
 
-			updateStatus(cmd);
-			std::fill(cmd_b, cmd_e, '\0');
-			cmd_b = cmd_e + 1;
-		}
+		printOnLog(LogLevel::DEBUG,
+				"EVOLOGICSS2CMODEM",
+				"receivingData::RX_MSG=",
+				data_buffer.data() + msg.beg,
+				msg.end - msg.beg);
+
+		rx_payload = data_buffer.data() + msg.payload_beg;
+		rx_payload_len = msg.payload_len;
+		updateStatus(msg.type);
+		rx_payload = NULL;
+		rx_payload_len = 0;
+	}
 
-		// check if bytes are left after parsing and move them to beginning
-		if ((int) (cmd_e - beg_it) < r_bytes) {
-			offset = r_bytes - (int) (cmd_e - beg_it);
-			std::copy(cmd_e, cmd_e + offset, data_buffer.begin());
-		} else {
-			offset = 0;
-		}
+	size_t parsed = p_interpreter->parsedOffset();
+	if (data_buffer.size() - rx_len >= static_cast<size_t>(MAX_READ_BYTES)) {
+		return;
 	}
+	if (parsed == 0 && rx_len == data_buffer.size()) {
+		// a single response does not fit in the buffer
+		printOnLog(LogLevel::ERROR,
+				"EVOLOGICSS2CMODEM",
+				"parseRx::BUFFER_FULL::DISCARDED=", std::to_string(rx_len));
+		rx_len = 0;
+		p_interpreter->resetParser();
+		return;
+	}
+
+	// move the bytes not parsed yet to the beginning
+	std::copy(data_buffer.begin() + parsed,
+			data_buffer.begin() + rx_len,
+			data_buffer.begin());
+	rx_len -= parsed;
+	p_interpreter->shiftParser(parsed);
 }
 
 void
@@ -590,7 +754,7 @@ UwEvoLogicsS2CModem::updateStatus(UwInterpreterS2C::Response cmd)
 			std::function<void(UwModem &, Packet * p)> callback =
 					&UwModem::recv;
 			ModemEvent e = {callback, p};
-			event_q.push(e);
+			pushEvent(rx_events, e);
 			break;
 		}
 		case UwInterpreterS2C::Response::RECV: {
@@ -603,7 +767,7 @@ UwEvoLogicsS2CModem::updateStatus(UwInterpreterS2C::Response cmd)
 			std::function<void(UwModem &, Packet * p)> callback =
 					&UwModem::recv;
 			ModemEvent e = {callback, p};
-			event_q.push(e);
+			pushEvent(rx_events, e);
 			break;
 		}
 		case UwInterpreterS2C::Response::OK: {
@@ -800,8 +964,8 @@ void
 UwEvoLogicsS2CModem::createRxPacket(Packet *p)
 {
 	hdr_uwal *uwalh = HDR_UWAL(p);
-	uwalh->binPktLength() = rx_payload.size();
-	std::memset(uwalh->binPkt(), 0, uwalh->binPktLength());
-	std::copy(rx_payload.begin(), rx_payload.end(), uwalh->binPkt());
+	uwalh->binPktLength() = rx_payload_len;
+	char *binPkt = hdr_uwal::writableBinPkt(p);
+	std::copy(rx_payload, rx_payload + rx_payload_len, binPkt);
 	HDR_CMN(p)->direction() = hdr_cmn::UP;
 }
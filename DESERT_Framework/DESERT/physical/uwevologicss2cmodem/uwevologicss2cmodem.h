@@ -82,6 +82,25 @@ public:
 	 */
 	enum class TransmissionState { TX_IDLE = 0, TX_PENDING };
 
+	/**
+	 * Step of a transmission running on the UwReactor thread, i.e., of the
+	 * waits done by startTx() in the transmitting thread.
+	 * NEXT_PACKET: no transmission in progress
+	 * WAIT_AVAILABLE: waiting for the modem to accept a command
+	 * WAIT_ACCEPTED: the SEND or SENDIM was written, waiting for the reply
+	 * QUERY_IM: an ATDI is to be written, if the IM was not delivered yet
+	 * WAIT_IM: waiting for the reply to the ATDI
+	 * WAIT_BURST: waiting for the delivery of the burst message
+	 */
+	enum class TxStep {
+		NEXT_PACKET,
+		WAIT_AVAILABLE,
+		WAIT_ACCEPTED,
+		QUERY_IM,
+		WAIT_IM,
+		WAIT_BURST
+	};
+
 	/**
 	 * Constructor of the UwEvoLogicsS2CModem class
 	 * @param address string containing the address to connect to
@@ -141,6 +160,28 @@ private:
 	 */
 	virtual void startTx(Packet *p);
 
+	/**
+	 * Method that builds the SEND or SENDIM command of a packet, according
+	 * to the transmission mode.
+	 * @param p Packet pointer to the packet to be sent
+	 * @return the command to write to the device
+	 */
+	std::string buildTxCommand(Packet *p);
+
+	/**
+	 * Method called on the UwReactor thread when a packet is queued, when a
+	 * response is parsed and when the wait of the transmission expires: it
+	 * advances the transmission in progress as far as it can without
+	 * waiting, and starts the following ones.
+	 */
+	void stepTx();
+
+	/**
+	 * Method that ends the transmission in progress on the UwReactor thread,
+	 * scheduling the call to endTx.
+	 */
+	void endStepTx();
+
 	/**
 	 * Method that starts a packet reception. This method is also in charge of
 	 * sending a ClMsg, Phy2MacStartRx(p), to notify the upper layers of
@@ -179,6 +220,20 @@ private:
 	 */
 	virtual void receivingData();
 
+	/**
+	 * Method called by the UwReactor when the connector is readable: reads
+	 * and parses all the data available.
+	 */
+	void readAvailable();
+
+	/**
+	 * Method that parses the responses found in the first rx_len bytes of
+	 * data_buffer, resuming from where the previous call stopped. The bytes
+	 * already parsed are discarded only when the space left in the buffer
+	 * is less than a read, so that a response is moved at most once.
+	 */
+	void parseRx();
+
 	/**
 	 * Method that updates the status of the modem State Machine: state change
 	 * is triggered by reception of commands on the connector interface, or by
@@ -216,14 +271,10 @@ private:
 	std::mutex status_m;
 	/** Mutex associated with the transmission state machine of the modem */
 	std::mutex tx_status_m;
-	/** Mutex associated with the transmission queue */
-	std::mutex tx_queue_m;
 	/** Condition variable to wait for ModemState::AVAILABLE */
 	std::condition_variable status_cv;
 	/** Condition variable to wait for TransmissionState::TX_IDLE */
 	std::condition_variable tx_status_cv;
-	/** Condition variable that is linked with the transmitting queue */
-	std::condition_variable tx_queue_cv;
 	/** Atomic boolean variable that controls the receiving looping thread */
 	std::atomic<bool> receiving;
 	/** Atomic boolean variable that controls the transmitting looping thread */
@@ -234,8 +285,21 @@ private:
 	std::thread rx_thread;
 	/**Object with the tx thread */
 	std::thread tx_thread;
-	/** String that is updated witn each new received messsage */
-	std::string rx_payload;
+	/** Step of the transmission running on the UwReactor thread */
+	TxStep tx_step;
+	/** Packet being transmitted on the UwReactor thread */
+	Packet *tx_pck;
+	/** Command of the packet being transmitted on the UwReactor thread */
+	std::string tx_cmd;
+	/** ATDI written for the IM being transmitted on the UwReactor thread */
+	uint tx_polls;
+	/**
+	 * Payload of the message being handled, pointing inside data_buffer:
+	 * valid only while updateStatus() runs
+	 */
+	const char *rx_payload;
+	/** Length of rx_payload */
+	size_t rx_payload_len;
 	/** Maximum time to wait for modem to become ModemState::AVAILABLE */
 	const static std::chrono::milliseconds MODEM_TIMEOUT;
 	/** Time interval to wait for the modem notifying that there
@@ -67,10 +67,20 @@ std::vector<std::pair<std::string, UwInterpreterS2C::Response> >
 				std::make_pair("SENDEND", Response::SENDEND),
 				std::make_pair("BITRATE", Response::BITRATE)};
 
+const int UwInterpreterS2C::N_PAYLOAD_FIELDS = 8;
+
 UwInterpreterS2C::UwInterpreterS2C()
 	: sep(",")
 	, r_term("\r\n")
 	, w_term("\n")
+	, p_state(ParseState::LINE)
+	, p_pos(0)
+	, p_line(0)
+	, p_rsp(0)
+	, p_type(Response::NO_COMMAND)
+	, p_fields(0)
+	, p_len(0)
+	, p_payload(0)
 {
 }
 
@@ -824,3 +834,159 @@ UwInterpreterS2C::parseResponse(Response rsp, std::vector<char>::iterator end,
 
 	} // end of switch on commands
 }
+
+UwInterpreterS2C::Response
+UwInterpreterS2C::findLineResponse(
+		const char *beg, const char *end, const char *&rsp) const
+{
+	Response cmd = Response::NO_COMMAND;
+	rsp = end;
+
+	for (uint i = 0; i < syntax_pool.size(); i++) {
+		const char *it = std::search(beg,
+				rsp,
+				syntax_pool[i].first.begin(),
+				syntax_pool[i].first.end());
+		if (it < rsp) {
+			rsp = it;
+			cmd = syntax_pool[i].second;
+		}
+	}
+
+	return cmd;
+}
+
+bool
+UwInterpreterS2C::nextResponse(const char *buf, size_t len, Message &msg)
+{
+	static const std::string recvim_tok("RECVIM,");
+	static const std::string recv_tok("RECV,");
+
+	while (p_pos < len) {
+
+		switch (p_state) {
+
+			case ParseState::LINE: {
+				char c = buf[p_pos++];
+
+				if (c == ',') {
+					// RECV and RECVIM carry a binary payload, which may
+					// contain the terminator: the line cannot be used
+					size_t n = p_pos - p_line;
+					if (n >= recvim_tok.size() &&
+							std::equal(recvim_tok.begin(),
+									recvim_tok.end(),
+									buf + p_pos - recvim_tok.size())) {
+						p_type = Response::RECVIM;
+						p_rsp = p_pos - recvim_tok.size();
+					} else if (n >= recv_tok.size() &&
+							std::equal(recv_tok.begin(),
+									recv_tok.end(),
+									buf + p_pos - recv_tok.size())) {
+						p_type = Response::RECV;
+						p_rsp = p_pos - recv_tok.size();
+					} else {
+						break;
+					}
+					p_state = ParseState::FIELDS;
+					p_fields = 0;
+					p_len = 0;
+				} else if (c == r_term[1] && p_pos - p_line >= 2 &&
+						buf[p_pos - 2] == r_term[0]) {
+					const char *rsp = NULL;
+					Response cmd =
+							findLineResponse(buf + p_line, buf + p_pos, rsp);
+					p_line = p_pos;
+					if (cmd != Response::NO_COMMAND) {
+						msg.type = cmd;
+						msg.beg = rsp - buf;
+						msg.end = p_pos;
+						msg.payload_beg = p_pos;
+						msg.payload_len = 0;
+						return true;
+					}
+				}
+				break;
+			}
+
+			case ParseState::FIELDS: {
+				char c = buf[p_pos++];
+
+				if (c == sep[0]) {
+					if (++p_fields == N_PAYLOAD_FIELDS) {
+						p_payload = p_pos;
+						p_state = ParseState::PAYLOAD;
+					}
+				} else if (c == r_term[1]) {
+					// truncated response: restart from the next line
+					p_line = p_pos;
+					p_state = ParseState::LINE;
+				} else if (p_fields == 0 && c >= '0' && c <= '9') {
+					p_len = p_len * 10 + (c - '0');
+				}
+				break;
+			}
+
+			case ParseState::PAYLOAD: {
+				// the payload is skipped, not scanned
+				p_pos = std::min(len, p_payload + p_len);
+				if (p_pos == p_payload + p_len) {
+					p_state = ParseState::TERM;
+				}
+				break;
+			}
+
+			case ParseState::TERM: {
+				if (len - p_pos < r_term.size()) {
+					return false;
+				}
+				if (std::equal(r_term.begin(), r_term.end(), buf + p_pos)) {
+					p_pos += r_term.size();
+					p_line = p_pos;
+					p_state = ParseState::LINE;
+					msg.type = p_type;
+					msg.beg = p_rsp;
+					msg.end = p_pos;
+					msg.payload_beg = p_payload;
+					msg.payload_len = p_len;
+					return true;
+				}
+				// wrong length: look again for responses after the token
+				p_pos = p_rsp + 1;
+				p_line = p_pos;
+				p_state = ParseState::LINE;
+				break;
+			}
+		}
+	}
+
+	return false;
+}
+
+size_t
+UwInterpreterS2C::parsedOffset() const
+{
+	return p_state == ParseState::LINE ? p_line : p_rsp;
+}
+
+void
+UwInterpreterS2C::shiftParser(size_t n)
+{
+	p_pos -= n;
+	p_line -= std::min(n, p_line);
+	p_rsp -= std::min(n, p_rsp);
+	p_payload -= std::min(n, p_payload);
+}
+
+void
+UwInterpreterS2C::resetParser()
+{
+	p_state = ParseState::LINE;
+	p_pos = 0;
+	p_line = 0;
+	p_rsp = 0;
+	p_type = Response::NO_COMMAND;
+	p_fields = 0;
+	p_len = 0;
+	p_payload = 0;
+}
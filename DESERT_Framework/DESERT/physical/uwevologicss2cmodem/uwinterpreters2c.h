@@ -84,6 +84,20 @@ public:
 		UNKNOWN,
 		NO_COMMAND
 	};
+
+	/**
+	 * Response found by UwInterpreterS2C::nextResponse. The positions are
+	 * offsets in the buffer being parsed, so that the payload can be read
+	 * in place.
+	 */
+	struct Message {
+		Response type; /**< Type of the response */
+		size_t beg; /**< Offset of the first byte of the response */
+		size_t end; /**< Offset following the response terminator */
+		size_t payload_beg; /**< Offset of the payload of RECV and RECVIM */
+		size_t payload_len; /**< Length of the payload, 0 if none */
+	};
+
 	/**
 	 * Class constructor
 	 */
@@ -202,7 +216,62 @@ public:
 			std::vector<char>::iterator rsp_beg,
 			std::vector<char>::iterator &rsp_end, std::string &rx_payload);
 
+	/**
+	 * Streaming parser: method that resumes parsing a buffer from where the
+	 * previous call stopped, and returns the next complete response.
+	 * Each byte is examined once, as it is received, except the payloads of
+	 * RECV and RECVIM, which are skipped using their declared length, and
+	 * the lines without payload, whose response is identified once complete.
+	 * The buffer may grow between two calls, but the bytes before
+	 * parsedOffset() must not change, unless discarded with shiftParser().
+	 * @param[in]  buf buffer of received data
+	 * @param[in]  len number of valid bytes in buf
+	 * @param[out] msg the response found, if any
+	 * @return false if no complete response is left in buf
+	 */
+	bool nextResponse(const char *buf, size_t len, Message &msg);
+
+	/**
+	 * Method that returns the number of bytes at the beginning of the
+	 * buffer that the streaming parser does not need anymore.
+	 * @return offset of the first byte of the response being parsed
+	 */
+	size_t parsedOffset() const;
+
+	/**
+	 * Method to call when the first n bytes of the buffer have been
+	 * discarded, and the rest moved to the beginning.
+	 * @param n number of bytes discarded, at most parsedOffset()
+	 */
+	void shiftParser(size_t n);
+
+	/**
+	 * Method that restarts the streaming parser on a new, empty buffer.
+	 */
+	void resetParser();
+
 private:
+	/**
+	 * States of the streaming parser
+	 */
+	enum class ParseState {
+		LINE, /**< Looking for the end of a line or for RECV, RECVIM */
+		FIELDS, /**< Reading the fields preceding a payload */
+		PAYLOAD, /**< Skipping a payload */
+		TERM /**< Checking the terminator after a payload */
+	};
+
+	/**
+	 * Method that looks for the tokens of syntax_pool in a complete line.
+	 * @param[in]  beg first byte of the line
+	 * @param[in]  end end of the line
+	 * @param[out] rsp first byte of the token found
+	 * @return type of the first response found
+	 */
+	Response findLineResponse(const char *beg, const char *end,
+			const char *&rsp) const;
+
+
 	std::string sep; /**< Separator for paramters fo the commands: a comma */
 	std::string r_term; /**<Terminating sequence for commands read from device*/
 	std::string w_term; /**<Terminating sequence for commands wrtten to device*/
@@ -215,6 +284,18 @@ private:
 	 */
 	static std::vector<std::pair<std::string, UwInterpreterS2C::Response> >
 			syntax_pool;
+
+	/** Number of fields between RECV, RECVIM and their payload */
+	static const int N_PAYLOAD_FIELDS;
+
+	ParseState p_state; /**< State of the streaming parser */
+	size_t p_pos; /**< Offset of the next byte to parse */
+	size_t p_line; /**< Offset of the beginning of the current line */
+	size_t p_rsp; /**< Offset of the current RECV or RECVIM */
+	Response p_type; /**< Current response with payload */
+	int p_fields; /**< Fields of the current response read so far */
+	size_t p_len; /**< Declared length of the current payload */
+	size_t p_payload; /**< Offset of the current payload */
 };
 
 #endif
@@ -56,7 +56,10 @@ public:
 } class_UnderwaterGainFromDb;
 
 UnderwaterGainFromDb::UnderwaterGainFromDb()
-	: time_roughness_(1)
+	: use_gain_cache_(1)
+	, gain_cache_size_(64)
+	, gain_cache_(64 * 1024 * 1024)
+	, time_roughness_(1)
 	, depth_roughness_(1)
 	, distance_roughness_(1)
 	, total_time_(1)
@@ -67,6 +70,8 @@ UnderwaterGainFromDb::UnderwaterGainFromDb()
 	bind("distance_roughness_", &distance_roughness_);
 	bind("total_time_", &total_time_);
 	bind("frequency_correction_factor_", &frequency_correction_factor_);
+	bind("use_gain_cache_", &use_gain_cache_);
+	bind("gain_cache_size_", &gain_cache_size_);
 	bind_error("token_separator_", &token_separator_);
 	token_separator_ = '\t';
 	path_ = "";
@@ -75,7 +80,30 @@ UnderwaterGainFromDb::UnderwaterGainFromDb()
 int
 UnderwaterGainFromDb::command(int argc, const char *const *argv)
 {
-	if (argc == 3) {
+	Tcl &tcl = Tcl::instance();
+
+	if (argc == 2) {
+		if (strcasecmp(argv[1], "getGainCacheHits") == 0) {
+			tcl.resultf("%llu", (unsigned long long) gain_cache_.getHits());
+			return TCL_OK;
+		} else if (strcasecmp(argv[1], "getGainCacheMisses") == 0) {
+			tcl.resultf("%llu", (unsigned long long) gain_cache_.getMisses());
+			return TCL_OK;
+		} else if (strcasecmp(argv[1], "getGainCacheEvictions") == 0) {
+			tcl.resultf(
+					"%llu", (unsigned long long) gain_cache_.getEvictions());
+			return TCL_OK;
+		} else if (strcasecmp(argv[1], "getGainCacheBytes") == 0) {
+			tcl.resultf("%lu", (unsigned long) gain_cache_.getUsedBytes());
+			return TCL_OK;
+		} else if (strcasecmp(argv[1], "getGainCacheEntries") == 0) {
+			tcl.resultf("%lu", (unsigned long) gain_cache_.getEntries());
+			return TCL_OK;
+		} else if (strcasecmp(argv[1], "clearGainCache") == 0) {
+			gain_cache_.clear();
+			return TCL_OK;
+		}
+	} else if (argc == 3) {
 		if (strcasecmp(argv[1], "path") == 0) {
 			string tmp_ = ((char *) argv[2]);
 			path_ = new char[tmp_.length() + 1];
@@ -193,6 +221,17 @@ double
 UnderwaterGainFromDb::retriveGainFromFile(const string &_file_name,
 		const int &_row_index, const int &_column_index) const
 {
+	if (use_gain_cache_) {
+		gain_cache_.setMaxBytes((size_t) (gain_cache_size_ * 1024 * 1024));
+		double value_ = gain_cache_.get(_file_name, token_separator_)
+								.at(_row_index, _column_index);
+		if (this->isZero(value_)) {
+			return (-INT_MAX);
+		} else {
+			return value_;
+		}
+	}
+
 	int row_iterator_ = 0;
 	int column_iterator_ = 0;
 	ifstream input_file_;
@@ -39,6 +39,8 @@
 #ifndef UWGAINFROMDB_H
 #define UWGAINFROMDB_H
 
+#include "uwgainmapcache.h"
+
 #include <uwphysical.h>
 
 #include <packet.h>
@@ -232,6 +234,12 @@ protected:
 	char token_separator_; /**< Token used to parse the elements in a line of
 							  the database. */
 	ostringstream osstream_; /**< Used to create strings. */
+	int use_gain_cache_; /**< If set to 1 the database files are parsed once
+							and kept in memory, otherwise they are read at
+							every lookup. */
+	double gain_cache_size_; /**< Memory budget of the gain cache, in MB. */
+	mutable UwGainMapCache gain_cache_; /**< In-memory copy of the database
+										   files. */
 
 private:
 	// Variables
@@ -0,0 +1,144 @@
+//
+// Copyright (c) 2017 Regents of the SIGNET lab, University of Padova.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. Neither the name of the University of Padova (SIGNET lab) nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file   uwgainmapcache.cpp
+ * @author Giovanni Toso
+ * @version 1.0.0
+ *
+ * \brief Implementation of UwGainMap and UwGainMapCache classes.
+ *
+ */
+
+#include "uwgainmapcache.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+UwGainMap::UwGainMap()
+	: rows_(0)
+	, columns_(0)
+	, values_()
+{
+}
+
+bool
+UwGainMap::load(const std::string &file_name, char separator)
+{
+	std::ifstream input_file(file_name.c_str());
+	if (!input_file.is_open())
+		return false;
+
+	std::vector<std::vector<float> > lines;
+	std::string line;
+	std::string token;
+	size_t max_columns = 0;
+
+	while (std::getline(input_file, line)) {
+		std::vector<float> row;
+		std::istringstream iss(line);
+		while (std::getline(iss, token, separator))
+			row.push_back((float) strtod(token.c_str(), NULL));
+		if (row.size() > max_columns)
+			max_columns = row.size();
+		lines.push_back(row);
+	}
+
+	rows_ = lines.size();
+	columns_ = max_columns;
+	values_.assign((size_t) rows_ * columns_, 0);
+	for (size_t r = 0; r < lines.size(); r++)
+		std::copy(lines[r].begin(), lines[r].end(),
+				values_.begin() + r * columns_);
+
+	return true;
+} /* UwGainMap::load */
+
+UwGainMapCache::UwGainMapCache(size_t max_bytes)
+	: max_bytes_(max_bytes)
+	, used_bytes_(0)
+	, hits_(0)
+	, misses_(0)
+	, evictions_(0)
+	, lru_()
+	, maps_()
+{
+}
+
+const UwGainMap &
+UwGainMapCache::get(const std::string &file_name, char separator)
+{
+	MapTable::iterator it = maps_.find(file_name);
+	if (it != maps_.end()) {
+		hits_++;
+		if (it->second.lru_it != lru_.begin())
+			lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+		return it->second.map;
+	}
+
+	misses_++;
+	Entry &entry = maps_[file_name];
+	if (!entry.map.load(file_name, separator))
+		std::cerr << "Impossible to open file " << file_name << std::endl;
+	lru_.push_front(file_name);
+	entry.lru_it = lru_.begin();
+	used_bytes_ += entry.map.size() + file_name.size();
+	evict();
+
+	return entry.map;
+} /* UwGainMapCache::get */
+
+void
+UwGainMapCache::setMaxBytes(size_t max_bytes)
+{
+	max_bytes_ = max_bytes;
+	evict();
+} /* UwGainMapCache::setMaxBytes */
+
+void
+UwGainMapCache::clear()
+{
+	lru_.clear();
+	maps_.clear();
+	used_bytes_ = 0;
+} /* UwGainMapCache::clear */
+
+void
+UwGainMapCache::evict()
+{
+	while (used_bytes_ > max_bytes_ && lru_.size() > 1) {
+		const std::string &victim = lru_.back();
+		MapTable::iterator it = maps_.find(victim);
+		used_bytes_ -= it->second.map.size() + victim.size();
+		maps_.erase(it);
+		lru_.pop_back();
+		evictions_++;
+	}
+} /* UwGainMapCache::evict */
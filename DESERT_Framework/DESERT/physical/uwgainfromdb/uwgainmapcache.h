@@ -0,0 +1,239 @@
+//
+// Copyright (c) 2017 Regents of the SIGNET lab, University of Padova.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. Neither the name of the University of Padova (SIGNET lab) nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file   uwgainmapcache.h
+ * @author Giovanni Toso
+ * @version 1.0.0
+ *
+ * \brief Definition of UwGainMap and UwGainMapCache classes.
+ *
+ */
+
+#ifndef UWGAINMAPCACHE_H
+#define UWGAINMAPCACHE_H
+
+#include <stdint.h>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Dense, row-major copy of a single gain database file.
+ * Rows and columns are 1-based, as in the text format; every cell that is
+ * not present in the file is stored as 0.
+ */
+class UwGainMap
+{
+public:
+	/**
+	 * Constructor of UwGainMap class.
+	 */
+	UwGainMap();
+
+	/**
+	 * Parses the text file into the dense array.
+	 *
+	 * @param file_name Name of the file to parse.
+	 * @param separator Token used to split the elements of a line.
+	 * @return <i>true</i> if the file has been opened, <i>false</i> otherwise.
+	 */
+	bool load(const std::string &file_name, char separator);
+
+	/**
+	 * Returns the value stored in the given cell.
+	 *
+	 * @param row 1-based row index.
+	 * @param column 1-based column index.
+	 * @return Value of the cell, 0 if the cell is outside the map.
+	 */
+	inline float
+	at(int row, int column) const
+	{
+		if (row < 1 || row > rows_ || column < 1 || column > columns_)
+			return 0;
+		return values_[(size_t) (row - 1) * columns_ + (column - 1)];
+	}
+
+	/**
+	 * Returns the number of bytes held by the map.
+	 *
+	 * @return Memory footprint of the values.
+	 */
+	inline size_t
+	size() const
+	{
+		return values_.capacity() * sizeof(float);
+	}
+
+	/**
+	 * Returns the number of rows of the map.
+	 *
+	 * @return rows_
+	 */
+	inline int
+	rows() const
+	{
+		return rows_;
+	}
+
+	/**
+	 * Returns the number of columns of the map.
+	 *
+	 * @return columns_
+	 */
+	inline int
+	columns() const
+	{
+		return columns_;
+	}
+
+private:
+	int rows_; /**< Number of rows of the map. */
+	int columns_; /**< Number of columns of the widest row. */
+	std::vector<float> values_; /**< Row-major values of the map. */
+};
+
+/**
+ * LRU store of UwGainMap objects keyed by file name. Every file is parsed
+ * at most once as long as it fits in the memory budget.
+ */
+class UwGainMapCache
+{
+public:
+	/**
+	 * Constructor of UwGainMapCache class.
+	 *
+	 * @param max_bytes Memory budget of the cache, in bytes.
+	 */
+	UwGainMapCache(size_t max_bytes);
+
+	/**
+	 * Returns the map related to a file, parsing it on a miss.
+	 *
+	 * @param file_name Name of the database file.
+	 * @param separator Token used to split the elements of a line.
+	 * @return Reference to the map, empty if the file can not be opened.
+	 */
+	const UwGainMap &get(const std::string &file_name, char separator);
+
+	/**
+	 * Sets the memory budget and evicts the maps exceeding it.
+	 *
+	 * @param max_bytes Memory budget of the cache, in bytes.
+	 */
+	void setMaxBytes(size_t max_bytes);
+
+	/**
+	 * Removes all the maps from the cache.
+	 */
+	void clear();
+
+	/**
+	 * Returns the number of lookups served from memory.
+	 *
+	 * @return hits_
+	 */
+	inline uint64_t
+	getHits() const
+	{
+		return hits_;
+	}
+
+	/**
+	 * Returns the number of lookups that required parsing a file.
+	 *
+	 * @return misses_
+	 */
+	inline uint64_t
+	getMisses() const
+	{
+		return misses_;
+	}
+
+	/**
+	 * Returns the number of maps evicted to respect the memory budget.
+	 *
+	 * @return evictions_
+	 */
+	inline uint64_t
+	getEvictions() const
+	{
+		return evictions_;
+	}
+
+	/**
+	 * Returns the number of bytes currently held by the cache.
+	 *
+	 * @return used_bytes_
+	 */
+	inline size_t
+	getUsedBytes() const
+	{
+		return used_bytes_;
+	}
+
+	/**
+	 * Returns the number of maps currently held by the cache.
+	 *
+	 * @return Number of cached maps.
+	 */
+	inline size_t
+	getEntries() const
+	{
+		return maps_.size();
+	}
+
+private:
+	typedef std::list<std::string> LruList;
+
+	struct Entry {
+		UwGainMap map; /**< Parsed gain map. */
+		LruList::iterator lru_it; /**< Position in the LRU list. */
+	};
+
+	typedef std::unordered_map<std::string, Entry> MapTable;
+
+	/**
+	 * Evicts the least recently used maps until the budget is respected.
+	 * The most recently used map is never evicted.
+	 */
+	void evict();
+
+	size_t max_bytes_; /**< Memory budget of the cache, in bytes. */
+	size_t used_bytes_; /**< Bytes held by the cached maps. */
+	uint64_t hits_; /**< Number of lookups served from memory. */
+	uint64_t misses_; /**< Number of lookups that parsed a file. */
+	uint64_t evictions_; /**< Number of evicted maps. */
+	LruList lru_; /**< File names, most recently used first. */
+	MapTable maps_; /**< Cached maps, indexed by file name. */
+};
+
+#endif /* UWGAINMAPCACHE_H */
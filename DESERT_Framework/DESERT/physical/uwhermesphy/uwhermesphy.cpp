@@ -145,10 +145,7 @@ UwHermesPhy::endRx(Packet *p)
 	hdr_MPhy *ph = HDR_MPHY(p);
 	hdr_mac *mach = HDR_MAC(p);
 	counter interferent_pkts;
-	static int mac_addr = -1;
-	ClMsgPhy2MacAddr msg;
-	sendSyncClMsg(&msg);
-	mac_addr = msg.getAddr();
+	int mac_addr = getMacAddr();
 	if (PktRx != 0) {
 		if (PktRx == p) {
 			double per_ni; // packet error rate due to noise and/or interference
@@ -163,8 +160,10 @@ UwHermesPhy::endRx(Packet *p)
 					if (Interference_Model == "MEANPOWER") { // only meanpower
 															 // is allow in
 															 // Hermesphy
-						double interference =
-								interference_->getInterferencePower(p);
+						InterferenceSummary interf_summary =
+								interference_->getInterferenceSummary(p);
+						double interference = interf_summary.power;
+						interferent_pkts = interf_summary.counters;
 						per_ni = interference > 0; // the Hermes interference
 												   // model is unknown, thus it
 												   // is taken as always
@@ -177,7 +176,6 @@ UwHermesPhy::endRx(Packet *p)
 								  << std::endl;
 						exit(1);
 					}
-					interferent_pkts = interference_->getCounters(p);
 
 				} else {
 					per_ni = getPER(ph->Pr / (ph->Pn + ph->Pi),
@@ -168,8 +168,12 @@ UnderwaterHMMPhysical::endRx(Packet *p){
 								}
 							}
 						}
+						interferent_pkts = interference_->getCounters(p);
 					} else if (Interference_Model == "MEANPOWER") {
-						interf_power = interference_->getInterferencePower(p);
+						InterferenceSummary interf_summary =
+								interference_->getInterferenceSummary(p);
+						interf_power = interf_summary.power;
+						interferent_pkts = interf_summary.counters;
 						if (interf_power > 0.0) {
 							perr_interf = getPER(
 								ph->Pr / interf_power, nbits, p);
@@ -181,7 +185,6 @@ UnderwaterHMMPhysical::endRx(Packet *p){
 								<< std::endl;
 						exit(1);
 					}
-					interferent_pkts = interference_->getCounters(p);
 
 				} else {
 					interf_power = ph->Pi;
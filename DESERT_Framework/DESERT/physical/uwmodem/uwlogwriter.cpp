@@ -0,0 +1,240 @@
+//
+// Copyright (c) 2018 Regents of the SIGNET lab, University of Padova.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. Neither the name of the University of Padova (SIGNET lab) nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <uwlogwriter.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+UwLogWriter::UwLogWriter()
+	: slots()
+	, capacity(1024)
+	, mask(0)
+	, fd(-1)
+	, flush_ms(100)
+	, head(0)
+	, tail(0)
+	, opened(false)
+	, running(false)
+	, wake_pending(false)
+	, open_m()
+	, wake_m()
+	, wake_cv()
+	, writer()
+	, batch()
+	, n_reported(0)
+	, n_records(0)
+	, n_dropped(0)
+	, n_lost(0)
+{
+}
+
+UwLogWriter::~UwLogWriter()
+{
+	close();
+}
+
+void
+UwLogWriter::setCapacity(size_t capacity_)
+{
+	std::lock_guard<std::mutex> lock(open_m);
+	if (!opened.load()) {
+		capacity = capacity_;
+	}
+}
+
+void
+UwLogWriter::setFlushPeriod(double period)
+{
+	// a wait of 0 ms would keep the writer thread spinning
+	flush_ms = std::max(1, static_cast<int>(period * 1000));
+}
+
+bool
+UwLogWriter::open(const std::string &path)
+{
+	std::lock_guard<std::mutex> lock(open_m);
+	if (opened.load()) {
+		return fd >= 0;
+	}
+
+	size_t n = 2;
+	while (n < capacity)
+		n <<= 1;
+	slots.reset(new Slot[n]);
+	for (size_t i = 0; i < n; i++) {
+		slots[i].seq.store(i, std::memory_order_relaxed);
+	}
+	mask = n - 1;
+	head.store(0);
+	tail.store(0);
+	batch.reserve(BATCH_BYTES);
+
+	fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		std::cerr << "UWLOGWRITER::OPEN_FAILED::" << path
+				  << "::ERRNO=" << errno << std::endl;
+	} else {
+		running.store(true);
+		writer = std::thread(&UwLogWriter::run, this);
+	}
+	opened.store(true, std::memory_order_release);
+	return fd >= 0;
+}
+
+void
+UwLogWriter::close()
+{
+	std::lock_guard<std::mutex> lock(open_m);
+	if (running.exchange(false)) {
+		wake();
+		if (writer.joinable()) {
+			writer.join();
+		}
+		::close(fd);
+		fd = -1;
+	}
+	opened.store(false, std::memory_order_release);
+}
+
+bool
+UwLogWriter::push(const char *rec, size_t len, bool urgent)
+{
+	if (!running.load(std::memory_order_acquire)) {
+		return false;
+	}
+
+	size_t pos = tail.load(std::memory_order_relaxed);
+	Slot *s;
+	for (;;) {
+		s = &slots[pos & mask];
+		size_t seq = s->seq.load(std::memory_order_acquire);
+		if (seq == pos) {
+			if (tail.compare_exchange_weak(
+						pos, pos + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		} else if (seq < pos) {
+			// the slot still holds the record of the previous lap
+			n_dropped.fetch_add(1, std::memory_order_relaxed);
+			n_lost.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		} else {
+			pos = tail.load(std::memory_order_relaxed);
+		}
+	}
+
+	s->text.assign(rec, len);
+	s->seq.store(pos + 1, std::memory_order_release);
+	n_records.fetch_add(1, std::memory_order_relaxed);
+
+	if (urgent ||
+			pos + 1 - head.load(std::memory_order_relaxed) > (mask + 1) / 2) {
+		wake();
+	}
+	return true;
+}
+
+void
+UwLogWriter::resetCounters()
+{
+	n_records.store(0, std::memory_order_relaxed);
+	n_dropped.store(0, std::memory_order_relaxed);
+}
+
+void
+UwLogWriter::run()
+{
+	while (running.load()) {
+		drain();
+		std::unique_lock<std::mutex> lock(wake_m);
+		wake_cv.wait_for(lock, std::chrono::milliseconds(flush_ms), [this] {
+			return wake_pending.load() || !running.load();
+		});
+		wake_pending.store(false);
+	}
+	drain();
+}
+
+void
+UwLogWriter::drain()
+{
+	size_t h = head.load(std::memory_order_relaxed);
+	for (;;) {
+		Slot &s = slots[h & mask];
+		if (s.seq.load(std::memory_order_acquire) != h + 1) {
+			break;
+		}
+		batch.append(s.text);
+		s.seq.store(h + mask + 1, std::memory_order_release);
+		head.store(++h, std::memory_order_relaxed);
+		if (batch.size() >= BATCH_BYTES) {
+			flushBatch();
+		}
+	}
+
+	size_t d = n_lost.load(std::memory_order_relaxed);
+	if (d > n_reported) {
+		batch += "UWLOGWRITER::DROPPED_RECORDS=" +
+				std::to_string(d - n_reported) + "\n";
+	}
+	n_reported = d;
+	flushBatch();
+}
+
+void
+UwLogWriter::flushBatch()
+{
+	size_t off = 0;
+	while (off < batch.size()) {
+		ssize_t w = ::write(fd, batch.data() + off, batch.size() - off);
+		if (w < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			std::cerr << "UWLOGWRITER::WRITE_FAILED::ERRNO=" << errno
+					  << std::endl;
+			break;
+		}
+		off += w;
+	}
+	batch.clear();
+}
+
+void
+UwLogWriter::wake()
+{
+	if (!wake_pending.exchange(true)) {
+		std::lock_guard<std::mutex> lock(wake_m);
+		wake_cv.notify_one();
+	}
+}
@@ -0,0 +1,200 @@
+//
+// Copyright (c) 2018 Regents of the SIGNET lab, University of Padova.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. Neither the name of the University of Padova (SIGNET lab) nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file    uwlogwriter.h
+ * @version 0.1.0
+ * @brief   Background writer of the log file of a modem.
+ */
+
+#ifndef UWLOGWRITER_H
+#define UWLOGWRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * Class that writes the log records of a modem to its log file from a
+ * thread of its own. The records, already formatted, are pushed by any
+ * thread in a bounded lock free ring; the writer thread drains the ring
+ * every flush period, or as soon as an urgent record is pushed or the ring
+ * is half full, and writes the records with as few write() calls as
+ * possible. The records that find the ring full are dropped and counted.
+ */
+class UwLogWriter
+{
+public:
+	/**
+	 * Class constructor.
+	 */
+	UwLogWriter();
+
+	/**
+	 * Class destructor: writes the pending records and closes the file.
+	 */
+	~UwLogWriter();
+
+	/**
+	 * Method that sets the number of records of the ring. It has effect
+	 * only if called before open().
+	 * @param capacity number of records, rounded up to a power of two
+	 */
+	void setCapacity(size_t capacity);
+
+	/**
+	 * Method that sets the longest time a record waits in the ring.
+	 * @param period flush period in seconds, at least one millisecond
+	 */
+	void setFlushPeriod(double period);
+
+	/**
+	 * Method that opens the log file, in append mode, and starts the writer
+	 * thread. Only the first call after the construction or after close()
+	 * has effect, whatever its outcome; it can be called concurrently by
+	 * any thread.
+	 * @param path name of the log file
+	 * @return true if the file is open
+	 */
+	bool open(const std::string &path);
+
+	/**
+	 * @return true once open() has been called, until close() is called
+	 */
+	bool
+	isOpen() const
+	{
+		return opened.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * Method that writes the pending records, closes the file and stops the
+	 * writer thread. Records pushed afterwards are discarded, until the file
+	 * is opened again; no record may be pushed while close() runs.
+	 */
+	void close();
+
+	/**
+	 * Method that queues a record for the writer thread. Can be called by
+	 * any thread, and never blocks on the file.
+	 * @param rec record to write, newline included
+	 * @param len length of the record
+	 * @param urgent if true, the writer thread is woken up at once
+	 * @return false if the record has been dropped
+	 */
+	bool push(const char *rec, size_t len, bool urgent);
+
+	/**
+	 * @return the number of records queued since the last resetCounters()
+	 */
+	size_t
+	records() const
+	{
+		return n_records.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @return the number of records dropped since the last resetCounters()
+	 */
+	size_t
+	dropped() const
+	{
+		return n_dropped.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * Method that resets records() and dropped().
+	 */
+	void resetCounters();
+
+private:
+	/**
+	 * Slot of the ring. seq is the position of the record the slot can take
+	 * next, or that position plus one once the record is written in text.
+	 * text keeps its storage between records.
+	 */
+	struct Slot {
+		std::atomic<size_t> seq;
+		std::string text;
+	};
+
+	/**
+	 * Body of the writer thread.
+	 */
+	void run();
+
+	/**
+	 * Method that writes all the records found in the ring.
+	 */
+	void drain();
+
+	/**
+	 * Method that writes the whole batch to the file.
+	 */
+	void flushBatch();
+
+	/**
+	 * Method that wakes up the writer thread.
+	 */
+	void wake();
+
+	static const size_t CACHE_LINE = 64; /**< Size of a cache line */
+	static const size_t BATCH_BYTES = 1 << 16; /**< Bytes per write() */
+
+	std::unique_ptr<Slot[]> slots; /**< Ring of records */
+	size_t capacity; /**< Number of records of the ring */
+	size_t mask; /**< Capacity minus one */
+	int fd; /**< Descriptor of the log file */
+	int flush_ms; /**< Flush period in milliseconds */
+
+	char pad_0[CACHE_LINE];
+	std::atomic<size_t> head; /**< Position of the next record to write */
+	char pad_1[CACHE_LINE - sizeof(std::atomic<size_t>)];
+	std::atomic<size_t> tail; /**< Position of the next record to push */
+	char pad_2[CACHE_LINE - sizeof(std::atomic<size_t>)];
+
+	std::atomic<bool> opened; /**< Set by open(), cleared by close() */
+	std::atomic<bool> running; /**< Cleared to stop the writer thread */
+	std::atomic<bool> wake_pending; /**< Set to wake up the writer */
+	std::mutex open_m; /**< Serializes open() and close() */
+	std::mutex wake_m; /**< Mutex of wake_cv */
+	std::condition_variable wake_cv; /**< Wakes up the writer thread */
+	std::thread writer; /**< Writer thread */
+	std::string batch; /**< Records gathered for a single write() */
+	size_t n_reported; /**< Value of n_lost already noted in the file */
+
+	std::atomic<size_t> n_records; /**< Records queued */
+	std::atomic<size_t> n_dropped; /**< Records dropped, ring full */
+	std::atomic<size_t> n_lost; /**< As n_dropped, but never reset */
+};
+
+#endif
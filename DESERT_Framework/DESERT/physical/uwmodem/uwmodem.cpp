@@ -26,9 +26,29 @@
 // OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
-#include <iomanip>
+#include <cstdio>
+#include <sstream>
+#include <sys/eventfd.h>
+#include <unistd.h>
 #include <uwmodem.h>
+#include <uwreactor.h>
+
+namespace
+{
+
+template <typename T>
+void
+printQueueStats(
+		std::ostream &os, const char *name, const UwSpscQueue<T> &q)
+{
+	os << "{" << name << " " << q.size() << " " << q.maxDepth() << " "
+	   << q.overruns() << " " << q.capacity() << "} ";
+}
+
+} // namespace
 
 bool
 UwModem::string2log(const std::string &ll_string, LogLevel &ll)
@@ -70,57 +90,90 @@ UwModem::UwModem()
 	: MPhy()
 	, modemID(0)
 	, data_buffer()
+	, rx_len(0)
 	, tx_queue()
 	, rx_queue()
 	, DATA_BUFFER_LEN(0)
 	, MAX_READ_BYTES(0)
+	, queue_size(64)
+	, use_reactor(0)
+	, in_reactor(false)
+	, tx_deadline()
 	, modem_address("")
 	, debug_(0)
-	, outLog()
+	, log_writer()
 	, logFile("modem_")
 	, log_suffix("_log")
 	, loglevel_(LogLevel::ERROR)
-	, log_is_open(false)
+	, log_queue_size(1024)
+	, log_flush_period(0.1)
 	, checkTimer(NULL)
 	, period(0.01)
-	, event_q()
+	, event_wakeup(0)
+	, notifier(NULL)
+	, rx_events()
+	, tx_events()
+	, rx_spill()
+	, tx_spill()
 {
 	bind("debug_", (int *) &debug_);
 	bind("period_", (double *) &period);
 	bind("buffer_size", (unsigned int *) &DATA_BUFFER_LEN);
 	bind("max_read_size", (int *) &MAX_READ_BYTES);
 	bind("ID_", (int *) &modemID);
+	bind("use_reactor", (int *) &use_reactor);
+	bind("event_wakeup", (int *) &event_wakeup);
+	bind("queue_size", (int *) &queue_size);
+	bind("log_queue_size", (int *) &log_queue_size);
+	bind("log_flush_period", (double *) &log_flush_period);
 }
 
 UwModem::~UwModem()
 {
-	outLog.flush();
-	outLog.close();
+	log_writer.close();
+	delete notifier;
 }
 
 void
-UwModem::printOnLog(LogLevel log_level, std::string module, std::string message)
-{
-
-	LogLevel actual_log_level = getLogLevel();
-	if (actual_log_level >= log_level) {
-		double timestamp =
-				(double) (std::chrono::duration_cast<std::chrono::milliseconds>(
-						std::chrono::system_clock::now().time_since_epoch())
-								  .count()) /
-				1000.0;
-		if (!log_is_open) {
-			outLog.open((getLogFile()).c_str(), ios::app);
-			log_is_open = true;
-		}
-		std::string ll_descriptor = "";
-		log2string(log_level, ll_descriptor);
-
-		outLog << std::setprecision(15) << left << ll_descriptor << "::["
-			   << timestamp << "]::[" << NOW << "]::" << module << "("
-			   << modemID << ")::" << message << endl;
-		outLog.flush();
+UwModem::writeLog(LogLevel log_level, const char *module, const char *message,
+		size_t len, const char *detail, size_t detail_len)
+{
+	if (!log_writer.isOpen()) {
+		log_writer.setCapacity(log_queue_size);
+		log_writer.setFlushPeriod(log_flush_period);
+		log_writer.open(getLogFile());
 	}
+
+	double timestamp =
+			(double) (std::chrono::duration_cast<std::chrono::milliseconds>(
+					std::chrono::system_clock::now().time_since_epoch())
+							  .count()) /
+			1000.0;
+	std::string ll_descriptor = "";
+	log2string(log_level, ll_descriptor);
+
+	// one record per thread, whose storage is reused from call to call
+	static thread_local std::string record;
+	char prefix[128];
+	int n = snprintf(prefix,
+			sizeof(prefix),
+			"%s::[%.15g]::[%.15g]::",
+			ll_descriptor.c_str(),
+			timestamp,
+			NOW);
+	record.assign(
+			prefix, std::min(static_cast<size_t>(n), sizeof(prefix) - 1));
+	record.append(module);
+	record += '(';
+	record += std::to_string(modemID);
+	record += ")::";
+	record.append(message, len);
+	if (detail_len > 0)
+		record.append(detail, detail_len);
+	record += '\n';
+
+	log_writer.push(
+			record.data(), record.size(), log_level == LogLevel::ERROR);
 }
 
 int
@@ -137,6 +190,32 @@ UwModem::command(int argc, const char *const *argv)
 			stop();
 			return TCL_OK;
 		}
+		if (!strcmp(argv[1], "getQueueStats")) {
+			// for each queue, the list {name size max_size overruns capacity}
+			std::ostringstream stats;
+			printQueueStats(stats, "tx_queue", tx_queue);
+			printQueueStats(stats, "rx_events", rx_events);
+			printQueueStats(stats, "tx_events", tx_events);
+			tcl.result(stats.str().c_str());
+			return TCL_OK;
+		}
+		if (!strcmp(argv[1], "getLogStats")) {
+			// records queued and records dropped by the log writer
+			std::ostringstream stats;
+			stats << log_writer.records() << " " << log_writer.dropped();
+			tcl.result(stats.str().c_str());
+			return TCL_OK;
+		}
+		if (!strcmp(argv[1], "resetLogStats")) {
+			log_writer.resetCounters();
+			return TCL_OK;
+		}
+		if (!strcmp(argv[1], "resetQueueStats")) {
+			tx_queue.resetCounters();
+			rx_events.resetCounters();
+			tx_events.resetCounters();
+			return TCL_OK;
+		}
 	} else if (argc == 3) {
 		if (!strcmp(argv[1], "setModemAddress")) {
 			modem_address = argv[2];
@@ -166,19 +245,195 @@ UwModem::endTx(Packet *p)
 	Packet::free(p);
 }
 
+int
+UwModem::readRx(UwConnector *conn)
+{
+	if (data_buffer.size() != DATA_BUFFER_LEN) {
+		data_buffer.resize(DATA_BUFFER_LEN);
+	}
+	if (rx_len >= data_buffer.size()) {
+		printOnLog(LogLevel::ERROR,
+				"UWMODEM",
+				"readRx::BUFFER_FULL::DISCARDED=",
+				std::to_string(rx_len));
+		rx_len = 0;
+	}
+
+	int max_len = std::min(static_cast<size_t>(MAX_READ_BYTES),
+			data_buffer.size() - rx_len);
+	int r_bytes = conn->readFromDevice(&data_buffer[rx_len], max_len);
+	if (r_bytes > 0) {
+		rx_len += r_bytes;
+	}
+	return r_bytes;
+}
+
+void
+UwModem::waitTx(UwConnector *conn, std::chrono::milliseconds delay)
+{
+	tx_deadline = std::chrono::steady_clock::now() + delay;
+	UwReactor::instance().setTimer(conn, delay);
+}
+
+void
+UwModem::pushEvent(UwSpscQueue<ModemEvent> &q, const ModemEvent &e)
+{
+	EventSpill &s = (&q == &rx_events) ? rx_spill : tx_spill;
+	if (s.active.load() || !q.push(e)) {
+		std::lock_guard<std::mutex> lock(s.m);
+		if (s.events.empty()) {
+			printOnLog(LogLevel::ERROR, "UWMODEM", "pushEvent::QUEUE_FULL");
+		}
+		s.events.push_back(e);
+		s.active.store(true);
+	}
+	if (notifier) {
+		notifier->notify();
+	}
+}
+
+void
+UwModem::startEventCheck()
+{
+	if (event_wakeup) {
+		if (!notifier) {
+			notifier = new EventNotifier(this);
+		}
+		if (notifier->open()) {
+			return;
+		}
+		printOnLog(LogLevel::ERROR,
+				"UWMODEM",
+				"startEventCheck::NOTIFIER_OPEN_FAILED::USING_TIMER");
+		delete notifier;
+		notifier = NULL;
+	}
+
+	if (!checkTimer) {
+		checkTimer = new CheckTimer(this);
+	}
+	checkTimer->resched(period);
+}
+
+void
+UwModem::stopEventCheck()
+{
+	if (notifier) {
+		delete notifier;
+		notifier = NULL;
+	}
+	if (checkTimer) {
+		checkTimer->force_cancel();
+	}
+}
+
+void
+UwModem::resizeQueues()
+{
+	checkEvent();
+	rx_events.resize(queue_size);
+	tx_events.resize(queue_size);
+
+	std::vector<Packet *> queued;
+	Packet *p = NULL;
+	while (tx_queue.pop(p)) {
+		queued.push_back(p);
+	}
+	tx_queue.resize(queue_size);
+	for (size_t i = 0; i < queued.size(); i++) {
+		if (!tx_queue.push(queued[i])) {
+			printOnLog(LogLevel::ERROR, "UWMODEM", "resizeQueues::TX_QUEUE_FULL");
+			endTx(queued[i]);
+		}
+	}
+}
+
 void
 UwModem::checkEvent()
 {
-	while (event_q.size() > 0) {
-		ModemEvent e = event_q.front();
+	runEvents(tx_events, tx_spill);
+	runEvents(rx_events, rx_spill);
+}
+
+void
+UwModem::runEvents(UwSpscQueue<ModemEvent> &q, EventSpill &s)
+{
+	ModemEvent e;
+	while (q.pop(e)) {
 		e.f(*this, e.p);
-		event_q.pop();
 	}
-	checkTimer->resched(period);
+	if (!s.active.load()) {
+		return;
+	}
+
+	// the events in q were all pushed before the spilled ones, and the
+	// following ones go to q only after active is cleared
+	std::vector<ModemEvent> spilled;
+	{
+		std::lock_guard<std::mutex> lock(s.m);
+		spilled.swap(s.events);
+		s.active.store(false);
+	}
+	for (size_t i = 0; i < spilled.size(); i++) {
+		spilled[i].f(*this, spilled[i].p);
+	}
 }
 
 void
 CheckTimer::expire(Event *e)
 {
 	pmModem->checkEvent();
+	resched(pmModem->period);
+}
+
+EventNotifier::EventNotifier(UwModem *pmModem_)
+	: IOHandler()
+	, pmModem(pmModem_)
+	, event_fd(-1)
+{
+}
+
+EventNotifier::~EventNotifier()
+{
+	if (event_fd >= 0) {
+		unlink();
+		close(event_fd);
+	}
+}
+
+bool
+EventNotifier::open()
+{
+	if (event_fd >= 0) {
+		return true;
+	}
+	event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (event_fd < 0) {
+		return false;
+	}
+	link(event_fd, TCL_READABLE);
+	return true;
+}
+
+void
+EventNotifier::notify()
+{
+	uint64_t one = 1;
+	if (write(event_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+		std::cerr << "EVENTNOTIFIER::ERROR::" + std::to_string(errno)
+				  << std::endl;
+	}
+}
+
+void
+EventNotifier::dispatch(int mask)
+{
+	// reset the counter before checking, not to lose the events pushed
+	// meanwhile
+	uint64_t count;
+	if (read(event_fd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+		std::cerr << "EVENTNOTIFIER::ERROR::" + std::to_string(errno)
+				  << std::endl;
+	}
+	pmModem->checkEvent();
 }
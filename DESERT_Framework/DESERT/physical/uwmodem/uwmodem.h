@@ -37,21 +37,58 @@
 #ifndef UWMODEM_H
 #define UWMODEM_H
 
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
+#include <vector>
 
+#include <atomic>
 #include <functional>
 #include <hdr-uwal.h>
+#include <iohandler.h>
 #include <mac.h>
 #include <mphy.h>
 #include <tclcl.h>
 #include <uwal.h>
+#include <uwconnector.h>
 #include <uwip-module.h>
+#include <uwlogwriter.h>
+#include <uwspscqueue.h>
 
 class CheckTimer;
-struct ModemEvent;
+class EventNotifier;
+class UwModem;
+
+/**
+ * Callback that a modem thread schedules for NS2 to execute.
+ */
+struct ModemEvent {
+	std::function<void(UwModem &, Packet *p)> f;
+	Packet *p;
+};
+
+/**
+ * Events that found their queue full, kept in order for NS2 to execute.
+ * While active is set, the producer appends its events here instead of to
+ * the queue, so that they are executed in the order they were pushed.
+ */
+struct EventSpill {
+	EventSpill()
+		: m()
+		, events()
+		, active(false)
+	{
+	}
+
+	std::mutex m; /**< Mutex of events */
+	std::vector<ModemEvent> events; /**< Events waiting for NS2 */
+	std::atomic<bool> active; /**< Set while events is not empty */
+};
+
 /**
  * Class that implements the interface to DESERT, as used through Tcl scripts.
  * This class provides common functions to operate as a physical layer;
@@ -61,6 +98,7 @@ struct ModemEvent;
 class UwModem : public MPhy
 {
 	friend class CheckTimer;
+	friend class EventNotifier;
 
 public:
 	/**
@@ -176,9 +214,52 @@ public:
 
 	/**
 	 * Function that, given the appropriate level of log, prints to the set
-	 * log file the provided log message.
+	 * log file the provided log message. Nothing is formatted if the level
+	 * is filtered out; the record is written by the UwLogWriter thread.
+	 */
+	void
+	printOnLog(LogLevel log_level, const char *module, const std::string &message)
+	{
+		if (loglevel_ >= log_level) {
+			writeLog(log_level, module, message.data(), message.size());
+		}
+	}
+
+	/**
+	 * Same as above, for a message that is a string literal.
+	 */
+	void
+	printOnLog(LogLevel log_level, const char *module, const char *message)
+	{
+		if (loglevel_ >= log_level) {
+			writeLog(log_level, module, message, strlen(message));
+		}
+	}
+
+	/**
+	 * Same as above, for a literal message followed by a variable part,
+	 * which are joined in the log record only if the level is enabled.
 	 */
-	void printOnLog(LogLevel log_level, string module, string message);
+	void
+	printOnLog(LogLevel log_level, const char *module, const char *message,
+			const char *detail, size_t detail_len)
+	{
+		if (loglevel_ >= log_level) {
+			writeLog(log_level,
+					module,
+					message,
+					strlen(message),
+					detail,
+					detail_len);
+		}
+	}
+
+	void
+	printOnLog(LogLevel log_level, const char *module, const char *message,
+			const std::string &detail)
+	{
+		printOnLog(log_level, module, message, detail.data(), detail.size());
+	}
 
 	/**
 	 * Method to return the flag used to enable the printing of log messages in
@@ -230,8 +311,14 @@ protected:
 	 */
 	std::vector<char> data_buffer;
 
-	/** Modem's transmission queue: holds packets that are to be transmitted */
-	std::queue<Packet *> tx_queue;
+	/** Number of bytes of data_buffer holding data not parsed yet */
+	size_t rx_len;
+
+	/**
+	 * Modem's transmission queue: holds packets that are to be transmitted.
+	 * Filled by NS2, emptied by the transmitting thread.
+	 */
+	UwSpscQueue<Packet *> tx_queue;
 
 	/** Modem's reception queue: holds packets eceived from the channel awaiting
 	 * to be pushed up the stack
@@ -244,6 +331,22 @@ protected:
 	/** Maximum number of bytes to be read by a single dump of data */
 	int MAX_READ_BYTES;
 
+	/** Capacity of tx_queue, rx_events and tx_events, applied by start() */
+	int queue_size;
+
+	/**
+	 * If set, the connector is served by the UwReactor shared by all the
+	 * modems of the process, in place of the receiving and transmitting
+	 * threads of the modem.
+	 */
+	int use_reactor;
+
+	/** True while the connector is served by the UwReactor */
+	bool in_reactor;
+
+	/** End of the wait of the transmission running on the reactor */
+	std::chrono::steady_clock::time_point tx_deadline;
+
 	/**
 	 * String containing the address needed to connect to the device
 	 * In case of socket, it may be expressed as: 192.168.XXX.XXX:PORTNUM
@@ -254,19 +357,37 @@ protected:
 	/** Usual debug value that chooses the debug level through Tcl interface */
 	int debug_;
 
-	std::ofstream outLog; /**< output strem to print into a disk-file log
-							 messages. See UwEvoLogicsS2CModem::logFile.*/
+	UwLogWriter log_writer; /**< Writer of the disk-file log messages.
+							  See UwEvoLogicsS2CModem::logFile.*/
 	std::string logFile; /**< Name of the disk-file where to write the
 							interface's log messages.*/
 	std::string log_suffix; /**< Possibility to insert a log suffix */
 	LogLevel loglevel_; /**< Log level on file, from ERROR (0) to DEBUG (2) in
 					  UwEvoLogicsS2CModem::logFile. */
-	bool log_is_open; /**< Flag to check if log file has already be opened*/
+	int log_queue_size; /**< Number of records queued to log_writer */
+	double log_flush_period; /**< Longest wait of a record in log_writer */
 	CheckTimer *checkTimer; /**< Pointer to an object to schedule the
 							  "check-modem" events. */
 	double period; /**< Checking period of the modem's buffer. */
-	/** Queue of events that are scheduled for NS2 to execute (callbacks) */
-	std::queue<ModemEvent> event_q;
+	/**
+	 * If set, the event queues are checked as soon as an event is pushed,
+	 * through an EventNotifier, in place of every period seconds. Requires
+	 * the RealTime scheduler, whose loop dispatches the file events of Tcl.
+	 */
+	int event_wakeup;
+	EventNotifier *notifier; /**< Object signalling the pushed events. */
+	/**
+	 * Queue of events that are scheduled for NS2 to execute (callbacks),
+	 * filled by the thread parsing the data received from the modem.
+	 */
+	UwSpscQueue<ModemEvent> rx_events;
+	/**
+	 * Queue of events that are scheduled for NS2 to execute (callbacks),
+	 * filled by the transmitting thread.
+	 */
+	UwSpscQueue<ModemEvent> tx_events;
+	EventSpill rx_spill; /**< Events that found rx_events full */
+	EventSpill tx_spill; /**< Events that found tx_events full */
 
 	/**
 	 * Method that triggers the transmission of a packet through a specified
@@ -307,14 +428,94 @@ protected:
 	/**
 	 * Method that stops the driver operations. It performs all the needed
 	 * operations to correctly stop the device's driver before closing the
-	 * simulation.
+	 * simulation, and closes log_writer once the modem threads are joined,
+	 * since the modem may never be deleted.
 	 */
 	virtual void stop() = 0;
 
+	/**
+	 * Method that formats a log record and queues it to log_writer, opening
+	 * the log file the first time.
+	 * @param log_level level of the message
+	 * @param module name of the module logging the message
+	 * @param message message to log
+	 * @param len length of the message
+	 * @param detail text appended to the message, if any
+	 * @param detail_len length of detail
+	 */
+	void writeLog(LogLevel log_level, const char *module, const char *message,
+			size_t len, const char *detail = NULL, size_t detail_len = 0);
+
+	/**
+	 * Method that appends the data available on a connector to data_buffer,
+	 * after the rx_len bytes not parsed yet. If data_buffer is full, the
+	 * unparsed data is discarded first.
+	 * @param conn connector to read from
+	 * @return the number of bytes read, as returned by
+	 *         UwConnector::readFromDevice
+	 */
+	int readRx(UwConnector *conn);
+
+	/**
+	 * Method that suspends the transmission running on the reactor thread
+	 * until a response is parsed or the delay elapses, whichever comes
+	 * first: the transmission step is called again in both cases.
+	 * @param conn connector of the modem, watched by the reactor
+	 * @param delay longest wait
+	 */
+	void waitTx(UwConnector *conn, std::chrono::milliseconds delay);
+
+	/**
+	 * @return true if the delay of the last waitTx() has elapsed
+	 */
+	bool
+	txExpired() const
+	{
+		return std::chrono::steady_clock::now() >= tx_deadline;
+	}
+
+	/**
+	 * Method that queues an event for NS2 to execute, and wakes up the
+	 * scheduler if event_wakeup is set. Called by the modem threads, each
+	 * on its own queue. If the queue is full the event goes to the spill of
+	 * the queue: it is never dropped, since its packet must reach NS2.
+	 * @param q rx_events or tx_events, depending on the calling thread
+	 * @param e event to execute
+	 */
+	void pushEvent(UwSpscQueue<ModemEvent> &q, const ModemEvent &e);
+
+	/**
+	 * Method that starts checking the event queues: through the EventNotifier if
+	 * event_wakeup is set and the notifier can be opened, through the
+	 * CheckTimer otherwise.
+	 */
+	void startEventCheck();
+
+	/**
+	 * Method that stops checking the event queues.
+	 */
+	void stopEventCheck();
+
+	/**
+	 * Method that sets the capacity of tx_queue, rx_events and tx_events to
+	 * queue_size. To be called by start() before the modem threads are
+	 * spawned: the packets queued by NS2 are kept, while the events left by
+	 * a previous run are executed first.
+	 */
+	void resizeQueues();
+
 	/**
 	 * Method to check if any event from real world has to go to ns
 	 */
 	void checkEvent();
+
+	/**
+	 * Method that executes the events of a queue and then those of its
+	 * spill.
+	 * @param q rx_events or tx_events
+	 * @param s spill of q
+	 */
+	void runEvents(UwSpscQueue<ModemEvent> &q, EventSpill &s);
 };
 
 /**
@@ -356,9 +557,50 @@ protected:
 							  expires.*/
 };
 
-struct ModemEvent {
-	std::function<void(UwModem &, Packet *p)> f;
-	Packet *p;
+/**
+ * The class used by UwModem to wake up the RealTime scheduler as soon as an
+ * event is pushed in its event queues by a modem thread. The threads signal
+ * an eventfd, which is watched by the Tcl event loop run by the scheduler:
+ * the queues are then checked by the scheduler thread, with no polling
+ * period.
+ */
+class EventNotifier : public IOHandler
+{
+public:
+	/**
+	 * Class constructor.
+	 *
+	 * @param pmModem_ pointer to the UwModem object to link with this
+	 *EventNotifier object.
+	 */
+	EventNotifier(UwModem *pmModem_);
+
+	/**
+	 * Class destructor: closes the eventfd.
+	 */
+	virtual ~EventNotifier();
+
+	/**
+	 * Method that creates the eventfd and links it to the Tcl event loop.
+	 * @return true if the notifier is ready
+	 */
+	bool open();
+
+	/**
+	 * Method that wakes up the scheduler. Can be called by any thread.
+	 */
+	void notify();
+
+protected:
+	/**
+	 * Method called by the Tcl event loop when the eventfd is readable.
+	 *
+	 * @param mask Tcl event mask
+	 */
+	virtual void dispatch(int mask);
+
+	UwModem *pmModem; /**< Pointer to the UwModem whose events are checked.*/
+	int event_fd; /**< eventfd signalled by the modem threads.*/
 };
 
 #endif
@@ -0,0 +1,249 @@
+//
+// Copyright (c) 2019 Regents of the SIGNET lab, University of Padova.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. Neither the name of the University of Padova (SIGNET lab) nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+/**
+ * @file    uwspscqueue.h
+ * @version 0.1.0
+ * @brief   Bounded single producer, single consumer queue used between the
+ * 			simulator and the threads of the modems.
+ */
+
+#ifndef UWSPSCQUEUE_H
+#define UWSPSCQUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * Bounded lock free queue for exactly one producer thread and one consumer
+ * thread. The elements live in a ring whose size is a power of two; the
+ * producer only writes the tail index and the consumer only writes the head
+ * index, each on its own cache line. A mutex is taken only by a consumer
+ * blocked in waitPop() on an empty queue, and by the producer waking it up.
+ */
+template <typename T>
+class UwSpscQueue
+{
+public:
+	/**
+	 * Class constructor.
+	 * @param capacity number of elements, rounded up to a power of two
+	 */
+	explicit UwSpscQueue(size_t capacity = 64)
+		: slots()
+		, mask(0)
+		, head(0)
+		, tail(0)
+		, waiting(false)
+		, wait_m()
+		, wait_cv()
+		, n_overruns(0)
+		, max_depth(0)
+	{
+		resize(capacity);
+	}
+
+	/**
+	 * Method that changes the capacity of the queue, discarding its
+	 * content. It must not run concurrently with any other method.
+	 * @param capacity number of elements, rounded up to a power of two
+	 */
+	void
+	resize(size_t capacity)
+	{
+		size_t n = 2;
+		while (n < capacity)
+			n <<= 1;
+		slots.assign(n, T());
+		mask = n - 1;
+		head.store(0);
+		tail.store(0);
+	}
+
+	/**
+	 * Producer side: method that appends an element, if there is room.
+	 * @param v element to append
+	 * @return false, and an overrun is counted, if the queue is full
+	 */
+	bool
+	push(const T &v)
+	{
+		size_t t = tail.load(std::memory_order_relaxed);
+		size_t depth = t - head.load(std::memory_order_acquire);
+		if (depth > mask) {
+			n_overruns.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		slots[t & mask] = v;
+		// seq_cst, to be ordered with the load of waiting
+		tail.store(t + 1);
+
+		if (depth + 1 > max_depth.load(std::memory_order_relaxed)) {
+			max_depth.store(depth + 1, std::memory_order_relaxed);
+		}
+		if (waiting.load()) {
+			std::lock_guard<std::mutex> lock(wait_m);
+			wait_cv.notify_one();
+		}
+		return true;
+	}
+
+	/**
+	 * Consumer side: method that removes the first element, if any.
+	 * @param v set to the element removed
+	 * @return false if the queue is empty
+	 */
+	bool
+	pop(T &v)
+	{
+		size_t h = head.load(std::memory_order_relaxed);
+		if (h == tail.load(std::memory_order_acquire)) {
+			return false;
+		}
+		v = std::move(slots[h & mask]);
+		slots[h & mask] = T();
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Consumer side: method that removes the first element, blocking while
+	 * the queue is empty and running is true.
+	 * @param v set to the element removed
+	 * @param running flag that keeps the consumer waiting, see wakeUp()
+	 * @return false if running became false before an element was found
+	 */
+	bool
+	waitPop(T &v, const std::atomic<bool> &running)
+	{
+		while (running.load()) {
+			if (pop(v)) {
+				return true;
+			}
+			std::unique_lock<std::mutex> lock(wait_m);
+			waiting.store(true);
+			if (empty() && running.load()) {
+				wait_cv.wait(lock);
+			}
+			waiting.store(false);
+		}
+		return false;
+	}
+
+	/**
+	 * Method that wakes up the consumer blocked in waitPop(), to be called
+	 * after its running flag has been cleared.
+	 */
+	void
+	wakeUp()
+	{
+		std::lock_guard<std::mutex> lock(wait_m);
+		wait_cv.notify_all();
+	}
+
+	/**
+	 * @return true if the queue has no elements
+	 */
+	bool
+	empty() const
+	{
+		return head.load() == tail.load();
+	}
+
+	/**
+	 * @return the number of elements in the queue
+	 */
+	size_t
+	size() const
+	{
+		return tail.load() - head.load();
+	}
+
+	/**
+	 * @return the maximum number of elements of the queue
+	 */
+	size_t
+	capacity() const
+	{
+		return mask + 1;
+	}
+
+	/**
+	 * @return the highest number of elements reached by the queue
+	 */
+	size_t
+	maxDepth() const
+	{
+		return max_depth.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @return the number of elements refused because the queue was full
+	 */
+	size_t
+	overruns() const
+	{
+		return n_overruns.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * Method that resets maxDepth() and overruns().
+	 */
+	void
+	resetCounters()
+	{
+		n_overruns.store(0, std::memory_order_relaxed);
+		max_depth.store(0, std::memory_order_relaxed);
+	}
+
+private:
+	static const size_t CACHE_LINE = 64; /**< Size of a cache line */
+
+	std::vector<T> slots; /**< Ring of elements */
+	size_t mask; /**< Capacity minus one */
+
+	char pad_0[CACHE_LINE];
+	std::atomic<size_t> head; /**< Index of the next element to pop */
+	char pad_1[CACHE_LINE - sizeof(std::atomic<size_t>)];
+	std::atomic<size_t> tail; /**< Index of the next element to push */
+	char pad_2[CACHE_LINE - sizeof(std::atomic<size_t>)];
+
+	std::atomic<bool> waiting; /**< Set while the consumer is blocked */
+	std::mutex wait_m; /**< Mutex of wait_cv */
+	std::condition_variable wait_cv; /**< Wakes up the blocked consumer */
+	std::atomic<size_t> n_overruns; /**< Elements refused, queue full */
+	std::atomic<size_t> max_depth; /**< Highest number of elements */
+};
+
+#endif
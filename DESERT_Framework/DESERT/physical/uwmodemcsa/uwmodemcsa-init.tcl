@@ -30,3 +30,8 @@ Module/UW/UwModem/ModemCSA set debug_    0
 Module/UW/UwModem/ModemCSA set max_read_size    2000
 Module/UW/UwModem/ModemCSA set period_    0.01
 Module/UW/UwModem/ModemCSA set buffer_size    2000
+Module/UW/UwModem/ModemCSA set use_reactor    0
+Module/UW/UwModem/ModemCSA set event_wakeup    0
+Module/UW/UwModem/ModemCSA set queue_size    64
+Module/UW/UwModem/ModemCSA set log_queue_size    1024
+Module/UW/UwModem/ModemCSA set log_flush_period    0.1
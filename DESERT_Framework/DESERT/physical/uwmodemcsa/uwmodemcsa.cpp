@@ -31,9 +31,11 @@
 #include <uwal.h>
 #include <uwmodemcsa.h>
 #include <uwphy-clmsg.h>
+#include <uwreactor.h>
 #include <uwsocket.h>
 
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <algorithm>
@@ -71,9 +73,7 @@ UwModemCSA::UwModemCSA()
 	, p_connector(new UwSocket())
 	, status(ModemState::AVAILABLE)
 	, status_m()
-	, tx_queue_m()
 	, status_cv()
-	, tx_queue_cv()
 	, receiving(false)
 	, transmitting(false)
 	, rx_thread()
@@ -138,15 +138,17 @@ UwModemCSA::recv(Packet *p)
 		ph->modulationType = getModulationType(p);
 		ph->duration = getTxDuration(p);
 
-		std::unique_lock<std::mutex> tx_lock(tx_queue_m);
-		
-		tx_queue.push(p);
-		tx_lock.unlock();
-
+		if (!tx_queue.push(p)) {
+			printOnLog(LogLevel::ERROR, "MODEMCSA", "recv::TX_QUEUE_FULL");
+			endTx(p);
+			return;
+		}
+		if (in_reactor) {
+			UwReactor::instance().post(p_connector.get());
+		}
 		printOnLog(LogLevel::DEBUG,
 				"MODEMCSA",
 				"recv::PUSHING_IN_TX_QUEUE");
-		tx_queue_cv.notify_one();
 	}
 }
 
@@ -188,7 +190,7 @@ UwModemCSA::startTx(Packet *p)
 	hdr_mac *mach = HDR_MAC(p);
 	hdr_uwal *uwalh = HDR_UWAL(p);
 	std::string payload;
-	payload.assign(uwalh->binPkt(), uwalh->binPktLength());
+	payload.assign(hdr_uwal::binPkt(p), uwalh->binPktLength());
 
 	// build command to perform a SEND
 	std::string cmd_s;
@@ -196,7 +198,7 @@ UwModemCSA::startTx(Packet *p)
 
 	printOnLog(LogLevel::INFO,
 			"MODEMCSA",
-			"startTx::COMMAND_TX::" + cmd_s);
+			"startTx::COMMAND_TX::", cmd_s);
 
 	// write the obtained command to the device, through the connector
 	std::unique_lock<std::mutex> state_lock(status_m);
@@ -209,7 +211,8 @@ UwModemCSA::startTx(Packet *p)
 		if ((p_connector->writeToDevice(cmd_s)) < 0) {
 			printOnLog(LogLevel::ERROR,
 					"MODEMCSA",
-					"startTx::FAIL_TO_WRITE_TO_DEVICE=" + cmd_s);
+					"startTx::FAIL_TO_WRITE_TO_DEVICE=", cmd_s);
+			status = ModemState::AVAILABLE;
 			return;
 		}
 
@@ -218,7 +221,7 @@ UwModemCSA::startTx(Packet *p)
 		std::function<void(UwModem &, Packet * p)> callback =
 				&UwModem::realTxEnded;
 		ModemEvent e = {callback, p};
-		event_q.push(e);
+		pushEvent(tx_events, e);
 	}
 
 	return;
@@ -278,17 +281,26 @@ UwModemCSA::start()
 		return;
 	}
 
+	resizeQueues();
+	startEventCheck();
+
 	// set flags to true so loops can start
 	receiving.store(true);
 	transmitting.store(true);
 
 	// branch off threads
-	rx_thread = std::thread(&UwModemCSA::receivingData, this);
-
-	tx_thread = std::thread(&UwModemCSA::transmittingData, this);
-
-	checkTimer = new CheckTimer(this);
-	checkTimer->resched(period);
+	rx_len = 0;
+	in_reactor = use_reactor &&
+			UwReactor::instance().add(p_connector.get(),
+					std::bind(&UwModemCSA::readAvailable, this),
+					std::bind(&UwModemCSA::sendQueued, this));
+	if (in_reactor) {
+		// send the packets queued before the start, if any
+		UwReactor::instance().post(p_connector.get());
+	} else {
+		rx_thread = std::thread(&UwModemCSA::receivingData, this);
+		tx_thread = std::thread(&UwModemCSA::transmittingData, this);
+	}
 }
 
 
@@ -300,9 +312,13 @@ UwModemCSA::stop()
 
 	receiving.store(false);
 	transmitting.store(false);
-	tx_queue_cv.notify_one();
+	tx_queue.wakeUp();
 	if (tx_thread.joinable())
 		tx_thread.join();
+	if (in_reactor) {
+		UwReactor::instance().remove(p_connector.get());
+		in_reactor = false;
+	}
 	if (p_connector->isConnected() && !p_connector->closeConnection()) {
 		printOnLog(LogLevel::ERROR,
 				"MODEMCSA",
@@ -312,7 +328,8 @@ UwModemCSA::stop()
 		rx_thread.join();
 	}
 
-	checkTimer->force_cancel();
+	stopEventCheck();
+	log_writer.close();
 }
 
 
@@ -321,16 +338,10 @@ UwModemCSA::transmittingData()
 {
 	while (transmitting.load()) {
 
-		std::unique_lock<std::mutex> tx_lock(tx_queue_m);
-		tx_queue_cv.wait(
-				tx_lock, [&] { return !tx_queue.empty() || !transmitting; });
-		if (!transmitting) {
+		Packet *pck = NULL;
+		if (!tx_queue.waitPop(pck, transmitting)) {
 			break;
 		}
-
-		Packet *pck = tx_queue.front();
-		tx_queue.pop();
-		tx_lock.unlock();
 		if (pck) {
 			startTx(pck);
 		}
@@ -345,42 +356,60 @@ UwModemCSA::transmittingData()
 void
 UwModemCSA::receivingData()
 {
-	data_buffer.resize(DATA_BUFFER_LEN);
-	std::fill(data_buffer.begin(), data_buffer.end(), '\0');
-	// iterators that keep track of read/write operations
-	std::vector<char>::iterator beg_it = data_buffer.begin();
-	std::vector<char>::iterator end_it = data_buffer.begin();
-	// iterators that keep track of commands research
-	std::vector<char>::iterator cmd_b = data_buffer.begin();
-	std::vector<char>::iterator cmd_e = data_buffer.begin();
-	std::string cmd("");
-	int r_bytes = 0;
-	int offset = 0;
-
 	while (receiving.load()) {
+		if (readRx(p_connector.get()) > 0) {
+			parseRx();
+		}
+	}
+}
 
-		r_bytes = p_connector->readFromDevice(
-				&(*beg_it) + offset, MAX_READ_BYTES - r_bytes);
-
-		end_it += r_bytes;
-
-		if (receiving.load() && r_bytes > 0 &&
-				(cmd = findCommand(beg_it, end_it, cmd_b, cmd_e)) != "") {
-
-			offset = std::distance(cmd_e, end_it);
-			if (parseCommand(cmd_b, cmd_e, rx_payload)) {
+void
+UwModemCSA::readAvailable()
+{
+	while (readRx(p_connector.get()) > 0) {
+		parseRx();
+	}
+}
 
-				startRealRx(cmd);
-			}
+void
+UwModemCSA::sendQueued()
+{
+	Packet *pck = NULL;
+	while (tx_queue.pop(pck)) {
+		startTx(pck);
+	}
+}
 
-			offset = std::distance(cmd_e, end_it);
-			std::copy(cmd_e, end_it, beg_it);
-			std::fill(beg_it + offset, end_it, '\0');
-			end_it = beg_it + offset;
+void
+UwModemCSA::parseRx()
+{
+	std::vector<char>::iterator beg_it = data_buffer.begin();
+	std::vector<char>::iterator end_it = beg_it + rx_len;
+	// first byte not parsed yet
+	std::vector<char>::iterator left_it = beg_it;
+	// iterators that keep track of commands research
+	std::vector<char>::iterator cmd_b = beg_it;
+	std::vector<char>::iterator cmd_e = beg_it;
+	std::string cmd("");
 
-			cmd = "";
+	while ((cmd = findCommand(left_it, end_it, cmd_b, cmd_e)) != "") {
+		if (parseCommand(cmd_b, cmd_e, rx_payload)) {
+			startRealRx(cmd);
 		}
+		left_it = cmd_e;
+	}
+
+	if (cmd_b != end_it) {
+		// beginning of a command not complete yet
+		left_it = cmd_b;
+	} else if (std::distance(left_it, end_it) >= (int) del_b.size()) {
+		// keep what may be the beginning of a delimiter
+		left_it = end_it - (del_b.size() - 1);
 	}
+
+	// move the bytes left after parsing to the beginning
+	rx_len = std::distance(left_it, end_it);
+	std::copy(left_it, end_it, beg_it);
 }
 
 std::string
@@ -455,7 +484,7 @@ UwModemCSA::startRealRx(const std::string &cmd)
 	std::function<void(UwModem &, Packet * p)> callback =
 			&UwModem::recv;
 	ModemEvent e = {callback, p};
-	event_q.push(e);
+	pushEvent(rx_events, e);
 	// recv(p);
 
 }
@@ -465,7 +494,8 @@ UwModemCSA::createRxPacket(Packet *p)
 {
 	hdr_uwal *uwalh = HDR_UWAL(p);
 	uwalh->binPktLength() = rx_payload.size();
-	std::memset(uwalh->binPkt(), 0, uwalh->binPktLength());
-	std::copy(rx_payload.begin(), rx_payload.end(), uwalh->binPkt());
+	char *binPkt = hdr_uwal::writableBinPkt(p);
+	std::memset(binPkt, 0, uwalh->binPktLength());
+	std::copy(rx_payload.begin(), rx_payload.end(), binPkt);
 	HDR_CMN(p)->direction() = hdr_cmn::UP;
 }
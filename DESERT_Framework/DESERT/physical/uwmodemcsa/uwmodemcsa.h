@@ -137,6 +137,26 @@ private:
 	 */
 	virtual void receivingData();
 
+	/**
+	 * Method called by the UwReactor when the connector is readable: reads
+	 * and parses all the data available.
+	 */
+	void readAvailable();
+
+	/**
+	 * Method called by the UwReactor when packets are queued: sends all the
+	 * packets in tx_queue. Since the modem never has to be waited for, the
+	 * commands are written at once.
+	 */
+	void sendQueued();
+
+	/**
+	 * Method that parses the commands found in the first rx_len bytes of
+	 * data_buffer. The bytes of a command not yet complete are moved to the
+	 * beginning of the buffer, to be parsed after the next read.
+	 */
+	void parseRx();
+
 	/**
 	 * Method that finds the position of a command in a buffer.
 	 */
@@ -174,12 +194,8 @@ private:
 
 	/** Mutex associated with the state machine of the modem */
 	std::mutex status_m;
-	/** Mutex associated with the transmission queue */
-	std::mutex tx_queue_m;
 	/** Condition variable to wait for ModemState::AVAILABLE */
 	std::condition_variable status_cv;
-	/** Condition variable that is linked with the transmitting queue */
-	std::condition_variable tx_queue_cv;
 	/** Atomic boolean variable that controls the receiving looping thread */
 	std::atomic<bool> receiving;
 	/** Atomic boolean variable that controls the transmitting looping thread */
@@ -59,7 +59,8 @@ public:
 UwOFDMPhy::UwOFDMPhy()
 	: UnderwaterPhysical(), sentUpPkts(0), totTransTime(0), phySentPkt_(0), 
 	bufferSize_(50), buffered_pkt_num(0), current_rcvs(0), nodeNum_(-1), centerFreq_(0), 
-	subCarrier_(-1), nodeID_(-1), tx_busy_(0), powerScaling(1)
+	subCarrier_(-1), nodeID_(-1), tx_busy_(0), powerScaling(1),
+	busy_carriers_(0), carrier_users_(), occupancy_cache_()
 
 { // binding to TCL variables
 	bind("FRAME_BIT", &FRAME_BIT);
@@ -218,7 +219,7 @@ void UwOFDMPhy::init_ofdm_node(int nn, int cf, int scn, int ID)
 {
 	nodeNum_ = nn;
 	centerFreq_ = cf;
-	subCarrier_ = scn;
+	setSubCarNum(scn);
 	nodeID_ = ID;
 	msgDisp.initDisplayer(nodeID_, "UwOFDMPhy", debug_);
 	std::cout << NOW << " UwOFDMPhy(" << nodeID_ << ")::init_ofdm_node  Node created" << std::endl;
@@ -331,14 +332,8 @@ void UwOFDMPhy::recv(Packet *p)
 
 		if (powerScaling)
 		{
-			int usedCarriers = 0;
-			for (int i = 0; i < subCarrier_; i++)
-			{
-				if (ofdmph->carriers[i] == 1)
-					usedCarriers++;
-			}
 			// TxPower is scaled with used carriers
-			ph->Pt = getTxPower(p) * usedCarriers / subCarrier_;
+			ph->Pt = getTxPower(p) * ofdmph->usedCarriers() / subCarrier_;
 		}
 		else
 			ph->Pt = getTxPower(p);
@@ -384,10 +379,7 @@ void UwOFDMPhy::endTx(Packet *p)
 
 	if (powerScaling)
 	{
-		int bw = 0;
-		for (int i = 0; i < subCarrier_; i++)
-			if (ofdmph->carriers[i] == 1)
-				bw += 1;
+		int bw = ofdmph->usedCarriers();
 		Energy_Tx_ += consumedEnergyTx(ph->duration) * bw / subCarrier_;
 	}
 	else
@@ -409,11 +401,7 @@ void UwOFDMPhy::startRx(Packet *p)
 	std::ofstream myfile;
 	bool overlapping;
 
-	static int mac_addr = -1;
-
-	ClMsgPhy2MacAddr msg;
-	sendSyncClMsg(&msg);
-	mac_addr = msg.getAddr();
+	int mac_addr = getMacAddr();
 
 	msgDisp.printStatus("Reception starting, current_rcvs " + 
 						std::to_string(current_rcvs), "startRx", 
@@ -443,7 +431,7 @@ void UwOFDMPhy::startRx(Packet *p)
 							  << " seq_num " << ch->uid() << " isnative " << ofdmph->nativeOFDM 
 							  << " ph->Pr " << ph->Pn << " ph->Pn " << ph->Pn << std::endl;
 
-				pktqueue_.push_back(*p);
+				addToPktQueue(p);
 
 				if (debug_)
 					plotPktQueue();
@@ -530,11 +518,8 @@ void UwOFDMPhy::endRx(Packet *p)
 	hdr_OFDM *ofdmph = HDR_OFDM(p);
 
 	counter interferent_pkts;
-	static int mac_addr = -1;
-	ClMsgPhy2MacAddr msg;
-	sendSyncClMsg(&msg);
+	int mac_addr = getMacAddr();
 	total_delay_ = ph->duration;
-	mac_addr = msg.getAddr();
 
 	bool pktfound = false;
 
@@ -542,26 +527,14 @@ void UwOFDMPhy::endRx(Packet *p)
 							", current_rcvs " + itos(current_rcvs),
 						"EndRx()", Scheduler::instance().clock(), nodeID_);
 
-	for (auto x = pktqueue_.begin(); x != pktqueue_.end();)
+	if (removeFromPktQueue(p))
 	{
-		hdr_cmn *chx = HDR_CMN(&*x);
-		hdr_mac *machx = HDR_MAC(&*x);
+		if (debug_)
+			std::cout << NOW << " UwOFDMPhy(" << nodeID_ << ")::EndRx() Packet found in pktqueue_. current_p " 
+			<< current_p << " isNative " << ofdmph->nativeOFDM << " seq_num " << ch->uid() 
+			<< " dest " << mach->macDA() << std::endl;
 
-		if ((chx->uid() == ch->uid()) && (ch->ptype() == chx->ptype()) 
-		&& (mach->macDA() == machx->macDA()) && (mach->macSA() == machx->macSA()))
-		{
-			if (debug_)
-				std::cout << NOW << " UwOFDMPhy(" << nodeID_ << ")::EndRx() Packet found in pktqueue_. current_p " 
-				<< current_p << " isNative " << ofdmph->nativeOFDM << " seq_num " << ch->uid() 
-				<< " dest " << mach->macDA() << std::endl;
-
-			pktfound = true;
-			current_p = &*x;
-			x = pktqueue_.erase(x);
-			break;
-		} else {
-			++x;
-		}
+		pktfound = true;
 	}
 	if (debug_)
 		plotPktQueue();
@@ -771,12 +744,12 @@ void UwOFDMPhy::endRx(Packet *p)
 void UwOFDMPhy::interruptReceptions()
 {
 
-	for (auto x = pktqueue_.begin(); x != pktqueue_.end();)
-	{
-		dropPacket(&*x);
-		x = pktqueue_.erase(x);
-		buffered_pkt_num--;
-	}
+	// The packets are still scheduled on rxtimer: endRx() will not find
+	// them in the queue and will drop them
+	pktqueue_.clear();
+	busy_carriers_ = 0;
+	for (int i = 0; i < MAX_CARRIERS; i++)
+		carrier_users_[i] = 0;
 
 	current_rcvs = 0;
 	std::cerr << NOW << "  UwOFDMPhy(" << nodeID_
@@ -799,11 +772,11 @@ double UwOFDMPhy::getTxDuration(Packet *p)
 	double used_bw = 0;
 	for (int i = 0; i < ofdmph->carrierNum; i++)
 	{
-		if (ofdmph->carriers[i] == 1) {
-			if (ofdmph->carMod[i] == "BPSK")
+		if (ofdmph->isCarrierUsed(i)) {
+			if (ofdmph->getCarMod(i) == UW_MOD_BPSK)
 				used_bw += 1;
 
-			else if (ofdmph->carMod[i] == "QPSK")
+			else if (ofdmph->getCarMod(i) == UW_MOD_QPSK)
 				used_bw += 2;
 		}
 	}
@@ -850,49 +823,17 @@ UwOFDMPhy::getOFDMPER(double _snr, int _nbits, Packet *p)
 	assert(sm);
 
 	int ncarriers = sm->getBandwidth() / ofdmph->carrierSize;
-	double snr_with_penalty = _snr * pow(10, RxSnrPenalty_dB_ / 10.0);
+	double snr_with_penalty = _snr * getSnrPenalty();
 	double ber_ = 0;
 	int usedCarriers = 0;
-	double tber_ = 0;
 	int brokenProb = 10; // out of 100
 
 	for (int i = 0; i < ofdmph->carrierNum; i++)
 	{
-		// set the associated modulation with something like ph->modulationType = subCarMod
-
-		if (ofdmph->carMod[i] == "BPSK")
-		{
-			tber_ = 0.5 * erfc(sqrt(snr_with_penalty));
-		}
-		else if (ofdmph->carMod[i] == "QPSK")
-		{
-			tber_ = erfc(sqrt(snr_with_penalty));
-		}
-		else if (ofdmph->carMod[i] == "BFSK")
-		{
-			tber_ = 0.5 * exp(-snr_with_penalty / 2);
-		}
-		else if (ofdmph->carMod[i] == "8PSK")
-		{
-			double const M = 8;
-			tber_ = (1 / this->log2(M)) *
-					get_prob_error_symbol_mpsk(snr_with_penalty, M);
-		}
-		else if (ofdmph->carMod[i] == "16PSK")
-		{
-			double const M = 16;
-			tber_ = (1 / this->log2(M)) *
-					get_prob_error_symbol_mpsk(snr_with_penalty, M);
-		}
-		else if (ofdmph->carMod[i] == "32PSK")
-		{
-			double const M = 32;
-			tber_ = (1 / this->log2(M)) *
-					get_prob_error_symbol_mpsk(snr_with_penalty, M);
-		}
-
-		ber_ += tber_ * ofdmph->carriers[i];
-		usedCarriers += ofdmph->carriers[i];
+		if (!ofdmph->isCarrierUsed(i))
+			continue;
+		ber_ += uwber::getBer(ofdmph->getCarMod(i), snr_with_penalty);
+		usedCarriers++;
 	}
 	ber_ = ber_ / usedCarriers;
 	// WARNING: the BER calculated carrier by carrier makes sense if there are weird thinngs in the network,
@@ -918,10 +859,7 @@ double UwOFDMPhy::getOFDMNoisePower(Packet *p)
 	// std::cout << "NodeID " << nodeID_ << " subCarrier_ " << subCarrier_ << std::endl;
 	MSpectralMask *sm = getRxSpectralMask(p);
 	assert(sm);
-	for (int i = 0; i < ofdmph->carrierNum; i++)
-	{
-		actualBand += ofdmph->carrierSize * ofdmph->carriers[i];
-	}
+	actualBand = ofdmph->carrierSize * ofdmph->usedCarriers();
 
 	double noiseOFDM = getNoisePower(p) * actualBand / sm->getBandwidth();
 	if (debug_)
@@ -965,15 +903,10 @@ bool UwOFDMPhy::freqOverlap(Packet *p2, bool isOFDM)
 
 	if (debug_)
 		for (int i = 0; i < ofdmph2->carrierNum; i++)
-			std::cout << "carrier[" << i << "]=" << ofdmph2->carriers[i] << std::endl;
+			std::cout << "carrier[" << i << "]=" << ofdmph2->isCarrierUsed(i) << std::endl;
 
-	for (const auto &x : pktqueue_)
-	{
-		hdr_OFDM *ofdmph1 = HDR_OFDM(&x);
-		for (int i = 0; i < ofdmph1->carrierNum; i++)
-			if (ofdmph1->carriers[i] && ofdmph2->carriers[i])
-				return true;
-	}
+	if (busy_carriers_ & ofdmph2->carriers)
+		return true;
 
 	if (!isOFDM)
 	{
@@ -992,8 +925,24 @@ void UwOFDMPhy::createOFDMhdr(Packet *p)
 	hdr_OFDM *ofdmph = HDR_OFDM(p);
 	hdr_MPhy *ph = HDR_MPHY(p);
 
-	MSpectralMask *txsm = ph->srcSpectralMask;
-	MSpectralMask *rxsm = getRxSpectralMask(p);
+	ofdmph->carrierNum = subCarrier_;
+	ofdmph->carriers = getCarrierOccupancy(ph->srcSpectralMask, getRxSpectralMask(p));
+	for (int i = 0; i < subCarrier_; i++)
+		ofdmph->setCarMod(i, UW_MOD_UNKNOWN);
+
+	if (debug_)
+		std::cout << NOW << " End createOFDMhdr function" << std::endl;
+	return;
+}
+
+ofdm_carriers_t UwOFDMPhy::getCarrierOccupancy(MSpectralMask *txsm, MSpectralMask *rxsm)
+{
+	CarrierOccupancy &occ = occupancy_cache_[SpectralMaskPair(txsm, rxsm)];
+	if (occ.ncarriers == subCarrier_ && occ.tx_freq == txsm->getFreq() &&
+			occ.tx_bw == txsm->getBandwidth() && occ.rx_freq == rxsm->getFreq() &&
+			occ.rx_bw == rxsm->getBandwidth())
+		return occ.carriers;
+
 	double newPktStart = txsm->getFreq() - txsm->getBandwidth() / 2;
 	double newPktEnd = txsm->getFreq() + txsm->getBandwidth() / 2;
 	double nodeStart = rxsm->getFreq() - rxsm->getBandwidth() / 2;
@@ -1006,22 +955,54 @@ void UwOFDMPhy::createOFDMhdr(Packet *p)
 		std::cout << NOW << " node Start and End: " << nodeStart << " " << nodeEnd << std::endl;
 	}
 
-	ofdmph->carrierNum = subCarrier_;
+	ofdm_carriers_t carriers = 0;
 	int i = 0;
-	for (double s = nodeStart; s < nodeEnd; s = s + carsize)
+	for (double s = nodeStart; s < nodeEnd && i < subCarrier_; s = s + carsize, i++)
+	{
 		if ((newPktStart <= s + carsize) && (newPktEnd > s))
 		{
 			if (debug_)
 				std::cout << NOW << " 1 Added " << std::endl;
-			ofdmph->carriers[i] = 1;
+			carriers |= ((ofdm_carriers_t) 1 << i);
 		}
-		else
-			ofdmph->carriers[i] = 0;
-	i++;
+	}
 
-	if (debug_)
-		std::cout << NOW << " End createOFDMhdr function" << std::endl;
-	return;
+	occ.tx_freq = txsm->getFreq();
+	occ.tx_bw = txsm->getBandwidth();
+	occ.rx_freq = rxsm->getFreq();
+	occ.rx_bw = rxsm->getBandwidth();
+	occ.ncarriers = subCarrier_;
+	occ.carriers = carriers;
+	return carriers;
+}
+
+void UwOFDMPhy::addToPktQueue(Packet *p)
+{
+	hdr_OFDM *ofdmph = HDR_OFDM(p);
+
+	pktqueue_.insert(std::make_pair(HDR_CMN(p)->uid(), p));
+	busy_carriers_ |= ofdmph->carriers;
+	for (int i = 0; i < MAX_CARRIERS; i++)
+		if (ofdmph->isCarrierUsed(i))
+			carrier_users_[i]++;
+}
+
+bool UwOFDMPhy::removeFromPktQueue(Packet *p)
+{
+	auto range = pktqueue_.equal_range(HDR_CMN(p)->uid());
+	for (auto x = range.first; x != range.second; ++x)
+	{
+		if (x->second != p)
+			continue;
+
+		hdr_OFDM *ofdmph = HDR_OFDM(p);
+		for (int i = 0; i < MAX_CARRIERS; i++)
+			if (ofdmph->isCarrierUsed(i) && --carrier_users_[i] == 0)
+				busy_carriers_ &= ~((ofdm_carriers_t) 1 << i);
+		pktqueue_.erase(x);
+		return true;
+	}
+	return false;
 }
 
 // Returns total number of packets lost for low SNR
@@ -1127,6 +1108,12 @@ void UwOFDMPhy::setNodeID(int n)
 // set number of nodes in the simulation
 void UwOFDMPhy::setSubCarNum(int n)
 {
+	occupancy_cache_.clear();
+	if (n > MAX_CARRIERS) {
+		std::cerr << "UwOFDMPhy ERROR: " << n << " subcarriers, at most "
+				  << MAX_CARRIERS << " are supported" << std::endl;
+		exit(1);
+	}
 	subCarrier_ = n;
 	return;
 }
@@ -1173,6 +1160,12 @@ int UwOFDMPhy::recvSyncClMsg(ClMessage *m)
 		}
 		return 0;
 	}
+	if (m->type() == CLMSG_UWPHY_MAC_ADDR)
+	{
+		mac_addr_ = ((ClMsgUwPhyMacAddr *) m)->getAddr();
+		mac_addr_valid_ = (mac_addr_ >= 0);
+		return 0;
+	}
 	return UnderwaterMPhyBpsk::recvSyncClMsg(m);
 }
 void UwOFDMPhy::plotPktQueue()
@@ -1180,11 +1173,11 @@ void UwOFDMPhy::plotPktQueue()
 	std::cout << NOW << " UwOFDMPhy(" << nodeID_ << ")::plotPktQueue()" << std::endl;
 	for (auto x = pktqueue_.begin(); x != pktqueue_.end();)
 	{
-		hdr_cmn *ch = HDR_CMN(&*x);
-		hdr_MPhy *ph = HDR_MPHY(&*x);
-		hdr_OFDM *ofdmph = HDR_OFDM(&*x);
-		hdr_mac *mach = HDR_MAC(&*x);
-		std::cout << "Packet " << &*x << " seq_num " << ch->uid() 
+		hdr_cmn *ch = HDR_CMN(x->second);
+		hdr_MPhy *ph = HDR_MPHY(x->second);
+		hdr_OFDM *ofdmph = HDR_OFDM(x->second);
+		hdr_mac *mach = HDR_MAC(x->second);
+		std::cout << "Packet " << x->second << " seq_num " << ch->uid() 
 					<< " native " << ofdmph->nativeOFDM << " ph->Pr " << ph->Pn
 					<< " ph->Pn " << ph->Pn << " MACDE " << mach->macDA() 
 					<< " MACSRC " << mach->macSA() << std::endl;
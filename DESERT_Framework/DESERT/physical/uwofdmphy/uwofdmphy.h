@@ -47,6 +47,7 @@
 #include <math.h>
 #include <iostream>
 #include <map>
+#include <unordered_map>
 #include <ctime>
 #include <phymac-clmsg.h>
 
@@ -255,6 +256,33 @@ protected:
 	 */
 	void plotPktQueue();
 
+	/**
+	 * Adds a packet to the queue of ongoing receptions and marks its
+	 * carriers as busy
+	 *
+	 * @param Packet* p Pointer to the packet being received
+	 */
+	void addToPktQueue(Packet *p);
+
+	/**
+	 * Removes a packet from the queue of ongoing receptions and releases
+	 * the carriers no other reception is using
+	 *
+	 * @param Packet* p Pointer to the packet whose reception ended
+	 * @return true if the packet was in the queue, false otherwise
+	 */
+	bool removeFromPktQueue(Packet *p);
+
+	/**
+	 * Returns the carriers of this node covered by the band of a
+	 * transmitter. The result is cached for each pair of spectral masks.
+	 *
+	 * @param txsm Spectral mask of the transmitter
+	 * @param rxsm Spectral mask of this node
+	 * @return Bitmask of the covered carriers
+	 */
+	ofdm_carriers_t getCarrierOccupancy(MSpectralMask *txsm, MSpectralMask *rxsm);
+
 
 private:
 	/**
@@ -316,7 +344,24 @@ private:
 
 	int bufferSize_; 		//default
 
-	std::vector<Packet> pktqueue_;
+	/**
+	 * Carriers covered by a transmitter band, with the band edges they
+	 * were computed from
+	 */
+	struct CarrierOccupancy {
+		double tx_freq;
+		double tx_bw;
+		double rx_freq;
+		double rx_bw;
+		int ncarriers;
+		ofdm_carriers_t carriers;
+	};
+	typedef std::pair<MSpectralMask *, MSpectralMask *> SpectralMaskPair;
+
+	std::unordered_multimap<int, Packet *> pktqueue_; // packets being received, indexed by uid
+	ofdm_carriers_t busy_carriers_; // carriers used by the packets in pktqueue_
+	int carrier_users_[MAX_CARRIERS]; // number of packets in pktqueue_ on each carrier
+	std::map<SpectralMaskPair, CarrierOccupancy> occupancy_cache_; // carriers for each pair of masks
 	std::vector<Packet *> txqueue_;
 	std::vector<double> timesqueue_;
 	std::vector<double> brokenCarriers_; // Keeps top and bottom index of broken carriers 
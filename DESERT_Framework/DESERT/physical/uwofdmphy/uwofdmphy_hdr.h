@@ -43,24 +43,31 @@
 #include <mmac.h>
 #include <module.h>
 #include <packet.h>
+#include <stdint.h>
 #include <string>
+#include "uwphysical-ber.h"
 
 #define HDR_OFDM(p) \
 	(hdr_OFDM::access(p)) /**< alias defined to access the PROBE HEADER */
 
-#define MAX_CARRIERS 16 	//This can be changed to do simulations with more carriers 
+#define MAX_CARRIERS 16 	//This can be changed (up to 64) to do simulations with more carriers 
 extern packet_t PT_OFDM;
 
+typedef uint64_t ofdm_carriers_t; /**< Bitmask of carriers: bit i set if carrier i is used. */
+
+static_assert(MAX_CARRIERS <= 64, "MAX_CARRIERS must fit in ofdm_carriers_t");
+
 /**
- * Header of the OFDM message with fields to implement a multi carrier system
+ * Header of the OFDM message with fields to implement a multi carrier system.
+ * It only holds plain data, since ns-2 copies packet headers with memcpy.
  */
 typedef struct hdr_OFDM {
 
 	static int offset_; 			/**< Required by the PacketHeaderManager. */
-	int carriers [MAX_CARRIERS]; 	// Carriers vector: 1 if used 0 otherwise 
+	ofdm_carriers_t carriers; 		// Carriers bitmask: bit i set if carrier i is used 
 	double carrierSize;    			// Carrier size
   	int carrierNum;     			// NUmber of subcarriers 
-	string carMod [MAX_CARRIERS];	// Carriers Modulation vector
+	uint8_t carMod [MAX_CARRIERS];	// Carriers Modulation vector (UwModulation)
 	bool nativeOFDM = false;		// If a packet was created by an OFDM node
 	int srcID;						// ID of the node creating the packet 
 
@@ -78,6 +85,63 @@ typedef struct hdr_OFDM {
 	{
 		return (struct hdr_OFDM *) p->access(hdr_OFDM::offset_);
 	}
+
+	/**
+	 * Returns true if carrier i is used by the packet.
+	 */
+	inline bool
+	isCarrierUsed(int i) const
+	{
+		return (carriers >> i) & 1;
+	}
+
+	/**
+	 * Marks carrier i as used or unused.
+	 */
+	inline void
+	setCarrier(int i, bool used)
+	{
+		if (used)
+			carriers |= ((ofdm_carriers_t) 1 << i);
+		else
+			carriers &= ~((ofdm_carriers_t) 1 << i);
+	}
+
+	/**
+	 * Returns the number of carriers used by the packet.
+	 */
+	inline int
+	usedCarriers() const
+	{
+		return __builtin_popcountll(carriers);
+	}
+
+	/**
+	 * Returns true if the two packets share at least one carrier.
+	 */
+	inline bool
+	carriersOverlap(const struct hdr_OFDM *other) const
+	{
+		return (carriers & other->carriers) != 0;
+	}
+
+	/**
+	 * Returns the modulation of carrier i.
+	 */
+	inline UwModulation
+	getCarMod(int i) const
+	{
+		return (UwModulation) carMod[i];
+	}
+
+	/**
+	 * Sets the modulation of carrier i.
+	 */
+	inline void
+	setCarMod(int i, UwModulation mod)
+	{
+		carMod[i] = (uint8_t) mod;
+	}
 } hdr_OFDM;
 
 
@@ -45,6 +45,9 @@ ClMessage_t CLMSG_S2C_TX_MODE;
 ClMessage_t CLMSG_S2C_POWER_LEVEL;
 ClMessage_t CLMSG_S2C_RX_FAILED;
 ClMessage_t CLMSG_UWPHY_TX_BUSY;
+// Sent also by modules that only link the library (see UwMMac): until the
+// library is loaded from Tcl, this type is not registered
+ClMessage_t CLMSG_UWPHY_MAC_ADDR = CLMSG_UWPHY_TYPE_NOT_VALID;
 
 extern EmbeddedTcl UwPhyClMsgsInitTclCode;
 
@@ -54,6 +57,7 @@ extern "C" int Uwphy_clmsgs_Init() {
 	CLMSG_UWPHY_THRESH = ClMessage::addClMessage();
 	CLMSG_UWPHY_TX_BUSY = ClMessage::addClMessage();
 	CLMSG_UWPHY_LOSTPKT = ClMessage::addClMessage();
+	CLMSG_UWPHY_MAC_ADDR = ClMessage::addClMessage();
 	CLMSG_S2C_TX_MODE = ClMessage::addClMessage();
 	CLMSG_S2C_POWER_LEVEL = ClMessage::addClMessage();
 	CLMSG_S2C_RX_FAILED = ClMessage::addClMessage();
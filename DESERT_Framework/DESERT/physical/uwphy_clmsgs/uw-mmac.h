@@ -0,0 +1,61 @@
+//
+// Copyright (c) 2018 Regents of the SIGNET lab, University of Padova.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. Neither the name of the University of Padova (SIGNET lab) nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file   uw-mmac.h
+ * @version 1.0.0
+ *
+ * \brief Definition of UwMMac class.
+ *
+ */
+
+#ifndef UW_MMAC_H
+#define UW_MMAC_H
+
+#include <mmac.h>
+
+/**
+ * MMac whose address can be changed with setMacAddr. The new address is
+ * notified to the phy layers of the node with a ClMsgUwPhyMacAddr, so that
+ * they can refresh the address they cached.
+ */
+class UwMMac : public MMac
+{
+protected:
+	/**
+	 * Sets the MAC address and, if the MAC has already been added to a
+	 * node (getLayer() > 0), broadcasts it with a ClMsgUwPhyMacAddr: before
+	 * that no phy can have cached an address. Nothing is sent if
+	 * libuwphy_clmsgs has not been loaded from Tcl, as then no phy handles
+	 * the message.
+	 * @param mac_addr new MAC address of the node
+	 */
+	void setMacAddr(int mac_addr);
+};
+
+#endif /* UW_MMAC_H */
@@ -257,3 +257,42 @@ void ClMsgUwPhyGetLostPkts::setLostPkts(uint lost_pkt)
 {
   lost_packets = lost_pkt;
 }
+
+ClMsgUwPhyMacAddr::ClMsgUwPhyMacAddr(int addr)
+: ClMsgUwPhy(CLMSG_UWPHY_MAC_ADDR),
+  mac_addr(addr)
+{
+  req_type = SET_REQ;
+}
+
+ClMsgUwPhyMacAddr::ClMsgUwPhyMacAddr(int sid, int dest_module_id, int addr)
+: ClMsgUwPhy(sid, dest_module_id, CLMSG_UWPHY_MAC_ADDR),
+  mac_addr(addr)
+{
+  req_type = SET_REQ;
+}
+
+ClMsgUwPhyMacAddr::ClMsgUwPhyMacAddr(const ClMsgUwPhyMacAddr& msg)
+: ClMsgUwPhy(msg),
+  mac_addr(msg.mac_addr)
+{
+}
+
+ClMsgUwPhyMacAddr::~ClMsgUwPhyMacAddr()
+{
+}
+
+ClMsgUwPhyMacAddr* ClMsgUwPhyMacAddr::copy()
+{
+  return new ClMsgUwPhyMacAddr(*this);
+}
+
+int ClMsgUwPhyMacAddr::getAddr()
+{
+  return mac_addr;
+}
+
+void ClMsgUwPhyMacAddr::setAddr(int addr)
+{
+  mac_addr = addr;
+}
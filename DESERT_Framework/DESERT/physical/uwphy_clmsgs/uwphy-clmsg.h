@@ -49,11 +49,15 @@
 
 #define CLMSG_UWPHY_STACK_ID_NOT_VALID (-1)
 
+/** Type of the messages not registered yet, see Uwphy_clmsgs_Init */
+#define CLMSG_UWPHY_TYPE_NOT_VALID ((ClMessage_t) -1)
+
 extern ClMessage_t CLMSG_UWPHY_TX_POWER;
 extern ClMessage_t CLMSG_UWPHY_B_RATE;
 extern ClMessage_t CLMSG_UWPHY_THRESH;
 extern ClMessage_t CLMSG_UWPHY_LOSTPKT;
 extern ClMessage_t CLMSG_UWPHY_TX_BUSY;
+extern ClMessage_t CLMSG_UWPHY_MAC_ADDR;
 
 /**
 * ClMsgUwPhy should be extended and used to ask to set or get a parameter of a specific phy.
@@ -409,4 +413,66 @@ int getop; // To signal if mac just wants to read the value
     
 };
 
+/**
+* ClMsgUwPhyMacAddr is broadcast by a layer that changes the MAC address of
+* a node (SET_REQ), so that the phy layers can refresh the address they
+* cached instead of asking it to the MAC for every received packet.
+* The MACs send it with UwMMac::setMacAddr, once they have been added
+* to a node (getLayer() > 0): before that no phy can have cached an address.
+**/
+class ClMsgUwPhyMacAddr : public ClMsgUwPhy
+{
+public:
+
+  /**
+  * Broadcast constructor of the ClMsgUwPhyMacAddr class
+  * @param addr: new MAC address of the node
+  **/
+  ClMsgUwPhyMacAddr(int addr = CLMSG_UWPHY_NOT_VALID);
+
+  /**
+  * Unicast constructor of the ClMsgUwPhyMacAddr class
+  * @param int stack_id: id of the stack
+  * @param dest_mod_id: id of the destination module
+  * @param addr: new MAC address of the node
+  **/
+  ClMsgUwPhyMacAddr(int stack_id, int dest_module_id,
+      int addr = CLMSG_UWPHY_NOT_VALID);
+
+  /**
+  * Copy constructor
+  * @param const ClMsgUwPhyMacAddr& msg: ClMsgUwPhyMacAddr that has to be copied
+  */
+  ClMsgUwPhyMacAddr(const ClMsgUwPhyMacAddr& msg);
+
+  /**
+    * Destructor of the ClMsgUwPhyMacAddr class
+  **/
+  virtual ~ClMsgUwPhyMacAddr();
+
+  /**
+    * Copy method of the ClMsgUwPhyMacAddr class
+    *
+    * @return pointer to a copy of the current ClMsgUwPhyMacAddr object
+  **/
+  virtual ClMsgUwPhyMacAddr* copy();
+
+  /**
+  * method to return the MAC address
+  * @return mac_addr
+  */
+  int getAddr();
+
+  /**
+  * method to set the MAC address
+  * @param int addr: MAC address to set
+  */
+  void setAddr(int addr);
+
+private:
+
+  int mac_addr; /* < MAC address of the node, CLMSG_UWPHY_NOT_VALID if unknown.*/
+
+};
+
 #endif /* UWPHY_CLMSG_H  */
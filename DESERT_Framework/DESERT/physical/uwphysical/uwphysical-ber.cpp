@@ -0,0 +1,125 @@
+//
+// Copyright (c) 2017 Regents of the SIGNET lab, University of Padova.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. Neither the name of the University of Padova (SIGNET lab) nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file   uwphysical-ber.cpp
+ * @author Giovanni Toso and Federico Favaro
+ * @version 1.0.0
+ *
+ * \brief Implementation of the BER models and of UwBerTable class.
+ *
+ */
+
+#include "uwphysical-ber.h"
+
+namespace
+{
+/**
+ * Probability of error of a bit of a M-PSK symbol, for log2(M) = k.
+ */
+inline double
+berMpsk(double snr, double k, double sin_pi_m)
+{
+	return (1 / k) * erfc(sqrt(snr * k) * sin_pi_m);
+}
+}
+
+UwModulation
+uwber::getModulation(const std::string &name)
+{
+	if (name == "BPSK")
+		return UW_MOD_BPSK;
+	if (name == "BFSK")
+		return UW_MOD_BFSK;
+	if (name == "QPSK")
+		return UW_MOD_QPSK;
+	if (name == "8PSK")
+		return UW_MOD_8PSK;
+	if (name == "16PSK")
+		return UW_MOD_16PSK;
+	if (name == "32PSK")
+		return UW_MOD_32PSK;
+	return UW_MOD_UNKNOWN;
+}
+
+double
+uwber::getBer(UwModulation mod, double snr)
+{
+	static const double SIN_PI_8 = sin(M_PI / 8);
+	static const double SIN_PI_16 = sin(M_PI / 16);
+	static const double SIN_PI_32 = sin(M_PI / 32);
+
+	switch (mod) {
+		case UW_MOD_BPSK:
+			return 0.5 * erfc(sqrt(snr));
+		case UW_MOD_BFSK:
+			return 0.5 * exp(-snr / 2);
+		case UW_MOD_QPSK:
+			return erfc(sqrt(snr));
+		case UW_MOD_8PSK:
+			return berMpsk(snr, 3, SIN_PI_8);
+		case UW_MOD_16PSK:
+			return berMpsk(snr, 4, SIN_PI_16);
+		case UW_MOD_32PSK:
+			return berMpsk(snr, 5, SIN_PI_32);
+		default:
+			return 0;
+	}
+}
+
+UwBerTable::UwBerTable()
+	: mod_(UW_MOD_UNKNOWN)
+	, min_snr_db_(0)
+	, max_snr_db_(0)
+	, resolution_db_(0)
+	, inv_resolution_(0)
+	, last_index_(0)
+	, ber_()
+{
+}
+
+void
+UwBerTable::build(UwModulation mod, double min_snr_db, double max_snr_db,
+		double resolution_db)
+{
+	mod_ = mod;
+	min_snr_db_ = min_snr_db;
+	max_snr_db_ = max_snr_db;
+	resolution_db_ = resolution_db;
+	ber_.clear();
+	if (resolution_db <= 0 || max_snr_db <= min_snr_db)
+		return;
+
+	size_t n = (size_t) ceil((max_snr_db - min_snr_db) / resolution_db) + 1;
+	inv_resolution_ = 1 / resolution_db;
+	last_index_ = n - 1;
+	ber_.resize(n);
+	for (size_t i = 0; i < n; i++)
+		ber_[i] = uwber::getBer(
+				mod, pow(10, (min_snr_db + i * resolution_db) / 10.0));
+}
@@ -0,0 +1,176 @@
+//
+// Copyright (c) 2017 Regents of the SIGNET lab, University of Padova.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. Neither the name of the University of Padova (SIGNET lab) nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file   uwphysical-ber.h
+ * @author Giovanni Toso and Federico Favaro
+ * @version 1.0.0
+ *
+ * \brief Definition of the BER models and of UwBerTable class.
+ *
+ */
+
+#ifndef UWPHYSICAL_BER_H
+#define UWPHYSICAL_BER_H
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+/**
+ * Modulation schemes supported by the BER models.
+ */
+enum UwModulation {
+	UW_MOD_BPSK = 0,
+	UW_MOD_BFSK,
+	UW_MOD_QPSK,
+	UW_MOD_8PSK,
+	UW_MOD_16PSK,
+	UW_MOD_32PSK,
+	UW_MOD_UNKNOWN
+};
+
+namespace uwber
+{
+/**
+ * Converts the name of a modulation scheme into its identifier.
+ *
+ * @param name Name of the modulation, e.g. "BPSK".
+ * @return Identifier of the modulation, UW_MOD_UNKNOWN if not supported.
+ */
+UwModulation getModulation(const std::string &name);
+
+/**
+ * Returns the name of a modulation scheme.
+ *
+ * @param mod Identifier of the modulation.
+ * @return Name of the modulation, "UNKNOWN" if not supported.
+ */
+inline const char *
+getModulationName(UwModulation mod)
+{
+	switch (mod) {
+		case UW_MOD_BPSK:
+			return "BPSK";
+		case UW_MOD_BFSK:
+			return "BFSK";
+		case UW_MOD_QPSK:
+			return "QPSK";
+		case UW_MOD_8PSK:
+			return "8PSK";
+		case UW_MOD_16PSK:
+			return "16PSK";
+		case UW_MOD_32PSK:
+			return "32PSK";
+		default:
+			return "UNKNOWN";
+	}
+}
+
+/**
+ * Closed form bit error rate of a modulation scheme.
+ *
+ * @param mod Identifier of the modulation.
+ * @param snr Signal to noise ratio (linear).
+ * @return Bit error rate, 0 for an unknown modulation.
+ */
+double getBer(UwModulation mod, double snr);
+}
+
+/**
+ * Bit error rate of a modulation sampled on a uniform grid of SNR values
+ * in dB. Values between two samples are linearly interpolated, values
+ * outside the grid are computed with the closed form.
+ */
+class UwBerTable
+{
+public:
+	/**
+	 * Constructor of UwBerTable class.
+	 */
+	UwBerTable();
+
+	/**
+	 * Samples the BER of a modulation.
+	 *
+	 * @param mod Identifier of the modulation.
+	 * @param min_snr_db Smallest SNR of the grid, in dB.
+	 * @param max_snr_db Largest SNR of the grid, in dB.
+	 * @param resolution_db Step of the grid, in dB.
+	 */
+	void build(UwModulation mod, double min_snr_db, double max_snr_db,
+			double resolution_db);
+
+	/**
+	 * Checks if the table has been built with the given parameters.
+	 *
+	 * @param mod Identifier of the modulation.
+	 * @param min_snr_db Smallest SNR of the grid, in dB.
+	 * @param max_snr_db Largest SNR of the grid, in dB.
+	 * @param resolution_db Step of the grid, in dB.
+	 * @return <i>true</i> if the table matches the parameters.
+	 */
+	inline bool
+	isBuilt(UwModulation mod, double min_snr_db, double max_snr_db,
+			double resolution_db) const
+	{
+		return !ber_.empty() && mod == mod_ && min_snr_db == min_snr_db_ &&
+				max_snr_db == max_snr_db_ && resolution_db == resolution_db_;
+	}
+
+	/**
+	 * Returns the bit error rate for the given SNR.
+	 *
+	 * @param snr Signal to noise ratio (linear).
+	 * @return Bit error rate.
+	 */
+	inline double
+	getBer(double snr) const
+	{
+		if (snr > 0) {
+			double pos = (10 * log10(snr) - min_snr_db_) * inv_resolution_;
+			if (pos >= 0 && pos < last_index_) {
+				size_t i = (size_t) pos;
+				double frac = pos - i;
+				return ber_[i] + frac * (ber_[i + 1] - ber_[i]);
+			}
+		}
+		return uwber::getBer(mod_, snr);
+	}
+
+private:
+	UwModulation mod_; /**< Modulation of the table. */
+	double min_snr_db_; /**< Smallest SNR of the grid, in dB. */
+	double max_snr_db_; /**< Largest SNR of the grid, in dB. */
+	double resolution_db_; /**< Step of the grid, in dB. */
+	double inv_resolution_; /**< Inverse of the step of the grid. */
+	double last_index_; /**< Index of the last sample of the grid. */
+	std::vector<double> ber_; /**< BER for each SNR of the grid. */
+};
+
+#endif /* UWPHYSICAL_BER_H */
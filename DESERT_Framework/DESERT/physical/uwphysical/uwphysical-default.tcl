@@ -32,3 +32,7 @@
 
 Module/UW/PHYSICAL set tx_power_consumption_ 3.3
 Module/UW/PHYSICAL set rx_power_consumption_ 0.620
+Module/UW/PHYSICAL set use_ber_table_ 0
+Module/UW/PHYSICAL set ber_table_resolution_ 0.01
+Module/UW/PHYSICAL set ber_table_min_snr_ -20
+Module/UW/PHYSICAL set ber_table_max_snr_ 40
@@ -100,6 +100,16 @@ public:
 
 UnderwaterPhysical::UnderwaterPhysical()
 	: modulation_name_("BPSK")
+	, modulation_(UW_MOD_BPSK)
+	, use_ber_table_(0)
+	, ber_table_resolution_(0.01)
+	, ber_table_min_snr_(-20)
+	, ber_table_max_snr_(40)
+	, ber_table_()
+	, snr_penalty_db_(0)
+	, snr_penalty_(1)
+	, mac_addr_(-1)
+	, mac_addr_valid_(false)
 	, time_ready_to_end_rx_(0)
 	, Tx_Time_(0)
 	, Rx_Time_(0)
@@ -120,6 +130,10 @@ UnderwaterPhysical::UnderwaterPhysical()
 {
 	bind("rx_power_consumption_", &rx_power_);
 	bind("tx_power_consumption_", &tx_power_);
+	bind("use_ber_table_", &use_ber_table_);
+	bind("ber_table_resolution_", &ber_table_resolution_);
+	bind("ber_table_min_snr_", &ber_table_min_snr_);
+	bind("ber_table_max_snr_", &ber_table_max_snr_);
 	stats_ptr = new UwPhysicalStats();
 }
 
@@ -168,15 +182,15 @@ UnderwaterPhysical::command(int argc, const char *const *argv)
 		} else if (strcasecmp(argv[1], "getErrorCtrlPktsInterf") == 0) {
 			tcl.resultf("%d", getError_CtrlPktsInterf());
 			return TCL_OK;
+		} else if (strcasecmp(argv[1], "refreshMacAddr") == 0) {
+			mac_addr_valid_ = false;
+			return TCL_OK;
 		}
 	} else if (argc == 3) {
 		if (strcasecmp(argv[1], "modulation") == 0) {
 			modulation_name_ = ((char *) argv[2]);
-			if (modulation_name_ == "" ||
-					(modulation_name_ != "BPSK" && modulation_name_ != "BFSK" &&
-							modulation_name_ != "8PSK" &&
-							modulation_name_ != "16PSK" &&
-							modulation_name_ != "32PSK")) {
+			modulation_ = uwber::getModulation(modulation_name_);
+			if (modulation_ == UW_MOD_UNKNOWN) {
 				std::cerr << "Empty or wrong name for the modulation scheme"
 						  << std::endl;
 				return TCL_ERROR;
@@ -298,11 +312,7 @@ UnderwaterPhysical::startRx(Packet *p)
 	hdr_mac *mach = HDR_MAC(p);
 	hdr_MPhy *ph = HDR_MPHY(p);
 
-	static int mac_addr = -1;
-
-	ClMsgPhy2MacAddr msg;
-	sendSyncClMsg(&msg);
-	mac_addr = msg.getAddr();
+	int mac_addr = getMacAddr();
 
 	if ((PktRx == 0) && (txPending == false)) {
 		// The receiver is is not synchronized on any transmission
@@ -385,11 +395,7 @@ UnderwaterPhysical::endRx(Packet *p){
 	hdr_mac *mach = HDR_MAC(p);
 	counter interferent_pkts;
 
-	static int mac_addr = -1;
-
-	ClMsgPhy2MacAddr msg;
-	sendSyncClMsg(&msg);
-	mac_addr = msg.getAddr();
+	int mac_addr = getMacAddr();
 
 	if (PktRx != 0) {
 		if (PktRx == p) {
@@ -423,8 +429,12 @@ UnderwaterPhysical::endRx(Packet *p){
 							}
 						}
 					}
+					interferent_pkts = interference_->getCounters(p);
 				} else if (Interference_Model == "MEANPOWER") {
-					interference_power = interference_->getInterferencePower(p);
+					InterferenceSummary interf_summary =
+							interference_->getInterferenceSummary(p);
+					interference_power = interf_summary.power;
+					interferent_pkts = interf_summary.counters;
 					per_ni = getPER(
 							ph->Pr / (ph->Pn + interference_power), nbits, p);
 					error_ni = x <= per_ni;
@@ -434,7 +444,6 @@ UnderwaterPhysical::endRx(Packet *p){
 							  << std::endl;
 					exit(1);
 				}
-				interferent_pkts = interference_->getCounters(p);
 
 			} else {
 				interference_power = ph->Pi;
@@ -515,31 +524,32 @@ UnderwaterPhysical::endRx(Packet *p){
 double
 UnderwaterPhysical::getPER(double _snr, int _nbits, Packet *_p)
 {
-	double snr_with_penalty = _snr * pow(10, RxSnrPenalty_dB_ / 10.0);
-
-	double ber_ = 0;
-	if (modulation_name_ == "BPSK") {
-		ber_ = 0.5 * erfc(sqrt(snr_with_penalty));
-	} else if (modulation_name_ == "BFSK") {
-		ber_ = 0.5 * exp(-snr_with_penalty / 2);
-	} else if (modulation_name_ == "8PSK") {
-		double const M = 8;
-		ber_ = (1 / this->log2(M)) *
-				get_prob_error_symbol_mpsk(snr_with_penalty, M);
-	} else if (modulation_name_ == "16PSK") {
-		double const M = 16;
-		ber_ = (1 / this->log2(M)) *
-				get_prob_error_symbol_mpsk(snr_with_penalty, M);
-	} else if (modulation_name_ == "32PSK") {
-		double const M = 32;
-		ber_ = (1 / this->log2(M)) *
-				get_prob_error_symbol_mpsk(snr_with_penalty, M);
-	}
+	double snr_with_penalty = _snr * getSnrPenalty();
+
+	double ber_ = getBER(snr_with_penalty);
 
 	// PER calculation
 	return 1 - pow(1 - ber_, _nbits);
 } /* UnderwaterPhysical::getPER */
 
+double
+UnderwaterPhysical::getBER(double _snr)
+{
+	if (use_ber_table_) {
+		if (!ber_table_.isBuilt(modulation_,
+					ber_table_min_snr_,
+					ber_table_max_snr_,
+					ber_table_resolution_)) {
+			ber_table_.build(modulation_,
+					ber_table_min_snr_,
+					ber_table_max_snr_,
+					ber_table_resolution_);
+		}
+		return ber_table_.getBer(_snr);
+	}
+	return uwber::getBer(modulation_, _snr);
+} /* UnderwaterPhysical::getBER */
+
 
 int UnderwaterPhysical::recvSyncClMsg(ClMessage* m)
 {
@@ -550,6 +560,12 @@ int UnderwaterPhysical::recvSyncClMsg(ClMessage* m)
 		((ClMsgUwPhyGetLostPkts*)m)->setLostPkts(lost_packet);
 		return 0;
 	}
+	if (m->type() == CLMSG_UWPHY_MAC_ADDR)
+	{
+		mac_addr_ = ((ClMsgUwPhyMacAddr *) m)->getAddr();
+		mac_addr_valid_ = (mac_addr_ >= 0);
+		return 0;
+	}
 	if (m->type() == CLMSG_STATS)
 	{
 		updateInstantaneousStats();
@@ -41,6 +41,7 @@
 
 #include "underwater-bpsk.h"
 #include "uwinterference.h"
+#include "uwphysical-ber.h"
 #include "mac.h"
 
 #include "clmsg-stats.h"
@@ -214,6 +215,52 @@ protected:
 	 */
 	virtual double getPER(double snr, int nbits, Packet *);
 
+	/**
+	 * Returns the bit error rate of the modulation set with the
+	 * <i>modulation</i> command. If use_ber_table_ is set the value is read
+	 * from a precomputed table, otherwise it is computed in closed form.
+	 *
+	 * @param snr Signal to noise ratio (linear), penalty included.
+	 * @return Bit error rate.
+	 */
+	double getBER(double snr);
+
+	/**
+	 * Returns the linear factor corresponding to RxSnrPenalty_dB_.
+	 *
+	 * @return 10^(RxSnrPenalty_dB_ / 10)
+	 */
+	inline double
+	getSnrPenalty()
+	{
+		if (RxSnrPenalty_dB_ != snr_penalty_db_) {
+			snr_penalty_db_ = RxSnrPenalty_dB_;
+			snr_penalty_ = pow(10, snr_penalty_db_ / 10.0);
+		}
+		return snr_penalty_;
+	}
+
+	/**
+	 * Returns the MAC address of the node. The address is asked to the MAC
+	 * layer with a ClMsgPhy2MacAddr until a valid one is returned,
+	 * afterwards it is served from mac_addr_ until a ClMsgUwPhyMacAddr
+	 * notifies a new address or the <i>refreshMacAddr</i> command
+	 * invalidates it.
+	 *
+	 * @return MAC address of the node.
+	 */
+	inline int
+	getMacAddr()
+	{
+		if (!mac_addr_valid_) {
+			ClMsgPhy2MacAddr msg;
+			sendSyncClMsg(&msg);
+			mac_addr_ = msg.getAddr();
+			mac_addr_valid_ = (mac_addr_ >= 0);
+		}
+		return mac_addr_;
+	}
+
 	/**
 	 * Evaluates is the number passed as input is equal to zero. When C++ works
 	 * with
@@ -426,6 +473,16 @@ protected:
 
 	// Variables
 	std::string modulation_name_; /**< Modulation scheme name. */
+	UwModulation modulation_; /**< Modulation scheme identifier. */
+	int use_ber_table_; /**< If set to 1 the BER is read from ber_table_. */
+	double ber_table_resolution_; /**< Step of the BER table, in dB. */
+	double ber_table_min_snr_; /**< Smallest SNR of the BER table, in dB. */
+	double ber_table_max_snr_; /**< Largest SNR of the BER table, in dB. */
+	UwBerTable ber_table_; /**< Precomputed BER of modulation_. */
+	double snr_penalty_db_; /**< Value of RxSnrPenalty_dB_ for snr_penalty_. */
+	double snr_penalty_; /**< Linear value of snr_penalty_db_. */
+	int mac_addr_; /**< Cached MAC address of the node. */
+	bool mac_addr_valid_; /**< True if mac_addr_ holds the MAC address. */
 	double time_ready_to_end_rx_; /**< Used to keep track of the arrival time.
 									 */
 
@@ -38,6 +38,8 @@
 
 #include "uwphysicaldb.h"
 
+#include <algorithm>
+
 static class UnderwaterPhysicaldbClass : public TclClass
 {
 public:
@@ -65,6 +67,12 @@ UnderwaterPhysicaldb::UnderwaterPhysicaldb()
 	modulation(nullptr),
 	interf_val({0.0,0.0}),
 	token_separator(0),
+	per_tables_loaded_(false),
+	snr_axis_(),
+	sir_axis_(),
+	overlap_axis_(),
+	snr_tables_(),
+	sir_tables_(),
 	osstream(0)
 
 {
@@ -76,7 +84,13 @@ UnderwaterPhysicaldb::UnderwaterPhysicaldb()
 int
 UnderwaterPhysicaldb::command(int argc, const char *const *argv)
 {
-	if (argc == 3) {
+	if (argc == 2) {
+		if (strcasecmp(argv[1], "loadPerTables") == 0) {
+			loadPerTables();
+			return TCL_OK;
+		}
+	} else if (argc == 3) {
+		per_tables_loaded_ = false;
 		if (strcasecmp(argv[1], "addr") == 0) {
 			ipAddr_ = static_cast<uint8_t>(atoi(argv[2]));
 			if (ipAddr_ == 0) {
@@ -110,6 +124,7 @@ UnderwaterPhysicaldb::command(int argc, const char *const *argv)
 			return TCL_OK;
 		}
 	} else if (argc == 4) {
+		per_tables_loaded_ = false;
 		if (strcasecmp(argv[1], "addRange") == 0) {
 			uint8_t node_id_ = atoi(argv[2]);
 			double range_ = atof(argv[3]);
@@ -314,17 +329,12 @@ UnderwaterPhysicaldb::endRx(Packet *p)
 	}
 } /* UnderwaterPhysicaldb::endRx */
 
-double
-UnderwaterPhysicaldb::getPERfromSNR(
-		const double &_snr, const int &_nbits, const Packet *p)
+string
+UnderwaterPhysicaldb::getPathType(uint8_t _prev_hop) const
 {
-	hdr_cmn *ch = HDR_CMN(p);
-	hdr_MPhy *ph = HDR_MPHY(p);
-	//    hdr_uwip* iph = HDR_UWIP(p);
-
 	// Type of node.
 	std::map<uint8_t, string>::const_iterator it =
-			type_of_node.find(ch->prev_hop_);
+			type_of_node.find(_prev_hop);
 	assert(it != type_of_node.end());
 	const string type_prev_ = it->second;
 	it = type_of_node.find(ipAddr_);
@@ -361,6 +371,107 @@ UnderwaterPhysicaldb::getPERfromSNR(
 			type_ = "BB";
 		}
 	}
+	return type_;
+} /* UnderwaterPhysicaldb::getPathType */
+
+void
+UnderwaterPhysicaldb::loadPerTables()
+{
+	snr_axis_.assign(snr.begin(), snr.end());
+	sir_axis_.assign(sir.begin(), sir.end());
+	overlap_axis_.assign(overlap.begin(), overlap.end());
+	snr_tables_.clear();
+	sir_tables_.clear();
+
+	// SNR tables, one for each transmitter and range.
+	for (std::map<uint8_t, std::set<double> >::const_iterator it =
+					range.begin();
+			it != range.end();
+			it++) {
+		if (type_of_node.find(it->first) == type_of_node.end() ||
+				type_of_node.find(ipAddr_) == type_of_node.end())
+			continue;
+		const string type_ = getPathType(it->first);
+		NodePerTables &node_ = snr_tables_[it->first];
+		node_.range.assign(it->second.begin(), it->second.end());
+		node_.tables.resize(node_.range.size());
+		for (size_t i = 0; i < node_.range.size(); i++) {
+			osstream.clear();
+			osstream.str("");
+			osstream << path_ << country << "_" << modulation << "_" << type_
+					 << "_" << node_.range[i];
+			loadPerTable(osstream.str(), snr_axis_, node_.tables[i]);
+		}
+	}
+
+	// SIR tables, one for each overlap.
+	sir_tables_.resize(overlap_axis_.size());
+	for (size_t i = 0; i < overlap_axis_.size(); i++) {
+		osstream.clear();
+		osstream.str("");
+		osstream << path_ << "SIR"
+				 << "_" << modulation << "_" << overlap_axis_[i];
+		loadPerTable(osstream.str(), sir_axis_, sir_tables_[i]);
+	}
+
+	per_tables_loaded_ = true;
+} /* UnderwaterPhysicaldb::loadPerTables */
+
+void
+UnderwaterPhysicaldb::loadPerTable(const string &_file_name,
+		const std::vector<double> &_axis, PerTable &_table) const
+{
+	std::ifstream input_file_;
+	std::string line_;
+	std::string token_;
+	std::vector<bool> found_(_axis.size(), false);
+
+	_table.file_name = _file_name;
+	_table.per.assign(_axis.size(), -INT_MAX);
+	input_file_.open(_file_name.c_str());
+	_table.loaded = input_file_.is_open();
+	if (!_table.loaded)
+		return;
+
+	// Keep the first line of the file that matches each value of the axis.
+	while (std::getline(input_file_, line_)) {
+		std::istringstream iss_(line_);
+		getline(iss_, token_, token_separator);
+		std::stringstream ss_(token_);
+		double token_double_;
+		ss_ >> token_double_;
+		std::vector<double>::const_iterator it_ =
+				std::lower_bound(_axis.begin(), _axis.end(), token_double_);
+		if (it_ == _axis.end() || *it_ != token_double_)
+			continue;
+		size_t index_ = it_ - _axis.begin();
+		if (found_[index_])
+			continue;
+		getline(iss_, token_, token_separator);
+		std::stringstream ss2_(token_);
+		ss2_ >> token_double_;
+		_table.per[index_] = token_double_;
+		found_[index_] = true;
+	}
+} /* UnderwaterPhysicaldb::loadPerTable */
+
+double
+UnderwaterPhysicaldb::getPERfromSNR(
+		const double &_snr, const int &_nbits, const Packet *p)
+{
+	hdr_cmn *ch = HDR_CMN(p);
+	hdr_MPhy *ph = HDR_MPHY(p);
+
+	if (!per_tables_loaded_)
+		loadPerTables();
+
+	std::map<uint8_t, NodePerTables>::const_iterator it =
+			snr_tables_.find(ch->prev_hop_);
+	if (it == snr_tables_.end()) {
+		assert(type_of_node.find(ch->prev_hop_) != type_of_node.end());
+		assert(type_of_node.find(ipAddr_) != type_of_node.end());
+		return 1;
+	}
 
 	// Nearest neighbor range.
 	const double x_ = (ph->srcPosition)->getX();
@@ -372,109 +483,73 @@ UnderwaterPhysicaldb::getPERfromSNR(
 	const double distance_ = sqrt((x_ - x_dst_) * (x_ - x_dst_) +
 			(y_ - y_dst_) * (y_ - y_dst_) + (z_ - z_dst_) * (z_ - z_dst_));
 	const double distance_miles_ = this->fromKmToMiles(distance_ / 1000);
-
-	std::map<uint8_t, std::set<double> >::const_iterator it2 =
-			range.find(ch->prev_hop_);
-	double nn_range_;
-	if (it2 != range.end()) {
-		nn_range_ = this->getNearestNeighbor(it2->second, distance_miles_);
-	} else {
-		//        if (ch->direction() == 1) {
-		//            std::cout << "\33[31;40m" << "DIR: UP" << "\33[0m" <<
-		//            std::endl;
-		//        } else if (ch->direction() == -1) {
-		//            std::cout << "\33[31;40m" << "DIR: DOWN" << "\33[0m" <<
-		//            std::endl;
-		//        }
-		//        std::cout << "\33[32;40m" << "ME:" <<
-		//        static_cast<int>(ipAddr_);
-		//        std::cout << "\33[33;40m" << " NXT:" <<
-		//        static_cast<int>(ch->next_hop_);
-		//        std::cout << "\33[34;40m" << " PRV:" <<
-		//        static_cast<int>(ch->prev_hop_);
-		//        std::cout << "\33[35;40m" << " DST:" <<
-		//        static_cast<int>(iph->daddr());
-		//        std::cout << "\33[36;40m" << " SRC:" <<
-		//        static_cast<int>(iph->saddr());
-		//        std::cout << "\33[0m" << std::endl;
-		//        std::cout << "\33[31;40m" << "TPE:" << type_ << "\33[0m" <<
-		//        std::endl;
-		return 1;
-		//        std::cerr << "Empty range table" << std::endl;
-		//        exit(1);
+	const PerTable &table_ =
+			it->second.tables[getNearestIndex(it->second.range,
+					distance_miles_)];
+	if (!table_.loaded) {
+		cerr << "Impossible to open file " << table_.file_name << endl;
+		exit(1);
 	}
 
-	// File's name.
-	osstream.clear();
-	osstream.str("");
-	osstream << path_ << country << "_" << modulation << "_" << type_ << "_"
-			 << nn_range_;
-	const string file_name_ = osstream.str();
-
 	// Nearest neighbor snr.
-	const double nn_snr_ = this->getNearestNeighbor(snr, 10 * log10(_snr));
-
-	// Open the file and get the per that corresponds to the nn_snr_ value.
-	const double per_ = this->retrievePerFromFile(file_name_, nn_snr_);
-
-	return per_;
+	return table_.per[getNearestIndex(snr_axis_, 10 * log10(_snr))];
 } /* UnderwaterPhysicaldb::getPERfromSNR */
 
 double
 UnderwaterPhysicaldb::getPERfromSIR(const double &_sir, const double &_overlap)
 {
+	if (!per_tables_loaded_)
+		loadPerTables();
 
 	// Nearest neighbor Overlap.
-	const double nn_overlap_ = this->getNearestNeighbor(
-			overlap, _overlap * 100); // From [0; 1]  to [0; 100] scale.
-
-	// File's name.
-	osstream.clear();
-	osstream.str("");
-	osstream << path_ << "SIR"
-			 << "_" << modulation << "_" << nn_overlap_;
-	const string file_name_ = osstream.str();
+	const PerTable &table_ = sir_tables_[getNearestIndex(
+			overlap_axis_, _overlap * 100)]; // From [0; 1]  to [0; 100] scale.
+	if (!table_.loaded) {
+		cerr << "Impossible to open file " << table_.file_name << endl;
+		exit(1);
+	}
 
 	// Nearest neighbor SIR.
-	const double nn_sir_ = this->getNearestNeighbor(sir, _sir);
-
-	// Open the file and get the per that corresponds to the nn_snr_ value.
-	const double per_ = this->retrievePerFromFile(file_name_, nn_sir_);
+	return table_.per[getNearestIndex(sir_axis_, _sir)];
+} /* UnderwaterPhysicaldb::getPERfromSIR */
 
-	return per_;
-} /* UnderwaterPhysicaldb::getPERfromSNR */
+size_t
+UnderwaterPhysicaldb::getNearestIndex(
+		const std::vector<double> &_values, const double &_value)
+{
+	assert(!_values.empty());
+	std::vector<double>::const_iterator it_ =
+			std::lower_bound(_values.begin(), _values.end(), _value);
+	if (it_ == _values.begin()) {
+		return 0;
+	}
+	if (it_ == _values.end()) {
+		return _values.size() - 1;
+	}
+	std::vector<double>::const_iterator it_prev_ = it_ - 1;
+	if (std::fabs(_value - *it_prev_) <= std::fabs(_value - *it_)) {
+		return it_prev_ - _values.begin();
+	}
+	return it_ - _values.begin();
+} /* UnderwaterPhysicaldb::getNearestIndex */
 
 double
 UnderwaterPhysicaldb::getNearestNeighbor(
 		const std::set<double> &_set, const double &_value)
 {
-	// Check if the value to search for is smaller than the min or greater than
-	// the max.
-	std::set<double>::iterator it_ = _set.begin();
-	if (_value <= *it_) {
+	std::set<double>::const_iterator it_ = _set.lower_bound(_value);
+	if (it_ == _set.begin()) {
 		return *it_;
 	}
-	it_ = --_set.end();
-	if (_value >= *it_) {
-		return *it_;
-	} else {
-		for (std::set<double>::const_iterator it_ = _set.begin();
-				it_ != _set.end();
-				it_++) {
-			std::set<double>::const_iterator it_next_ = it_;
-			it_next_++;
-			if (_value >= *it_next_) {
-				continue;
-			} else {
-				if (abs(_value - *it_) <= abs(_value - *it_next_)) {
-					return *it_;
-				} else {
-					return *it_next_;
-				}
-			}
-		}
-		return 0;
+	if (it_ == _set.end()) {
+		return *(--it_);
+	}
+	std::set<double>::const_iterator it_prev_ = it_;
+	it_prev_--;
+	if (std::fabs(_value - *it_prev_) <= std::fabs(_value - *it_)) {
+		return *it_prev_;
 	}
+	return *it_;
 } /* UnderwaterPhysicaldb::findNearestNeightbor */
 
 const double
@@ -122,6 +122,31 @@ protected:
 	virtual const double retrievePerFromFile(
 			const std::string &, const double &) const;
 
+	/**
+	 * Loads every PER table reachable with the current configuration, so that
+	 * getPERfromSNR and getPERfromSIR do not access the file system.
+	 * It is called automatically before the first lookup and after any change
+	 * of the configuration.
+	 */
+	virtual void loadPerTables();
+
+	/**
+	 * Index of the nearest neighbor of a value in a sorted array.
+	 * @param Sorted array that contains the values in which to search.
+	 * @param value to search for.
+	 * @return Index of the nearest neighbor, the lower one in case of tie.
+	 */
+	static size_t getNearestIndex(
+			const std::vector<double> &, const double &);
+
+	/**
+	 * Pair of node types that identifies the table to use for the link
+	 * from the given node to this one.
+	 * @param prev_hop ID of the transmitter.
+	 * @return Type of the path, e.g. "AA".
+	 */
+	string getPathType(uint8_t) const;
+
 	/**
 	 * Evaluates is the number passed as input is equal to zero. When C++ works
 	 * with
@@ -175,7 +200,42 @@ protected:
 			token_separator; /**< Token used to parse the elements in a line of
 								the database. */
 
+	/**
+	 * PER values of a database file, aligned with the SNR or SIR axis.
+	 */
+	struct PerTable {
+		string file_name; /**< Name of the database file. */
+		bool loaded; /**< <i>true</i> if the file has been opened. */
+		std::vector<double> per; /**< PER for each value of the axis. */
+	};
+
+	/**
+	 * SNR tables of the link from a given node, one for each range.
+	 */
+	struct NodePerTables {
+		std::vector<double> range; /**< Sorted available ranges. */
+		std::vector<PerTable> tables; /**< Table for each range. */
+	};
+
+	bool per_tables_loaded_; /**< <i>true</i> if the tables are up to date
+								with the configuration. */
+	std::vector<double> snr_axis_; /**< Sorted available SNRs. */
+	std::vector<double> sir_axis_; /**< Sorted available SIRs. */
+	std::vector<double> overlap_axis_; /**< Sorted available Overlaps. */
+	std::map<uint8_t, NodePerTables>
+			snr_tables_; /**< SNR tables indexed by transmitter ID. */
+	std::vector<PerTable> sir_tables_; /**< SIR table for each Overlap. */
+
 private:
+	/**
+	 * Reads a database file into a table aligned with the given axis.
+	 * @param file_name Name of the database file.
+	 * @param axis Sorted values of the first column to retrieve.
+	 * @param table Table to fill.
+	 */
+	void loadPerTable(const string &, const std::vector<double> &,
+			PerTable &) const;
+
 	ostringstream osstream;
 };
 
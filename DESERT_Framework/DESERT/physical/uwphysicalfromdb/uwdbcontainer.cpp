@@ -0,0 +1,267 @@
+//
+// Copyright (c) 2017 Regents of the SIGNET lab, University of Padova.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. Neither the name of the University of Padova (SIGNET lab) nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file   uwdbcontainer.cpp
+ * @author Giovanni Toso
+ * @version 1.0.0
+ * \brief Implementation of UwDbContainer class.
+ */
+
+#include "uwdbcontainer.h"
+
+#include <uwgainmapcache.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+bool
+entryLess(const UwDbContainerEntry &a, const UwDbContainerEntry &b)
+{
+	if (a.type != b.type)
+		return a.type < b.type;
+	if (a.time != b.time)
+		return a.time < b.time;
+	if (a.source_depth != b.source_depth)
+		return a.source_depth < b.source_depth;
+	return a.tau_index < b.tau_index;
+}
+}
+
+UwDbContainer::UwDbContainer()
+	: base_(NULL)
+	, size_(0)
+	, header_(NULL)
+	, entries_(NULL)
+{
+}
+
+UwDbContainer::~UwDbContainer()
+{
+	close();
+}
+
+void
+UwDbContainer::scanDirectory(const std::string &path, int type,
+		std::vector<UwDbContainerEntry> &entries,
+		std::vector<std::string> &names)
+{
+	DIR *dir = opendir(path.c_str());
+	if (dir == NULL) {
+		std::cerr << "Impossible to open directory " << path << std::endl;
+		return;
+	}
+
+	struct dirent *de;
+	while ((de = readdir(dir)) != NULL) {
+		UwDbContainerEntry entry;
+		int consumed = 0;
+		memset(&entry, 0, sizeof(entry));
+		if (sscanf(de->d_name,
+					"%d_%d_%d%n",
+					&entry.time,
+					&entry.source_depth,
+					&entry.tau_index,
+					&consumed) != 3 ||
+				de->d_name[consumed] != '\0')
+			continue;
+		entry.type = type;
+		entries.push_back(entry);
+		names.push_back(path + "/" + de->d_name);
+	}
+	closedir(dir);
+} /* UwDbContainer::scanDirectory */
+
+bool
+UwDbContainer::compile(const std::string &file_name,
+		const std::string &path_gainmaps,
+		const std::string &path_selfinterference,
+		const UwDbContainerHeader &header, char separator)
+{
+	std::vector<UwDbContainerEntry> entries;
+	std::vector<std::string> names;
+
+	scanDirectory(path_gainmaps, GAIN, entries, names);
+	if (!path_selfinterference.empty())
+		scanDirectory(path_selfinterference, SELF_INTERF, entries, names);
+
+	// Sort the index and the names together.
+	std::vector<size_t> order(entries.size());
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), [&entries](size_t a, size_t b) {
+		return entryLess(entries[a], entries[b]);
+	});
+
+	std::ofstream out(file_name.c_str(), std::ios::binary | std::ios::trunc);
+	if (!out.is_open()) {
+		std::cerr << "Impossible to open file " << file_name << std::endl;
+		return false;
+	}
+
+	UwDbContainerHeader hdr = header;
+	memcpy(hdr.magic, uwdbcontainer::MAGIC, sizeof(hdr.magic));
+	hdr.version = uwdbcontainer::VERSION;
+	hdr.byte_order = uwdbcontainer::ENDIAN_MARK;
+	hdr.n_entries = entries.size();
+	hdr.reserved = 0;
+
+	// Maps are parsed twice to keep only one of them in memory: the first
+	// pass sizes the index, the second one writes the values.
+	uint64_t offset = sizeof(hdr) + entries.size() * sizeof(entries[0]);
+	std::vector<UwDbContainerEntry> index(entries.size());
+	for (size_t i = 0; i < order.size(); i++) {
+		UwGainMap map;
+		map.load(names[order[i]], separator);
+		index[i] = entries[order[i]];
+		index[i].rows = map.rows();
+		index[i].columns = map.columns();
+		index[i].offset = offset;
+		offset += (uint64_t) map.rows() * map.columns() * sizeof(float);
+	}
+
+	out.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+	if (!index.empty())
+		out.write(reinterpret_cast<const char *>(&index[0]),
+				index.size() * sizeof(index[0]));
+	for (size_t i = 0; i < order.size(); i++) {
+		UwGainMap map;
+		map.load(names[order[i]], separator);
+		for (int r = 1; r <= map.rows(); r++) {
+			for (int c = 1; c <= map.columns(); c++) {
+				float value = map.at(r, c);
+				out.write(reinterpret_cast<const char *>(&value),
+						sizeof(value));
+			}
+		}
+	}
+
+	return out.good();
+} /* UwDbContainer::compile */
+
+bool
+UwDbContainer::open(const std::string &file_name)
+{
+	close();
+
+	int fd = ::open(file_name.c_str(), O_RDONLY);
+	if (fd < 0) {
+		std::cerr << "Impossible to open file " << file_name << std::endl;
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) < 0 ||
+			(size_t) st.st_size < sizeof(UwDbContainerHeader)) {
+		std::cerr << "Invalid container " << file_name << std::endl;
+		::close(fd);
+		return false;
+	}
+
+	void *base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (base == MAP_FAILED) {
+		std::cerr << "Impossible to map file " << file_name << std::endl;
+		return false;
+	}
+
+	const UwDbContainerHeader *hdr =
+			static_cast<const UwDbContainerHeader *>(base);
+	if (memcmp(hdr->magic, uwdbcontainer::MAGIC, sizeof(hdr->magic)) != 0 ||
+			hdr->version != uwdbcontainer::VERSION ||
+			hdr->byte_order != uwdbcontainer::ENDIAN_MARK ||
+			sizeof(*hdr) + (size_t) hdr->n_entries *
+							sizeof(UwDbContainerEntry) >
+					(size_t) st.st_size) {
+		std::cerr << "Invalid container " << file_name << std::endl;
+		munmap(base, st.st_size);
+		return false;
+	}
+
+	const UwDbContainerEntry *entries =
+			reinterpret_cast<const UwDbContainerEntry *>(hdr + 1);
+	for (uint32_t i = 0; i < hdr->n_entries; i++) {
+		if (entries[i].offset +
+						(uint64_t) entries[i].rows * entries[i].columns *
+								sizeof(float) >
+				(uint64_t) st.st_size) {
+			std::cerr << "Invalid container " << file_name << std::endl;
+			munmap(base, st.st_size);
+			return false;
+		}
+	}
+
+	base_ = base;
+	size_ = st.st_size;
+	header_ = hdr;
+	entries_ = entries;
+	return true;
+} /* UwDbContainer::open */
+
+void
+UwDbContainer::close()
+{
+	if (base_ != NULL)
+		munmap(base_, size_);
+	base_ = NULL;
+	size_ = 0;
+	header_ = NULL;
+	entries_ = NULL;
+} /* UwDbContainer::close */
+
+const UwDbContainerEntry *
+UwDbContainer::find(int type, int time, int source_depth, int tau_index) const
+{
+	if (header_ == NULL)
+		return NULL;
+
+	UwDbContainerEntry key;
+	memset(&key, 0, sizeof(key));
+	key.type = type;
+	key.time = time;
+	key.source_depth = source_depth;
+	key.tau_index = tau_index;
+
+	const UwDbContainerEntry *end = entries_ + header_->n_entries;
+	const UwDbContainerEntry *it =
+			std::lower_bound(entries_, end, key, entryLess);
+	if (it == end || entryLess(key, *it))
+		return NULL;
+	return it;
+} /* UwDbContainer::find */
@@ -0,0 +1,203 @@
+//
+// Copyright (c) 2017 Regents of the SIGNET lab, University of Padova.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. Neither the name of the University of Padova (SIGNET lab) nor the
+//    names of its contributors may be used to endorse or promote products
+//    derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file   uwdbcontainer.h
+ * @author Giovanni Toso
+ * @version 1.0.0
+ * \brief Definition of UwDbContainer class.
+ */
+
+#ifndef UWDBCONTAINER_H
+#define UWDBCONTAINER_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace uwdbcontainer
+{
+static const char MAGIC[8] = {'U', 'W', 'D', 'B', 'M', 'A', 'P', '\0'};
+static const uint32_t VERSION = 1;
+static const uint32_t ENDIAN_MARK = 0x01020304;
+}
+
+/**
+ * Header of the binary container.
+ */
+struct UwDbContainerHeader {
+	char magic[8]; /**< uwdbcontainer::MAGIC. */
+	uint32_t version; /**< Version of the format. */
+	uint32_t byte_order; /**< uwdbcontainer::ENDIAN_MARK in host order. */
+	int32_t time_roughness; /**< Roughness of the temporal samples. */
+	int32_t depth_roughness; /**< Roughness of the depth samples. */
+	int32_t distance_roughness; /**< Roughness of the distance samples. */
+	int32_t total_time; /**< Maximum value of the temporal samples. */
+	uint32_t n_entries; /**< Number of entries of the index. */
+	uint32_t reserved; /**< Padding, set to 0. */
+};
+
+/**
+ * Entry of the index of the binary container. Entries are sorted by
+ * (type, time, source_depth, tau_index).
+ */
+struct UwDbContainerEntry {
+	int32_t type; /**< UwDbContainer::GAIN or UwDbContainer::SELF_INTERF. */
+	int32_t time; /**< Time of the original file. */
+	int32_t source_depth; /**< Source depth of the original file. */
+	int32_t tau_index; /**< Tau index of the original file. */
+	uint32_t rows; /**< Number of rows of the map. */
+	uint32_t columns; /**< Number of columns of the map. */
+	uint64_t offset; /**< Offset of the float values from the file start. */
+};
+
+/**
+ * Single binary file that holds every gain and self interference map of a
+ * database. The file is memory mapped read-only, so it is shared among
+ * all the modules and simulation processes that use it.
+ */
+class UwDbContainer
+{
+public:
+	enum MapType { GAIN = 0, SELF_INTERF = 1 };
+
+	/**
+	 * Constructor of UwDbContainer class.
+	 */
+	UwDbContainer();
+
+	/**
+	 * Destructor of UwDbContainer class.
+	 */
+	~UwDbContainer();
+
+	/**
+	 * Converts the text databases into a binary container. The file names
+	 * of the databases must be in the form <time>_<depth>_<tau index>.
+	 *
+	 * @param file_name Name of the container to write.
+	 * @param path_gainmaps Directory of the gain maps.
+	 * @param path_selfinterference Directory of the self interference maps,
+	 * may be empty.
+	 * @param header Header to write, only the roughness fields are used.
+	 * @param separator Token used to split the elements of a line.
+	 * @return <i>true</i> if the container has been written.
+	 */
+	static bool compile(const std::string &file_name,
+			const std::string &path_gainmaps,
+			const std::string &path_selfinterference,
+			const UwDbContainerHeader &header, char separator);
+
+	/**
+	 * Memory maps a binary container.
+	 *
+	 * @param file_name Name of the container.
+	 * @return <i>true</i> if the container is valid and has been mapped.
+	 */
+	bool open(const std::string &file_name);
+
+	/**
+	 * Unmaps the container.
+	 */
+	void close();
+
+	/**
+	 * Returns <i>true</i> if a container is mapped.
+	 *
+	 * @return <i>true</i> if a container is mapped.
+	 */
+	inline bool
+	isOpen() const
+	{
+		return header_ != NULL;
+	}
+
+	/**
+	 * Returns the header of the mapped container.
+	 *
+	 * @return Pointer to the header, NULL if no container is mapped.
+	 */
+	inline const UwDbContainerHeader *
+	getHeader() const
+	{
+		return header_;
+	}
+
+	/**
+	 * Finds the entry related to an original file.
+	 *
+	 * @param type GAIN or SELF_INTERF.
+	 * @param time Time of the original file.
+	 * @param source_depth Source depth of the original file.
+	 * @param tau_index Tau index of the original file.
+	 * @return Pointer to the entry, NULL if it is not in the container.
+	 */
+	const UwDbContainerEntry *find(
+			int type, int time, int source_depth, int tau_index) const;
+
+	/**
+	 * Returns a value of a map.
+	 *
+	 * @param entry Entry of the map.
+	 * @param row 1-based row index.
+	 * @param column 1-based column index.
+	 * @return Value of the cell, 0 if the cell is outside the map.
+	 */
+	inline float
+	at(const UwDbContainerEntry *entry, int row, int column) const
+	{
+		if (row < 1 || row > (int) entry->rows || column < 1 ||
+				column > (int) entry->columns)
+			return 0;
+		const float *values = reinterpret_cast<const float *>(
+				static_cast<const char *>(base_) + entry->offset);
+		return values[(size_t) (row - 1) * entry->columns + (column - 1)];
+	}
+
+private:
+	/**
+	 * Lists the files of a directory whose name is in the form
+	 * <time>_<depth>_<tau index>.
+	 *
+	 * @param path Directory to scan.
+	 * @param type Type of the maps stored in the directory.
+	 * @param entries Vector where the entries are appended.
+	 * @param names Vector where the file names are appended.
+	 */
+	static void scanDirectory(const std::string &path, int type,
+			std::vector<UwDbContainerEntry> &entries,
+			std::vector<std::string> &names);
+
+	void *base_; /**< Start of the mapped file. */
+	size_t size_; /**< Size of the mapped file. */
+	const UwDbContainerHeader *header_; /**< Header of the mapped file. */
+	const UwDbContainerEntry *entries_; /**< Index of the mapped file. */
+};
+
+#endif /* UWDBCONTAINER_H */
@@ -54,6 +54,7 @@ public:
 
 UnderwaterPhysicalfromdb::UnderwaterPhysicalfromdb()
 	: tau_index(1)
+	, db_container()
 {
 	bind("tau_index_", &tau_index);
 	path_gainmaps = "";
@@ -85,6 +86,10 @@ UnderwaterPhysicalfromdb::command(int argc, const char *const *argv)
 				return TCL_ERROR;
 			}
 			return TCL_OK;
+		} else if (strcasecmp(argv[1], "compileDb") == 0) {
+			return compileDb(argv[2]) ? TCL_OK : TCL_ERROR;
+		} else if (strcasecmp(argv[1], "loadCompiledDb") == 0) {
+			return loadCompiledDb(argv[2]) ? TCL_OK : TCL_ERROR;
 		}
 	}
 	return UnderwaterGainFromDb::command(argc, argv);
@@ -165,6 +170,14 @@ UnderwaterPhysicalfromdb::getGain(const double &_time,
 		source_depth_filename_ = getDepthRoughness();
 	}
 
+	if (db_container.isOpen()) {
+		return retrieveFromContainer(UwDbContainer::GAIN,
+				time_filename_,
+				source_depth_filename_,
+				column_index_,
+				line_index_);
+	}
+
 	string file_name_ = createNameFile(path_gainmaps,
 			time_filename_,
 			source_depth_filename_,
@@ -205,6 +218,14 @@ UnderwaterPhysicalfromdb::getSelfInterference(const double &_time,
 		source_depth_filename_ = getDepthRoughness();
 	}
 
+	if (db_container.isOpen()) {
+		return retrieveFromContainer(UwDbContainer::SELF_INTERF,
+				time_filename_,
+				source_depth_filename_,
+				column_index_,
+				line_index_);
+	}
+
 	string file_name_ = createNameFile(path_selfinterference,
 			time_filename_,
 			source_depth_filename_,
@@ -217,6 +238,17 @@ double
 UnderwaterPhysicalfromdb::retrieveFromFile(const string &_file_name,
 		const int &_row_index, const int &_column_index) const
 {
+	if (use_gain_cache_) {
+		gain_cache_.setMaxBytes((size_t) (gain_cache_size_ * 1024 * 1024));
+		double value_ = gain_cache_.get(_file_name, token_separator_)
+								.at(_row_index, _column_index);
+		if (this->isZero(value_)) {
+			return (-INT_MAX);
+		} else {
+			return value_;
+		}
+	}
+
 	int row_iterator_ = 0;
 	int column_iterator_ = 0;
 	ifstream input_file_;
@@ -266,6 +298,65 @@ UnderwaterPhysicalfromdb::retrieveFromFile(const string &_file_name,
 	}
 } /* UnderwaterPhysicalfromdb::retriveFromFile */
 
+double
+UnderwaterPhysicalfromdb::retrieveFromContainer(const int &_type,
+		const int &_time, const int &_source_depth, const int &_row_index,
+		const int &_column_index) const
+{
+	const UwDbContainerEntry *entry_ = db_container.find(
+			_type, _time, _source_depth, getTauIndex());
+	if (entry_ == NULL) {
+		std::cerr << "Impossible to find map " << _time << "_"
+				  << _source_depth << "_" << getTauIndex()
+				  << " in the container" << std::endl;
+		return (-INT_MAX);
+	}
+
+	double return_value_ = db_container.at(entry_, _row_index, _column_index);
+	if (this->isZero(return_value_)) {
+		return (-INT_MAX);
+	} else {
+		return return_value_;
+	}
+} /* UnderwaterPhysicalfromdb::retrieveFromContainer */
+
+bool
+UnderwaterPhysicalfromdb::compileDb(const string &_file_name) const
+{
+	UwDbContainerHeader header_;
+	memset(&header_, 0, sizeof(header_));
+	header_.time_roughness = getTimeRoughness();
+	header_.depth_roughness = getDepthRoughness();
+	header_.distance_roughness = getDistanceRoughness();
+	header_.total_time = getTotalTime();
+
+	return UwDbContainer::compile(_file_name,
+			path_gainmaps,
+			path_selfinterference,
+			header_,
+			token_separator_);
+} /* UnderwaterPhysicalfromdb::compileDb */
+
+bool
+UnderwaterPhysicalfromdb::loadCompiledDb(const string &_file_name)
+{
+	if (!db_container.open(_file_name)) {
+		return false;
+	}
+
+	const UwDbContainerHeader *header_ = db_container.getHeader();
+	if (header_->time_roughness != getTimeRoughness() ||
+			header_->depth_roughness != getDepthRoughness() ||
+			header_->distance_roughness != getDistanceRoughness() ||
+			header_->total_time != getTotalTime()) {
+		std::cerr << "The roughness of the container " << _file_name
+				  << " does not match the one of the module" << std::endl;
+		db_container.close();
+		return false;
+	}
+	return true;
+} /* UnderwaterPhysicalfromdb::loadCompiledDb */
+
 string
 UnderwaterPhysicalfromdb::createNameFile(const char *_path, const int &_time,
 		const int &_source_depth, const int &_tau_index)
@@ -39,6 +39,8 @@
 #ifndef UWPHYSICALFROMDB_H
 #define UWPHYSICALFROMDB_H
 
+#include "uwdbcontainer.h"
+
 #include <uwgainfromdb.h>
 
 class UnderwaterPhysicalfromdb : public UnderwaterGainFromDb
@@ -132,6 +134,35 @@ protected:
 	virtual double retrieveFromFile(const string &_file_name,
 			const int &_row_index, const int &_column_index) const;
 
+	/**
+	 * Read from the binary container the value in a specific row - column.
+	 * @param _type UwDbContainer::GAIN or UwDbContainer::SELF_INTERF
+	 * @param _time Time of the map
+	 * @param _source_depth Source depth of the map
+	 * @param _row_index index of the row
+	 * @param _column_index index of the column
+	 * @return the value read
+	 */
+	virtual double retrieveFromContainer(const int &_type, const int &_time,
+			const int &_source_depth, const int &_row_index,
+			const int &_column_index) const;
+
+	/**
+	 * Converts the text databases in path_gainmaps and path_selfinterference
+	 * into a binary container.
+	 * @param _file_name Name of the container to write
+	 * @return <i>true</i> if the container has been written
+	 */
+	virtual bool compileDb(const string &_file_name) const;
+
+	/**
+	 * Memory maps a binary container and uses it instead of the text
+	 * databases.
+	 * @param _file_name Name of the container
+	 * @return <i>true</i> if the container has been loaded
+	 */
+	virtual bool loadCompiledDb(const string &_file_name);
+
 	/**
 	 * Set the line_index parameter.
 	 *
@@ -160,6 +191,7 @@ private:
 	char *path_selfinterference; /**< Name of the trace file writter for the
 									current node. */
 	int tau_index; /**< Tau index to load in the file. */
+	UwDbContainer db_container; /**< Binary container of the databases. */
 };
 
 #endif /* UWPHYSICALFROMDB_H  */
@@ -0,0 +1,87 @@
+#
+# Copyright (c) 2017 Regents of the SIGNET lab, University of Padova.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+# 3. Neither the name of the University of Padova (SIGNET lab) nor the 
+#    names of its contributors may be used to endorse or promote products 
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED 
+# TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR 
+# PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR 
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+# OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+# WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+# OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Version: 1.0.0
+#########################################################################################
+##
+## NOTE: This script does not simulate any network: it checks the integrals of the
+## interference timeline of Module/UW/INTERFERENCE, used for the average interference
+## power and the overlap of each reception, through its "checkIntegrals" command.
+## Random timelines are integrated over random windows, some of them starting before
+## the first sample, while the oldest samples are purged as with maxinterval_, and the
+## results are compared with a sample by sample integration.
+##
+#########################################################################################
+
+#####################
+# Library Loading   #
+#####################
+load libMiracle.so
+load libmphy.so
+load libuwinterference.so
+
+#############################
+# NS-Miracle initialization #
+#############################
+set ns [new Simulator]
+$ns use-Miracle
+
+##################
+# Tcl variables  #
+##################
+set opt(n_checks) 100000
+set opt(seeds)    [list 1 2 3 4 5]
+set opt(times)    [list 0 10 1000]
+
+#####################
+# Integrals check   #
+#####################
+# The check runs at several simulation times, the end of the windows being NOW
+proc checkIntegrals { seed } {
+    global opt
+    set interf_ [new Module/UW/INTERFERENCE]
+    if {[catch {$interf_ checkIntegrals $opt(n_checks) $seed}]} {
+        puts "checkIntegrals FAILED at time [[Simulator instance] now] with seed $seed"
+        exit 1
+    }
+}
+
+foreach time $opt(times) {
+    foreach seed $opt(seeds) {
+        $ns at $time "checkIntegrals $seed"
+    }
+}
+
+proc finish { } {
+    global opt
+    puts "checkIntegrals passed on $opt(n_checks) random windows for each seed and time"
+    exit 0
+}
+
+$ns at [expr [lindex $opt(times) end] + 1] "finish"
+$ns run
@@ -0,0 +1,198 @@
+#
+# Copyright (c) 2017 Regents of the SIGNET lab, University of Padova.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+# 3. Neither the name of the University of Padova (SIGNET lab) nor the 
+#    names of its contributors may be used to endorse or promote products 
+#    derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED 
+# TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR 
+# PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR 
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+# OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+# WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+# OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Version: 1.0.0
+#
+#########################################################################################
+##
+## NOTE: This script does not simulate any network: it measures the time spent by
+## Module/UW/AL to serialize, fragment, unpack and reassemble packets, with several
+## combinations of packers and PSDU sizes, through the "benchmark" command of UW/AL.
+## Before the runs, the bit-field engine of the packers is checked against a bit by
+## bit copy with the "checkBitEngine" command of UW/AL/Packer.
+## The addon UW/CBR/Packer is needed.
+##
+#########################################################################################
+# ----------------------------------------------------------------------------------
+# For each combination of payload packers and each PSDU size, opt(n_pkts) packets of
+# type opt(ptype) are packed with packHdr and packPayload, fragmented in PSDU sized
+# frames, copied into new packets as done by the modem drivers, unpacked and
+# reassembled. The output reports, for each run:
+#    - the time per packet [ns]
+#    - the throughput [bytes/s] of the serialized packets
+#    - the uw-al buffers allocated per packet (UwalBuffer and UwalData only: the
+#      allocations of the containers, of the strings and of the packets are not
+#      counted)
+# ----------------------------------------------------------------------------------
+
+######################################
+# Flags to enable or disable options #
+######################################
+set opt(bash_parameters) 0
+
+#####################
+# Library Loading   #
+#####################
+load libMiracle.so
+load libmphy.so
+load libmmac.so
+load libuwip.so
+load libuwudp.so
+load libuwcbr.so
+load libuwal.so
+load libpackercommon.so
+load libpackermac.so
+load libpackeruwip.so
+load libpackeruwudp.so
+load libpackeruwcbr.so
+
+#############################
+# NS-Miracle initialization #
+#############################
+set ns [new Simulator]
+$ns use-Miracle
+
+##################
+# Tcl variables  #
+##################
+set opt(n_pkts)   100000
+set opt(ptype)    "UWCBR"
+set opt(psdu)     [list 16 32 64 128 1400]
+set opt(n_checks) 100000
+set opt(seed)     1
+
+if {$opt(bash_parameters)} {
+    if {$argc != 2} {
+        puts "The script requires two inputs:"
+        puts "- the first for the number of packets of each run"
+        puts "- the second for the packet type"
+        puts "example: ns test_uwal_benchmark.tcl 10000 UWCBR"
+        puts "Please try again."
+        return
+    } else {
+        set opt(n_pkts) [lindex $argv 0]
+        set opt(ptype)  [lindex $argv 1]
+    }
+}
+
+#########################
+# Module Configuration  #
+#########################
+Module/UW/AL set PSDU 1400
+Module/UW/AL set debug_ 0
+Module/UW/AL set interframe_period 0
+Module/UW/AL set frame_set_validity 0
+
+UW/AL/Packer set SRC_ID_Bits 8
+UW/AL/Packer set PKT_ID_Bits 8
+UW/AL/Packer set FRAME_OFFSET_Bits 15
+UW/AL/Packer set M_BIT_Bits 1
+UW/AL/Packer set DUMMY_CONTENT_Bits 0
+UW/AL/Packer set debug_ 0
+
+NS2/COMMON/Packer set PTYPE_Bits 8
+NS2/COMMON/Packer set SIZE_Bits 8
+NS2/COMMON/Packer set UID_Bits 8
+NS2/COMMON/Packer set ERROR_Bits 0
+NS2/COMMON/Packer set TIMESTAMP_Bits 8
+NS2/COMMON/Packer set PREV_HOP_Bits 8
+NS2/COMMON/Packer set NEXT_HOP_Bits 8
+NS2/COMMON/Packer set ADRR_TYPE_Bits 0
+NS2/COMMON/Packer set LAST_HOP_Bits 0
+NS2/COMMON/Packer set TXTIME_Bits 0
+NS2/COMMON/Packer set debug_ 0
+
+NS2/MAC/Packer set Ftype_Bits 0
+NS2/MAC/Packer set SRC_Bits 8
+NS2/MAC/Packer set DST_Bits 8
+NS2/MAC/Packer set Htype_Bits 0
+NS2/MAC/Packer set TXtime_Bits 0
+NS2/MAC/Packer set SStime_Bits 0
+NS2/MAC/Packer set Padding_Bits 0
+NS2/MAC/Packer set debug_ 0
+
+UW/IP/Packer set SAddr_Bits 8
+UW/IP/Packer set DAddr_Bits 8
+UW/IP/Packer set debug_ 0
+
+UW/UDP/Packer set SPort_Bits 8
+UW/UDP/Packer set DPort_Bits 8
+UW/UDP/Packer set debug_ 0
+
+UW/CBR/Packer set SN_Bits 16
+UW/CBR/Packer set RFTT_Bits 32
+UW/CBR/Packer set RFTT_VALID_Bits 1
+UW/CBR/Packer set TRAFFIC_TYPE_Bits 8
+UW/CBR/Packer set debug_ 0
+
+###############################
+# Procedure for the packers   #
+###############################
+# Returns a UW/AL/Packer with the given payload packers
+proc createPacker { payload_packers } {
+    set packer_ [new UW/AL/Packer]
+    foreach name $payload_packers {
+        $packer_ addPacker [new $name]
+    }
+    return $packer_
+}
+
+set combinations [list \
+    [list NS2/COMMON/Packer] \
+    [list NS2/COMMON/Packer NS2/MAC/Packer] \
+    [list NS2/COMMON/Packer NS2/MAC/Packer UW/IP/Packer UW/UDP/Packer] \
+    [list NS2/COMMON/Packer NS2/MAC/Packer UW/IP/Packer UW/UDP/Packer UW/CBR/Packer] \
+]
+
+##########################
+# Bit-field engine check #
+##########################
+if {[catch {[new UW/AL/Packer] checkBitEngine $opt(n_checks) $opt(seed)}]} {
+    puts "checkBitEngine FAILED"
+    exit 1
+}
+puts "checkBitEngine passed on $opt(n_checks) random fields"
+
+###################
+# Benchmark runs  #
+###################
+set uwal_ [new Module/UW/AL]
+
+puts [format "%-70s %6s %12s %16s %12s" "packers" "PSDU" "ns/pkt" "bytes/s" "bufs/pkt"]
+foreach combination $combinations {
+    $uwal_ linkPacker [createPacker $combination]
+    foreach psdu $opt(psdu) {
+        $uwal_ set PSDU $psdu
+        if {[catch {$uwal_ benchmark $opt(n_pkts) $opt(ptype)} result]} {
+            puts [format "%-70s %6d %s" $combination $psdu "header does not fit"]
+            continue
+        }
+        puts [format "%-70s %6d %12.1f %16.0f %12.2f" $combination $psdu \
+            [lindex $result 0] [lindex $result 1] [lindex $result 2]]
+    }
+}